@@ -0,0 +1,152 @@
+// Vrios mundos rodando juntos pra treinar agentes (ver ambientes.h)
+#include "ambientes.h"
+#include <stdlib.h>
+#include <chrono>
+
+static int NumTarefas(const Ambientes *a) {
+    return (a->numAmbientes + AMBIENTES_POR_TAREFA - 1) / AMBIENTES_POR_TAREFA;
+}
+
+static void Observar(const Ambientes *a, int i, float *observacoes) {
+    const Mundo *m = &a->mundos[i];
+    float *o = &observacoes[(size_t)i * TAMANHO_OBSERVACAO];
+    float largura = m->larguraFase, altura = m->alturaFase;
+
+    for (int k = 0; k < 2; k++) {
+        const Jogador *j = &m->jogadores[k];
+        float *oj = o + k * (OBS_AGUA_X - OBS_FOGO_X);
+        oj[OBS_FOGO_X] = j->posicao.x / largura;
+        oj[OBS_FOGO_Y] = j->posicao.y / altura;
+        oj[OBS_FOGO_VX] = j->velocidade.x;
+        oj[OBS_FOGO_VY] = j->velocidade.y;
+        oj[OBS_FOGO_PODE_PULAR] = j->podePular ? 1.0f : 0.0f;
+    }
+
+    bool temDiamante = m->temDiamanteAtual && !m->diamanteColetado;
+    o[OBS_DIAMANTE] = temDiamante ? 1.0f : 0.0f;
+    o[OBS_DIAMANTE_X] = temDiamante ? (m->diamante.x + m->diamante.width / 2) / largura : 0.0f;
+    o[OBS_DIAMANTE_Y] = temDiamante ? (m->diamante.y + m->diamante.height / 2) / altura : 0.0f;
+
+    // Porta 0  a do Fogo e porta 1 a da gua (como na vitria do PassoMundo)
+    for (int k = 0; k < 2; k++) {
+        float *op = o + OBS_PORTA_FOGO_X + 2 * k;
+        if (k < m->numPortasAtuais) {
+            Rectangle r = m->portasAtuais[k].retangulo;
+            op[0] = (r.x + r.width / 2) / largura;
+            op[1] = (r.y + r.height / 2) / altura;
+        } else {
+            op[0] = op[1] = 0.0f;
+        }
+    }
+    o[OBS_TEMPO] = (a->limitePassos > 0) ? (float)m->passosFase / (float)a->limitePassos : 0.0f;
+}
+
+static void AndarAmbiente(Ambientes *a, int i, ContagemTarefa *contagem) {
+    Mundo *m = &a->mundos[i];
+    uint8_t f = a->acoes[2 * i], g = a->acoes[2 * i + 1];
+    Entradas e;
+    e.fogo = (EntradaJogador){ (f & ACAO_ESQUERDA) != 0, (f & ACAO_DIREITA) != 0, (f & ACAO_PULAR) != 0 };
+    e.agua = (EntradaJogador){ (g & ACAO_ESQUERDA) != 0, (g & ACAO_DIREITA) != 0, (g & ACAO_PULAR) != 0 };
+
+    int resultado = PassoMundo(m, e);
+    float recompensa = 0.0f;
+    if (resultado & PASSO_DIAMANTE) recompensa += RECOMPENSA_DIAMANTE;
+    if (resultado & PASSO_VITORIA) recompensa += RECOMPENSA_VITORIA;
+    if (resultado & (PASSO_MORTE | PASSO_REINICIOU)) recompensa += RECOMPENSA_MORTE;
+
+    FimEpisodio fim = EPISODIO_CONTINUA;
+    if (resultado & (PASSO_MORTE | PASSO_VITORIA | PASSO_REINICIOU)) fim = EPISODIO_TERMINOU;
+    else if (a->limitePassos > 0 && m->passosFase >= a->limitePassos) fim = EPISODIO_CORTADO;
+
+    if (fim != EPISODIO_CONTINUA) {
+        // O mundo ainda est como o episdio acabou (a queda no recomea no passo: reiniciarNaQueda  false)
+        Observar(a, i, a->observacoesFinais);
+        ReiniciarFase(m);
+        contagem->episodios++;
+        if (resultado & PASSO_VITORIA) contagem->vitorias++;
+    }
+
+    a->recompensas[i] = recompensa;
+    a->terminou[i] = (uint8_t)fim;
+    Observar(a, i, a->observacoes);
+}
+
+static void RodarTarefa(void *contexto, int tarefa, int trabalhador) {
+    (void)trabalhador;
+    Ambientes *a = (Ambientes *)contexto;
+    ContagemTarefa *contagem = &a->contagens[tarefa];
+    contagem->episodios = 0;
+    contagem->vitorias = 0;
+    int inicio = tarefa * AMBIENTES_POR_TAREFA;
+    int fim = inicio + AMBIENTES_POR_TAREFA;
+    if (fim > a->numAmbientes) fim = a->numAmbientes;
+    for (int i = inicio; i < fim; i++) AndarAmbiente(a, i, contagem);
+}
+
+void CriarAmbientes(Ambientes *a, const DadosFase *fases, int numFases, int numAmbientes, int numTrabalhadores,
+                    long long limitePassos) {
+    if (numAmbientes < 1) numAmbientes = 1;
+    a->numAmbientes = numAmbientes;
+    a->limitePassos = limitePassos;
+    a->mundos = (Mundo *)malloc(sizeof(Mundo) * (size_t)numAmbientes);
+    for (int i = 0; i < numAmbientes; i++) {
+        IniciarMundo(&a->mundos[i], fases, numFases, i % numFases);
+        a->mundos[i].reiniciarNaQueda = false;
+    }
+
+    a->observacoes = (float *)malloc(sizeof(float) * TAMANHO_OBSERVACAO * (size_t)numAmbientes);
+    a->observacoesFinais = (float *)calloc(TAMANHO_OBSERVACAO * (size_t)numAmbientes, sizeof(float));
+    a->recompensas = (float *)calloc((size_t)numAmbientes, sizeof(float));
+    a->terminou = (uint8_t *)calloc((size_t)numAmbientes, sizeof(uint8_t));
+    a->pool = CriarPool(numTrabalhadores);
+    a->acoes = NULL;
+    a->passosTotais = 0;
+    a->episodios = 0;
+    a->vitorias = 0;
+    a->segundos = 0.0;
+
+    a->contagens = (ContagemTarefa *)calloc((size_t)NumTarefas(a), sizeof(ContagemTarefa));
+    for (int i = 0; i < numAmbientes; i++) Observar(a, i, a->observacoes);
+}
+
+void LiberarAmbientes(Ambientes *a) {
+    for (int i = 0; i < a->numAmbientes; i++) LiberarMundo(&a->mundos[i]);
+    free(a->mundos);
+    free(a->observacoes);
+    free(a->observacoesFinais);
+    free(a->recompensas);
+    free(a->terminou);
+    free(a->contagens);
+    DestruirPool(a->pool);
+    a->mundos = NULL;
+    a->observacoes = NULL;
+    a->observacoesFinais = NULL;
+    a->recompensas = NULL;
+    a->terminou = NULL;
+    a->contagens = NULL;
+    a->pool = NULL;
+    a->numAmbientes = 0;
+}
+
+void ReiniciarAmbientes(Ambientes *a) {
+    for (int i = 0; i < a->numAmbientes; i++) {
+        ReiniciarFase(&a->mundos[i]);
+        a->recompensas[i] = 0.0f;
+        a->terminou[i] = EPISODIO_CONTINUA;
+        Observar(a, i, a->observacoes);
+    }
+}
+
+void PassoAmbientes(Ambientes *a, const uint8_t acoes[]) {
+    auto inicio = std::chrono::steady_clock::now();
+    a->acoes = acoes;
+    int numTarefas = NumTarefas(a);
+    ExecutarTarefas(a->pool, numTarefas, RodarTarefa, a);
+    a->acoes = NULL;
+    for (int t = 0; t < numTarefas; t++) {
+        a->episodios += a->contagens[t].episodios;
+        a->vitorias += a->contagens[t].vitorias;
+    }
+    a->passosTotais += a->numAmbientes;
+    a->segundos += std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+}
@@ -0,0 +1,92 @@
+/*
+Vrios mundos rodando juntos, pra treinar agentes: cada ambiente  um Mundo independente (fase i % numFases)
+e PassoAmbientes anda todos um passo ao mesmo tempo, divididos em blocos entre os ncleos (pool_tarefas.h).
+A ao de cada jogador  um byte com os bits ACAO_*; as observaes, recompensas e fins de episdio vo em
+vetores reservados uma vez s, que o chamador l depois de cada passo.
+
+Quando um episdio termina (morte, queda, vitria ou limite de passos) o ambiente recomea a fase na hora
+(ReiniciarFase, que custa menos que carregar) e a observao devolvida j  a do comeo do episdio novo;
+o fim fica marcado em terminou e a observao de como o episdio acabou vai em observacoesFinais. O resultado de cada ambiente no depende de quantos ncleos rodaram.
+*/
+#ifndef AMBIENTES_H
+#define AMBIENTES_H
+
+#include <stdint.h>
+#include "simulacao.h"
+#include "pool_tarefas.h"
+
+// Bits da ao de um jogador
+#define ACAO_ESQUERDA 1
+#define ACAO_DIREITA  2
+#define ACAO_PULAR    4
+
+// Recompensas de cada evento do passo (somadas quando acontecem juntos)
+#define RECOMPENSA_DIAMANTE  1.0f
+#define RECOMPENSA_VITORIA  10.0f
+#define RECOMPENSA_MORTE    -1.0f // Morte em perigo ou queda
+
+#define AMBIENTES_POR_TAREFA 32 // Ambientes que cada tarefa do pool anda (menos tarefas, menos disputa)
+
+// Observao de um ambiente: floats nessas posies. Posies vo de 0 a 1 no tamanho da fase e velocidades
+// em px por passo.
+enum {
+    OBS_FOGO_X, OBS_FOGO_Y, OBS_FOGO_VX, OBS_FOGO_VY, OBS_FOGO_PODE_PULAR,
+    OBS_AGUA_X, OBS_AGUA_Y, OBS_AGUA_VX, OBS_AGUA_VY, OBS_AGUA_PODE_PULAR,
+    OBS_DIAMANTE,           // 1 se a fase tem diamante e ele ainda no foi pego
+    OBS_DIAMANTE_X, OBS_DIAMANTE_Y,
+    OBS_PORTA_FOGO_X, OBS_PORTA_FOGO_Y,
+    OBS_PORTA_AGUA_X, OBS_PORTA_AGUA_Y,
+    OBS_TEMPO,              // Passos do episdio / limite de passos (0 sem limite)
+    TAMANHO_OBSERVACAO
+};
+
+typedef enum {
+    EPISODIO_CONTINUA = 0,
+    EPISODIO_TERMINOU,      // Morte, queda ou vitria
+    EPISODIO_CORTADO        // Chegou no limite de passos
+} FimEpisodio;
+
+// Contagens de uma tarefa no ltimo passo (cada tarefa escreve s na sua, sem trava)
+typedef struct {
+    long long episodios;
+    long long vitorias;
+} ContagemTarefa;
+
+typedef struct {
+    int numAmbientes;
+    long long limitePassos;   // Passos por episdio (0 = sem limite)
+    Mundo *mundos;            // numAmbientes mundos seguidos na memria
+
+    float *observacoes;       // numAmbientes * TAMANHO_OBSERVACAO
+    float *observacoesFinais; // numAmbientes * TAMANHO_OBSERVACAO, do fim do episdio (s onde terminou != EPISODIO_CONTINUA)
+    float *recompensas;       // numAmbientes
+    uint8_t *terminou;        // numAmbientes, FimEpisodio do ltimo passo
+
+    PoolTarefas *pool;
+    const uint8_t *acoes;     // Aes do passo que est rodando
+    ContagemTarefa *contagens; // Uma por tarefa do pool
+
+    long long passosTotais;   // Soma dos passos de todos os ambientes
+    long long episodios;      // Episdios terminados (inclusive cortados)
+    long long vitorias;
+    double segundos;          // Tempo gasto dentro de PassoAmbientes
+} Ambientes;
+
+// Cria numAmbientes mundos sobre as fases (o ambiente i joga a fase i % numFases) e j preenche as observaes
+// iniciais. numTrabalhadores <= 0 usa um por ncleo.
+void CriarAmbientes(Ambientes *a, const DadosFase *fases, int numFases, int numAmbientes, int numTrabalhadores,
+                    long long limitePassos);
+void LiberarAmbientes(Ambientes *a);
+
+// Recomea todos os episdios
+void ReiniciarAmbientes(Ambientes *a);
+
+// Um passo em todos: acoes tem numAmbientes * 2 bytes (Fogo e gua de cada ambiente, bits ACAO_*)
+void PassoAmbientes(Ambientes *a, const uint8_t acoes[]);
+
+// Passos de ambiente por segundo desde a criao
+static inline double PassosPorSegundoAmbientes(const Ambientes *a) {
+    return (a->segundos > 0.0) ? a->passosTotais / a->segundos : 0.0;
+}
+
+#endif
@@ -0,0 +1,248 @@
+// Plataformas mveis: caminhos e mveis que dormem paradas (ver cinematica.h)
+#include "cinematica.h"
+#include "memoria.h"
+#include <math.h>
+#include <stdlib.h>
+
+void MontarCaminhos(Mundo *mundo, const DadosFase *fase) {
+    int numMoveis = fase->numPlataformasMoveis;
+    int numCaminhos = fase->numCaminhos;
+    mundo->caminhoDoMovel = (int *)Reservar(mundo->caminhoDoMovel, &mundo->capCaminhoDoMovel, numMoveis, sizeof(int));
+    for (int i = 0; i < numMoveis; i++) mundo->caminhoDoMovel[i] = -1;
+    mundo->tabelasCaminhos = (TabelaCaminho *)Reservar(mundo->tabelasCaminhos, &mundo->capTabelasCaminhos, numCaminhos, sizeof(TabelaCaminho));
+
+    // Um trecho por par de pontos (mais a volta no LACO), ento no mximo numPontos + 1 distncias por caminho
+    int numDistancias = 0;
+    for (int c = 0; c < numCaminhos; c++)
+        numDistancias += (fase->caminhos[c].numPontos > 0 ? fase->caminhos[c].numPontos : 0) + 1;
+    mundo->distanciasCaminhos = (float *)Reservar(mundo->distanciasCaminhos, &mundo->capDistanciasCaminhos, numDistancias, sizeof(float));
+
+    int inicio = 0;
+    for (int c = 0; c < numCaminhos; c++) {
+        const CaminhoMovel *cm = &fase->caminhos[c];
+        TabelaCaminho *t = &mundo->tabelasCaminhos[c];
+        // Caminho invlido (ou segundo caminho da mesma mvel) fica sem trechos e a mvel segue em linha reta
+        bool valido = cm->movel >= 0 && cm->movel < numMoveis && mundo->caminhoDoMovel[cm->movel] < 0 &&
+                      cm->numPontos >= 1 && cm->primeiroPonto >= 0 && cm->primeiroPonto + cm->numPontos <= fase->numPontosCaminho;
+        const Vector2 *pontos = fase->pontosCaminho + (valido ? cm->primeiroPonto : 0);
+        float *dist = mundo->distanciasCaminhos + inicio;
+
+        t->inicio = inicio;
+        t->numTrechos = !valido ? 0 : (cm->tipo == CAMINHO_LACO && cm->numPontos > 1) ? cm->numPontos : cm->numPontos - 1;
+        dist[0] = 0;
+        for (int k = 1; k <= t->numTrechos; k++) {
+            Vector2 a = pontos[k - 1], b = pontos[k % cm->numPontos];
+            dist[k] = dist[k - 1] + hypotf(b.x - a.x, b.y - a.y);
+        }
+        t->comprimento = dist[t->numTrechos];
+        float velocidade = valido ? fase->plataformasMoveis[cm->movel].velocidade : 0;
+        t->duracao = (velocidade > 0 && t->comprimento > 0) ? t->comprimento / velocidade : 0;
+        if (valido) mundo->caminhoDoMovel[cm->movel] = c;
+        inicio += t->numTrechos + 1;
+    }
+}
+
+void LiberarCaminhos(Mundo *mundo) {
+    free(mundo->tabelasCaminhos);
+    free(mundo->distanciasCaminhos);
+    free(mundo->caminhoDoMovel);
+    free(mundo->corpos);
+    free(mundo->corposTroca);
+    free(mundo->acordadas);
+    mundo->tabelasCaminhos = NULL;
+    mundo->distanciasCaminhos = NULL;
+    mundo->caminhoDoMovel = NULL;
+    mundo->corpos = NULL;
+    mundo->corposTroca = NULL;
+    mundo->acordadas = NULL;
+    mundo->capTabelasCaminhos = 0;
+    mundo->capDistanciasCaminhos = 0;
+    mundo->capCaminhoDoMovel = 0;
+    mundo->capCorpos = 0;
+    mundo->capCorposTroca = 0;
+    mundo->capAcordadas = 0;
+    mundo->numAcordadas = 0;
+}
+
+// Posio no caminho c depois de andar tempo passos (o LACO j chega aqui com o tempo dentro de uma volta)
+static Vector2 PosicaoNoCaminho(const Mundo *mundo, int c, float tempo) {
+    const CaminhoMovel *cm = &mundo->faseAtual->caminhos[c];
+    const TabelaCaminho *t = &mundo->tabelasCaminhos[c];
+    const Vector2 *pontos = mundo->faseAtual->pontosCaminho + cm->primeiroPonto;
+    if (t->duracao <= 0) return pontos[0];
+
+    float u = tempo / t->duracao;
+    if (u < 0) u = 0;
+    if (u > 1) u = 1;
+    if (cm->tipo == CAMINHO_SUAVE) u = u * u * (3 - 2 * u);
+    float d = u * t->comprimento;
+
+    // ltimo trecho que comea antes de d (busca binria nas distncias acumuladas)
+    const float *dist = mundo->distanciasCaminhos + t->inicio;
+    int lo = 0, hi = t->numTrechos - 1;
+    while (lo < hi) {
+        int meio = (lo + hi + 1) / 2;
+        if (dist[meio] <= d) lo = meio;
+        else hi = meio - 1;
+    }
+    float tamanho = dist[lo + 1] - dist[lo];
+    float f = (tamanho > 0) ? (d - dist[lo]) / tamanho : 0;
+    Vector2 a = pontos[lo], b = pontos[(lo + 1) % cm->numPontos];
+    return (Vector2){ a.x + (b.x - a.x) * f, a.y + (b.y - a.y) * f };
+}
+
+void IniciarCorpo(const Mundo *mundo, int id, PlataformaMovel *p, CorpoCinematico *c) {
+    c->caminho = mundo->caminhoDoMovel[id];
+    c->tempo = 0;
+    c->arrastoX = 0;
+    c->acordada = false;
+    if (c->caminho >= 0) {
+        Vector2 pos = PosicaoNoCaminho(mundo, c->caminho, 0);
+        p->retangulo.x = pos.x;
+        p->retangulo.y = pos.y;
+    }
+}
+
+bool MovelSempreAtiva(const Mundo *mundo, int id) {
+    int c = mundo->caminhoDoMovel[id];
+    return c >= 0 && mundo->faseAtual->caminhos[c].sempreAtiva;
+}
+
+// true se a mvel carregada i j est onde deveria ficar e no tem o que andar
+static bool Parada(const Mundo *mundo, int i) {
+    const PlataformaMovel *p = &mundo->plataformasMoveisAtuais[i];
+    const CorpoCinematico *c = &mundo->corpos[i];
+    if (c->caminho < 0) {
+        Vector2 destino = p->ativa ? p->posFinal : p->posInicial;
+        return p->retangulo.x == destino.x && p->retangulo.y == destino.y;
+    }
+    float duracao = mundo->tabelasCaminhos[c->caminho].duracao;
+    if (duracao <= 0) return true;
+    if (mundo->faseAtual->caminhos[c->caminho].tipo == CAMINHO_LACO) return !p->ativa;
+    return p->ativa ? c->tempo >= duracao : c->tempo <= 0;
+}
+
+void AcordarMovel(Mundo *mundo, int i) {
+    CorpoCinematico *c = &mundo->corpos[i];
+    // Na linha reta o arrasto s depende de estar ativa, ento muda aqui e no a cada passo
+    if (c->caminho < 0) c->arrastoX = ArrastoReto(&mundo->plataformasMoveisAtuais[i]);
+    if (c->acordada) return;
+    c->acordada = true;
+    mundo->acordadas[mundo->numAcordadas++] = i;
+}
+
+void AcordarMoveis(Mundo *mundo) {
+    int n = mundo->numPlataformasMoveisAtuais;
+    mundo->acordadas = (int *)Reservar(mundo->acordadas, &mundo->capAcordadas, n, sizeof(int));
+    mundo->numAcordadas = 0;
+    for (int i = 0; i < n; i++) {
+        CorpoCinematico *c = &mundo->corpos[i];
+        c->acordada = false;
+        if (!Parada(mundo, i)) AcordarMovel(mundo, i);
+        else c->arrastoX = (c->caminho < 0) ? ArrastoReto(&mundo->plataformasMoveisAtuais[i]) : 0;
+    }
+}
+
+// Uma mvel acordada anda um passo: linha reta soma a velocidade em cada eixo, caminho avana o tempo
+static void AndarMovel(Mundo *mundo, int i) {
+    PlataformaMovel *p = &mundo->plataformasMoveisAtuais[i];
+    CorpoCinematico *c = &mundo->corpos[i];
+    if (c->caminho < 0) {
+        // Ativa vai para posFinal, inativa volta para posInicial
+        Vector2 destino = p->ativa ? p->posFinal : p->posInicial;
+        if (p->retangulo.x < destino.x) p->retangulo.x = fmin(p->retangulo.x + p->velocidade, destino.x);
+        if (p->retangulo.x > destino.x) p->retangulo.x = fmax(p->retangulo.x - p->velocidade, destino.x);
+        if (p->retangulo.y < destino.y) p->retangulo.y = fmin(p->retangulo.y + p->velocidade, destino.y);
+        if (p->retangulo.y > destino.y) p->retangulo.y = fmax(p->retangulo.y - p->velocidade, destino.y);
+        return;
+    }
+
+    float duracao = mundo->tabelasCaminhos[c->caminho].duracao;
+    if (mundo->faseAtual->caminhos[c->caminho].tipo == CAMINHO_LACO) {
+        c->tempo += 1;
+        if (c->tempo >= duracao) c->tempo -= duracao;
+    } else if (p->ativa) {
+        c->tempo = fminf(c->tempo + 1, duracao);
+    } else {
+        c->tempo = fmaxf(c->tempo - 1, 0);
+    }
+    Vector2 pos = PosicaoNoCaminho(mundo, c->caminho, c->tempo);
+    c->arrastoX = pos.x - p->retangulo.x;
+    p->retangulo.x = pos.x;
+    p->retangulo.y = pos.y;
+}
+
+// Anda as mveis acordadas. A que j estava parada no comeo do passo dorme (o passo em que ela chegou
+// j foi pro ndice), ento s o que andou mexe na SoA e na grade.
+void AtualizarPlataformasMoveis(Mundo *mundo) {
+    int restantes = 0;
+    for (int k = 0; k < mundo->numAcordadas; k++) {
+        int i = mundo->acordadas[k];
+        CorpoCinematico *c = &mundo->corpos[i];
+        if (Parada(mundo, i)) {
+            c->acordada = false;
+            if (c->caminho >= 0) c->arrastoX = 0;
+            continue;
+        }
+        AndarMovel(mundo, i);
+        mundo->acordadas[restantes++] = i;
+    }
+    mundo->numAcordadas = restantes;
+
+    // Com poucas mveis a grade nem  consultada (ver Candidatos), s a cpia SoA
+    IndiceColisao *indice = &mundo->indicePlataformasMoveis;
+    for (int k = 0; k < restantes; k++) {
+        int i = mundo->acordadas[k];
+        AtualizarColisor(&indice->soa, i, mundo->plataformasMoveisAtuais[i].retangulo);
+    }
+    if (restantes > 0 && mundo->numPlataformasMoveisAtuais >= MIN_ITENS_GRADE)
+        AtualizarItensGrade(&indice->grade, &mundo->plataformasMoveisAtuais[0].retangulo, sizeof(PlataformaMovel), mundo->acordadas, restantes);
+}
+
+// Pe todas as mveis carregadas na SoA e na grade
+static void RefazerIndiceMoveis(Mundo *mundo) {
+    IndiceColisao *indice = &mundo->indicePlataformasMoveis;
+    for (int i = 0; i < mundo->numPlataformasMoveisAtuais; i++)
+        AtualizarColisor(&indice->soa, i, mundo->plataformasMoveisAtuais[i].retangulo);
+    if (mundo->numPlataformasMoveisAtuais >= MIN_ITENS_GRADE)
+        AtualizarGrade(&indice->grade, &mundo->plataformasMoveisAtuais[0].retangulo, sizeof(PlataformaMovel), mundo->numPlataformasMoveisAtuais);
+}
+
+void RestaurarMoveis(Mundo *mundo) {
+    int n = mundo->numPlataformasMoveisAtuais;
+    mundo->acordadas = (int *)Reservar(mundo->acordadas, &mundo->capAcordadas, n, sizeof(int));
+    mundo->numAcordadas = 0;
+    for (int i = 0; i < n; i++)
+        if (mundo->corpos[i].acordada) mundo->acordadas[mundo->numAcordadas++] = i;
+    RefazerIndiceMoveis(mundo);
+}
+
+void AtualizarIndiceMoveis(Mundo *mundo) {
+    AcordarMoveis(mundo);
+    RefazerIndiceMoveis(mundo);
+}
+
+void CaixasDosCaminhos(const DadosFase *fase, Rectangle caixas[]) {
+    for (int i = 0; i < fase->numPlataformasMoveis; i++) {
+        const PlataformaMovel *p = &fase->plataformasMoveis[i];
+        float x0 = fminf(p->retangulo.x, fminf(p->posInicial.x, p->posFinal.x));
+        float y0 = fminf(p->retangulo.y, fminf(p->posInicial.y, p->posFinal.y));
+        float x1 = fmaxf(p->retangulo.x, fmaxf(p->posInicial.x, p->posFinal.x)) + p->retangulo.width;
+        float y1 = fmaxf(p->retangulo.y, fmaxf(p->posInicial.y, p->posFinal.y)) + p->retangulo.height;
+        caixas[i] = (Rectangle){ x0, y0, x1 - x0, y1 - y0 };
+    }
+    // Os pontos de um caminho so o canto da plataforma, ento a caixa cresce o tamanho dela alm do ponto
+    for (int c = 0; c < fase->numCaminhos; c++) {
+        const CaminhoMovel *cm = &fase->caminhos[c];
+        if (cm->movel < 0 || cm->movel >= fase->numPlataformasMoveis || cm->primeiroPonto < 0 ||
+            cm->primeiroPonto + cm->numPontos > fase->numPontosCaminho) continue;
+        Rectangle *r = &caixas[cm->movel];
+        Rectangle tamanho = fase->plataformasMoveis[cm->movel].retangulo;
+        for (int k = 0; k < cm->numPontos; k++) {
+            Vector2 ponto = fase->pontosCaminho[cm->primeiroPonto + k];
+            float x0 = fminf(r->x, ponto.x), y0 = fminf(r->y, ponto.y);
+            float x1 = fmaxf(r->x + r->width, ponto.x + tamanho.width), y1 = fmaxf(r->y + r->height, ponto.y + tamanho.height);
+            *r = (Rectangle){ x0, y0, x1 - x0, y1 - y0 };
+        }
+    }
+}
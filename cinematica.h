@@ -0,0 +1,45 @@
+/*
+Plataformas mveis como corpos cinemticos: cada mvel carregada tem um CorpoCinematico (simulacao.h)
+e s as acordadas entram no passo. Uma mvel que chegou onde devia ficar (fim ou comeo do caminho,
+conforme est ativa) dorme: no anda, no mexe no ndice de coliso e no custa nada at ser acordada
+por um boto, por uma troca de pedaos ou pelo reincio da fase.
+
+Mvel com caminho (CaminhoMovel) tem a posio calculada a partir do tempo andado, pela tabela de
+distncias do caminho montada ao carregar a fase; as sem caminho continuam andando em linha reta.
+*/
+#ifndef CINEMATICA_H
+#define CINEMATICA_H
+
+#include "simulacao.h"
+
+// Monta as tabelas dos caminhos da fase (s ao carregar a fase)
+void MontarCaminhos(Mundo *mundo, const DadosFase *fase);
+void LiberarCaminhos(Mundo *mundo);
+
+// Prepara o corpo da mvel id (ndice na fase) como ela comea na fase: tempo zero e, se tiver caminho,
+// p j no primeiro ponto dele. O arrasto s  calculado quando ela  acordada.
+void IniciarCorpo(const Mundo *mundo, int id, PlataformaMovel *p, CorpoCinematico *c);
+
+// Acorda a mvel carregada i (a ativa dela mudou)
+void AcordarMovel(Mundo *mundo, int i);
+// Refaz a lista das acordadas olhando todas as carregadas
+void AcordarMoveis(Mundo *mundo);
+
+// Depois de voltar as mveis e os corpos (com o acordada de cada um) de um estado salvo: refaz a lista das
+// acordadas e o ndice delas sem recalcular nada
+void RestaurarMoveis(Mundo *mundo);
+
+// true se a mvel (id na fase) anda sem boto
+bool MovelSempreAtiva(const Mundo *mundo, int id);
+
+// Caixa que cada mvel da fase ocupa no caminho todo, linha reta ou no (pros pedaos); caixas tem
+// numPlataformasMoveis posies
+void CaixasDosCaminhos(const DadosFase *fase, Rectangle caixas[]);
+
+// Arrasto da mvel em linha reta: ativa e andando em x, empurra quem est em cima na velocidade dela
+static inline float ArrastoReto(const PlataformaMovel *p) {
+    if (!p->ativa || p->posInicial.x == p->posFinal.x) return 0.0f;
+    return (p->posFinal.x > p->posInicial.x) ? p->velocidade : -p->velocidade;
+}
+
+#endif
@@ -0,0 +1,170 @@
+// Colisores em SoA com testes em lote SSE/AVX (ver colisores.h)
+#include "colisores.h"
+#include <stdlib.h>
+#include <float.h>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#define COLISORES_X86 1
+#include <immintrin.h>
+#endif
+
+// Colisor vazio usado pra completar o ltimo lote: nunca encosta em nada
+static void ColisorVazio(ColisoresSoA *c, int i) {
+    c->esquerda[i] = FLT_MAX;
+    c->topo[i] = FLT_MAX;
+    c->direita[i] = -FLT_MAX;
+    c->baixo[i] = -FLT_MAX;
+}
+
+void MontarColisores(ColisoresSoA *c, const Rectangle *recs, size_t passo, int n) {
+    int numLotes = (n + LOTE_COLISORES - 1) / LOTE_COLISORES;
+    int total = numLotes * LOTE_COLISORES;
+
+    // Um bloco s para os 4 vetores, reaproveitado entre fases
+    if (total > c->capacidade || c->esquerda == NULL) {
+        free(c->esquerda);
+        int cap = total > 0 ? total : LOTE_COLISORES;
+        float *bloco = (float *)malloc(sizeof(float) * 4 * (size_t)cap);
+        c->esquerda = bloco;
+        c->topo = bloco + cap;
+        c->direita = bloco + 2 * cap;
+        c->baixo = bloco + 3 * cap;
+        c->capacidade = cap;
+    }
+
+    c->num = n;
+    c->numLotes = numLotes;
+    for (int i = 0; i < n; i++) {
+        AtualizarColisor(c, i, *(const Rectangle *)((const char *)recs + passo * (size_t)i));
+    }
+    for (int i = n; i < total; i++) ColisorVazio(c, i);
+}
+
+void AtualizarColisor(ColisoresSoA *c, int i, Rectangle r) {
+    c->esquerda[i] = r.x;
+    c->topo[i] = r.y;
+    c->direita[i] = r.x + r.width;
+    c->baixo[i] = r.y + r.height;
+}
+
+#ifndef COLISORES_X86
+// Verso sem SIMD (mesma conta do CheckCollisionRecs)
+static unsigned int MascaraLoteEscalar(const ColisoresSoA *c, int lote, Rectangle rec) {
+    float recDireita = rec.x + rec.width;
+    float recBaixo = rec.y + rec.height;
+    unsigned int mascara = 0;
+    int base = lote * LOTE_COLISORES;
+    for (int k = 0; k < LOTE_COLISORES; k++) {
+        int i = base + k;
+        if (rec.x < c->direita[i] && recDireita > c->esquerda[i] && rec.y < c->baixo[i] && recBaixo > c->topo[i])
+            mascara |= 1u << k;
+    }
+    return mascara;
+}
+#endif
+
+#ifdef COLISORES_X86
+// SSE: duas metades de 4 colisores
+static unsigned int MascaraLoteSSE(const ColisoresSoA *c, int lote, Rectangle rec) {
+    __m128 x0 = _mm_set1_ps(rec.x);
+    __m128 y0 = _mm_set1_ps(rec.y);
+    __m128 x1 = _mm_set1_ps(rec.x + rec.width);
+    __m128 y1 = _mm_set1_ps(rec.y + rec.height);
+    unsigned int mascara = 0;
+    int base = lote * LOTE_COLISORES;
+    for (int metade = 0; metade < 2; metade++) {
+        int i = base + metade * 4;
+        __m128 m = _mm_and_ps(_mm_cmplt_ps(x0, _mm_loadu_ps(&c->direita[i])),
+                              _mm_cmpgt_ps(x1, _mm_loadu_ps(&c->esquerda[i])));
+        m = _mm_and_ps(m, _mm_cmplt_ps(y0, _mm_loadu_ps(&c->baixo[i])));
+        m = _mm_and_ps(m, _mm_cmpgt_ps(y1, _mm_loadu_ps(&c->topo[i])));
+        mascara |= (unsigned int)_mm_movemask_ps(m) << (metade * 4);
+    }
+    return mascara;
+}
+
+// AVX: os 8 colisores do lote numa instruo s
+__attribute__((target("avx")))
+static unsigned int MascaraLoteAVX(const ColisoresSoA *c, int lote, Rectangle rec) {
+    int i = lote * LOTE_COLISORES;
+    __m256 m = _mm256_and_ps(_mm256_cmp_ps(_mm256_set1_ps(rec.x), _mm256_loadu_ps(&c->direita[i]), _CMP_LT_OQ),
+                             _mm256_cmp_ps(_mm256_set1_ps(rec.x + rec.width), _mm256_loadu_ps(&c->esquerda[i]), _CMP_GT_OQ));
+    m = _mm256_and_ps(m, _mm256_cmp_ps(_mm256_set1_ps(rec.y), _mm256_loadu_ps(&c->baixo[i]), _CMP_LT_OQ));
+    m = _mm256_and_ps(m, _mm256_cmp_ps(_mm256_set1_ps(rec.y + rec.height), _mm256_loadu_ps(&c->topo[i]), _CMP_GT_OQ));
+    return (unsigned int)_mm256_movemask_ps(m);
+}
+
+__attribute__((target("avx")))
+static int ColisoesLoteAVX(const ColisoresSoA *c, Rectangle rec, int saida[], int maxSaida) {
+    int total = 0;
+    for (int lote = 0; lote < c->numLotes; lote++) {
+        unsigned int mascara = MascaraLoteAVX(c, lote, rec);
+        while (mascara) {
+            int k = __builtin_ctz(mascara);
+            if (total < maxSaida) saida[total] = lote * LOTE_COLISORES + k;
+            total++;
+            mascara &= mascara - 1;
+        }
+    }
+    return total;
+}
+#endif
+
+typedef unsigned int (*FuncaoMascara)(const ColisoresSoA *, int, Rectangle);
+
+// 0 = escalar, 1 = SSE, 2 = AVX (decidido uma vez olhando a CPU)
+static int NivelInstrucoes(void) {
+#ifdef COLISORES_X86
+    static const int nivel = __builtin_cpu_supports("avx") ? 2 : 1;
+    return nivel;
+#else
+    return 0;
+#endif
+}
+
+static FuncaoMascara EscolherMascara(void) {
+#ifdef COLISORES_X86
+    if (NivelInstrucoes() == 2) return MascaraLoteAVX;
+    return MascaraLoteSSE;
+#else
+    return MascaraLoteEscalar;
+#endif
+}
+
+unsigned int MascaraLote(const ColisoresSoA *c, int lote, Rectangle rec) {
+    static const FuncaoMascara funcao = EscolherMascara();
+    return funcao(c, lote, rec);
+}
+
+int ColisoesLote(const ColisoresSoA *c, Rectangle rec, int saida[], int maxSaida) {
+#ifdef COLISORES_X86
+    if (NivelInstrucoes() == 2) return ColisoesLoteAVX(c, rec, saida, maxSaida);
+#endif
+    int total = 0;
+    for (int lote = 0; lote < c->numLotes; lote++) {
+        unsigned int mascara = MascaraLote(c, lote, rec);
+        while (mascara) {
+            int k = __builtin_ctz(mascara);
+            if (total < maxSaida) saida[total] = lote * LOTE_COLISORES + k;
+            total++;
+            mascara &= mascara - 1;
+        }
+    }
+    return total;
+}
+
+const char *InstrucoesColisores(void) {
+    static const char *nomes[] = { "escalar", "SSE", "AVX" };
+    return nomes[NivelInstrucoes()];
+}
+
+void LiberarColisores(ColisoresSoA *c) {
+    free(c->esquerda);
+    c->esquerda = NULL;
+    c->topo = NULL;
+    c->direita = NULL;
+    c->baixo = NULL;
+    c->num = 0;
+    c->numLotes = 0;
+    c->capacidade = 0;
+}
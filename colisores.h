@@ -0,0 +1,44 @@
+/*
+Colisores guardados em estrutura de vetores (SoA): esquerda, topo, direita e baixo em vetores separados.
+Assim d pra testar o retngulo do jogador contra 4 (SSE) ou 8 (AVX) colisores de uma vez,
+e o resultado  uma mscara de bits (bit i ligado = colidiu com o colisor inicio+i).
+Os testes do exatamente o mesmo resultado que CheckCollisionRecs.
+*/
+#ifndef COLISORES_H
+#define COLISORES_H
+
+#include <stddef.h>
+#include "tipos.h"
+
+// Tamanho do lote; os vetores so completados com colisores vazios at um mltiplo disso
+#define LOTE_COLISORES 8
+
+typedef struct {
+    float *esquerda; // x
+    float *topo;     // y
+    float *direita;  // x + width
+    float *baixo;    // y + height
+    int num;
+    int numLotes;
+    int capacidade;
+} ColisoresSoA;
+
+// Copia os retngulos (recs/passo igual ao ConstruirGrade) para o formato SoA
+void MontarColisores(ColisoresSoA *c, const Rectangle *recs, size_t passo, int n);
+
+// Atualiza um colisor que andou (plataformas mveis)
+void AtualizarColisor(ColisoresSoA *c, int i, Rectangle r);
+
+// Mscara de coliso de rec com os colisores [lote*8, lote*8 + 8)
+unsigned int MascaraLote(const ColisoresSoA *c, int lote, Rectangle rec);
+
+// Coloca em saida os ids (em ordem crescente) de todos os colisores que encostam em rec.
+// Devolve quantos so; se for maior que maxSaida s os primeiros maxSaida foram escritos.
+int ColisoesLote(const ColisoresSoA *c, Rectangle rec, int saida[], int maxSaida);
+
+// Nome do conjunto de instrues em uso ("AVX", "SSE" ou "escalar")
+const char *InstrucoesColisores(void);
+
+void LiberarColisores(ColisoresSoA *c);
+
+#endif
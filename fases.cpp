@@ -0,0 +1,106 @@
+// Dados das fases do jogo (antes ficavam no comeo do main)
+#include "fases.h"
+
+const Fase fasesPadrao[MAX_FASES] = {
+    // Fase 1
+    {
+        .plataformas = {
+            {{ 0, 550, LARGURA_TELA, 50 }}, {{ 0, 400, LARGURA_TELA - 100, 20 }},
+            {{ 100, 250, LARGURA_TELA - 100, 20 }}, {{ 200, 320, 100, 20 }},
+            {{ 600, 300, 100, 20 }}
+        },
+        .perigos = {
+            {{ 300, 530, 150, 20 }, AGUA, SKYBLUE}, {{ 300, 380, 150, 20 }, FOGO, RED},
+            {{ 220, 300, 80, 20 }, AGUA, SKYBLUE}, {{ 420, 450, 100, 20 }, FOGO, RED},
+            {{ 350, 490, 80, 20 }, TERRA, GREEN}
+        },
+        .portas = {
+            {{ LARGURA_TELA - 120, 210, 40, 40 }, JOGADOR_FOGO, (Color){255,100,100,255}},
+            {{ LARGURA_TELA - 70, 210, 40, 40 }, JOGADOR_AGUA, (Color){100,100,255,255}}
+        },
+        .numPlataformas = 5, .numPerigos = 5, .numPortas = 2, .numBotoes = 0, .numPlataformasMoveis = 0,
+        .posInicialFogo = { 60, 540 }, .posInicialAgua = { 100, 540 },
+        .temDiamante = true, .diamante = { 642, 284, 16, 16 },
+        .tempoPar = 9.22f // resolver_fases: 553 passos
+    },
+    // Fase 2
+    {
+        .plataformas = {
+            {{ 0, 580, LARGURA_TELA, 20 }}, {{ 0, 450, 250, 20 }},
+            {{ 350, 450, 450, 20 }}, {{ 450, 300, 150, 20 }},
+            {{ 600, 200, 200, 20 }}
+        },
+        .perigos = {
+            {{ 260, 560, 150, 20 }, AGUA, SKYBLUE},
+            {{ 450, 280, 150, 20 }, TERRA, GREEN }
+        },
+        .portas = {
+            {{ LARGURA_TELA - 140, 160, 40, 40 }, JOGADOR_FOGO, (Color){255,100,100,255}},
+            {{ LARGURA_TELA - 90, 160, 40, 40 }, JOGADOR_AGUA, (Color){100,100,255,255}}
+        },
+        .botoes = {
+            {{ 100, 430, 50, 10 }, .idAlvo = 0, .pressionado = false, .cor = DARKBLUE },
+            {{ 750, 430, 50, 10 }, .idAlvo = 1, .pressionado = false, .cor = ORANGE },
+            {{ 695, 190, 50, 10 }, .idAlvo = 1, .pressionado = false, .cor = PURPLE }
+        },
+        .plataformasMoveis = {
+            {{ 300, 370, 20, 100 }, {300, 370}, {300, 270}, false, 1.0f},
+            {{ 500, 430, 50, 20 }, {500, 430}, {500, 220}, false, 1.5f}
+        },
+        .numPlataformas = 5, .numPerigos = 2, .numPortas = 2, .numBotoes = 3, .numPlataformasMoveis = 2,
+        .posInicialFogo = { 60, 570 }, .posInicialAgua = { 100, 570 },
+        .temDiamante = true, .diamante = { 758, 414, 16, 16 },
+        .tempoPar = 17.43f // resolver_fases: 1046 passos (por metas)
+    },
+    // FASE 3
+    {
+        .plataformas = {
+            // Seo da gua (Superior Esquerda)
+            { { 0, 120, 150, 20 } },    // 1. Incio gua
+            { { 200, 180, 150, 20 } },  // 2. Aps a primeira ponte
+            // Seo do Fogo (Inferior Direita)
+            { { LARGURA_TELA - 150, 500, 150, 20 } }, // 3. Incio Fogo
+            { { LARGURA_TELA - 350, 420, 150, 20 } }, // 4. Aps a primeira ponte
+            // Seo Central (Encontro)
+            { { 300, 320, 150, 20 } },  // 5. Plataforma central das portas
+            { { 0, 280, 100, 20 } },     // 6. Plataforma do boto do diamante
+            { { 350, 520, 50, 20 } },
+            { { 140, 180, 20, 140} } //8. Plataforma que impede que o player azul pegue um caminho alternativo para o boto do diamante
+        },
+        .perigos = {
+            // Perigos da gua
+            { { 150, 120, 50, 20 }, FOGO, RED },
+            // Perigos do Fogo
+            { { LARGURA_TELA - 200, 500, 50, 20 }, AGUA, SKYBLUE},
+            // Perigo Central
+            { { 150, 580, LARGURA_TELA - 300, 20 }, TERRA, GREEN}
+        },
+        .portas = {
+            { { 335, 280, 40, 40 }, JOGADOR_FOGO, (Color){255,100,100,255} },
+            { { 395, 280, 40, 40 }, JOGADOR_AGUA, (Color){100,100,255,255} }
+        },
+        .botoes = {
+            // Botes de progresso cruzada
+            { { 700, 480, 50, 10 }, .idAlvo = 0, .pressionado = false, .cor = ORANGE },   // Fogo ajuda gua
+            // Boto do diamante (cooperativo)
+            { { 40, 260, 50, 10 }, .idAlvo = 1, .pressionado = false, .cor = PURPLE }
+        },
+        .plataformasMoveis = {
+            // Plataformas de progresso
+            { .retangulo = {150, 160, 100, 20}, .posInicial = {100, 160}, .posFinal = {200, 160}, .ativa = false, .velocidade = 1.0f}, // Ponte para gua
+            // Plataforma do diamante
+            { .retangulo = { 370, 200, 20, 200}, .posInicial = {370, 340}, .posFinal = {370, 280}, .ativa = false, .velocidade = 2.0f} // Porta do diamante
+        },
+        .numPlataformas = 8,.numPerigos = 3,.numPortas = 2,.numBotoes = 2,.numPlataformasMoveis = 2,
+        .posInicialFogo = { LARGURA_TELA - 50, 490 },.posInicialAgua = { 50, 110 },
+        .temDiamante = true,.diamante = { 346, 484, 16, 16 },
+        .tempoPar = 10.60f // resolver_fases: 636 passos (por metas)
+    }
+};
+
+const int numFasesPadrao = 3; // Define a quantidade de fases que o nosso jogo tem
+
+int MontarDadosFasesPadrao(DadosFase dados[MAX_FASES]) {
+    for (int i = 0; i < numFasesPadrao; i++) dados[i] = DadosDaFase(&fasesPadrao[i]);
+    return numFasesPadrao;
+}
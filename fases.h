@@ -0,0 +1,13 @@
+// Fases que j vm com o jogo
+#ifndef FASES_H
+#define FASES_H
+
+#include "simulacao.h"
+
+extern const Fase fasesPadrao[MAX_FASES];
+extern const int numFasesPadrao;
+
+// Preenche dados[] com as vises das fases padro e devolve quantas so
+int MontarDadosFasesPadrao(DadosFase dados[MAX_FASES]);
+
+#endif
@@ -0,0 +1,74 @@
+// Benchmark da API de vrios ambientes (ambientes.h): anda N mundos juntos com aes sorteadas e mostra
+// passos de ambiente por segundo. A soma das recompensas no muda com o nmero de trabalhadores.
+// Uso: bench_ambientes [ambientes] [passos] [pacote|-] [trabalhadores] [limite de passos por episodio]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include "../simulacao.h"
+#include "../fases.h"
+#include "../pacote.h"
+#include "../ambientes.h"
+
+// Gerador simples e determinstico pras aes (xorshift32)
+static unsigned int Aleatorio(unsigned int *estado) {
+    unsigned int x = *estado;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *estado = x;
+    return x;
+}
+
+int main(int argc, char **argv) {
+    int numAmbientes = (argc > 1) ? atoi(argv[1]) : 1024;
+    long long passos = (argc > 2) ? atoll(argv[2]) : 2000;
+    int trabalhadores = (argc > 4) ? atoi(argv[4]) : 0;
+    long long limite = (argc > 5) ? atoll(argv[5]) : 3600;
+    if (numAmbientes <= 0 || passos <= 0) {
+        fprintf(stderr, "Uso: %s [ambientes] [passos] [pacote|-] [trabalhadores] [limite de passos por episodio]\n", argv[0]);
+        return 1;
+    }
+
+    DadosFase dadosPadrao[MAX_FASES];
+    const DadosFase *fases = dadosPadrao;
+    int numFases = MontarDadosFasesPadrao(dadosPadrao);
+    PacoteFases pacote = {0};
+    if (argc > 3 && strcmp(argv[3], "-") != 0) {
+        if (!AbrirPacote(&pacote, argv[3]) || pacote.numFases == 0) return 1;
+        fases = pacote.fases;
+        numFases = pacote.numFases;
+    }
+
+    auto inicioCriar = std::chrono::steady_clock::now();
+    Ambientes ambientes;
+    CriarAmbientes(&ambientes, fases, numFases, numAmbientes, trabalhadores, limite);
+    double msCriar = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicioCriar).count();
+    printf("%d ambientes (%d fases) criados em %.1f ms, %d trabalhadores, limite de %lld passos\n",
+           numAmbientes, numFases, msCriar, TrabalhadoresPool(ambientes.pool), limite);
+
+    // Cada ambiente troca as aes a cada 16 passos, parecido com o bench_simulacao
+    uint8_t *acoes = (uint8_t *)malloc((size_t)numAmbientes * 2);
+    unsigned int semente = 0x9E3779B9u;
+    double somaRecompensas = 0.0;
+    for (long long p = 0; p < passos; p++) {
+        if ((p & 15) == 0) {
+            for (int i = 0; i < numAmbientes; i++) {
+                unsigned int bits = Aleatorio(&semente);
+                acoes[2 * i] = (uint8_t)(bits & 7);
+                acoes[2 * i + 1] = (uint8_t)((bits >> 3) & 7);
+            }
+        }
+        PassoAmbientes(&ambientes, acoes);
+        for (int i = 0; i < numAmbientes; i++) somaRecompensas += ambientes.recompensas[i];
+    }
+
+    printf("%lld passos de ambiente em %.3f s: %.0f passos/s\n", ambientes.passosTotais, ambientes.segundos,
+           PassosPorSegundoAmbientes(&ambientes));
+    printf("%lld episodios, %lld vitorias, soma das recompensas %.1f\n", ambientes.episodios, ambientes.vitorias, somaRecompensas);
+
+    free(acoes);
+    LiberarAmbientes(&ambientes);
+    FecharPacote(&pacote);
+    return 0;
+}
@@ -0,0 +1,195 @@
+// Benchmark da coliso jogador x cenrio: custo de AtualizarJogador varrendo tudo vs usando o ndice
+// (grade + SoA), em fases sintticas de tamanho crescente (mesma densidade de plataformas por rea).
+// Tambm compara um retngulo contra todos os colisores: CheckCollisionRecs um por um vs teste em lote SIMD,
+// e confere que passos grandes no atravessam cho e parede finos (coliso varrida) e que o mapa de perigos
+// (ocupacao.h) responde igual a testar todos os perigos.
+// Uso: bench_colisao [maior numero de plataformas]
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include "../simulacao.h"
+
+#define NUM_ESTADOS 1024
+
+static volatile float sumidouro; // Evita que o compilador jogue os laos fora
+
+static unsigned int Aleatorio(unsigned int *estado) {
+    unsigned int x = *estado;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *estado = x;
+    return x;
+}
+
+static float AleatorioEntre(unsigned int *estado, float minimo, float maximo) {
+    return minimo + (maximo - minimo) * (Aleatorio(estado) / 4294967295.0f);
+}
+
+// Roda AtualizarJogador em vrios estados de jogador e devolve nanossegundos por chamada
+static double MedirAtualizar(const Jogador estados[], Plataforma plat[], int nPlat,
+                             const IndiceColisao *indice, long long chamadas) {
+    float soma = 0;
+    auto inicio = std::chrono::steady_clock::now();
+    for (long long i = 0; i < chamadas; i++) {
+        Jogador j = estados[i % NUM_ESTADOS];
+        AtualizarJogador(&j, plat, nPlat, NULL, 0, GRAVIDADE, indice, NULL, NULL, NULL);
+        soma += j.posicao.x + j.posicao.y;
+    }
+    auto fim = std::chrono::steady_clock::now();
+    sumidouro = soma;
+    return std::chrono::duration<double, std::nano>(fim - inicio).count() / chamadas;
+}
+
+// Um retngulo contra todos os colisores, um por um com CheckCollisionRecs
+static double MedirEscalar(const Jogador estados[], const Plataforma plat[], int nPlat, long long chamadas) {
+    int soma = 0;
+    auto inicio = std::chrono::steady_clock::now();
+    for (long long i = 0; i < chamadas; i++) {
+        Rectangle rec = RetanguloJogador(&estados[i % NUM_ESTADOS]);
+        for (int k = 0; k < nPlat; k++)
+            if (CheckCollisionRecs(rec, plat[k].retangulo)) soma++;
+    }
+    auto fim = std::chrono::steady_clock::now();
+    sumidouro = (float)soma;
+    return std::chrono::duration<double, std::nano>(fim - inicio).count() / chamadas;
+}
+
+// O mesmo teste usando as mscaras SIMD da SoA
+static double MedirLote(const Jogador estados[], const ColisoresSoA *soa, long long chamadas) {
+    int soma = 0;
+    int ids[64];
+    auto inicio = std::chrono::steady_clock::now();
+    for (long long i = 0; i < chamadas; i++) {
+        soma += ColisoesLote(soa, RetanguloJogador(&estados[i % NUM_ESTADOS]), ids, 64);
+    }
+    auto fim = std::chrono::steady_clock::now();
+    sumidouro = (float)soma;
+    return std::chrono::duration<double, std::nano>(fim - inicio).count() / chamadas;
+}
+
+// Jogador caindo / andando rpido contra um cho e uma parede de 20 px (como a plataforma 8 da fase 3).
+// Devolve quantos casos atravessaram.
+static int ConferirPassoGrande(void) {
+    Plataforma plat[2] = {
+        { { 0, 300, 800, 20 } },  // Cho fino
+        { { 400, 0, 20, 300 } },  // Parede fina
+    };
+    int atravessou = 0;
+    for (float v = 30.0f; v <= 400.0f; v *= 1.5f) {
+        // Caindo de cima do cho
+        Jogador j = { JOGADOR_FOGO, { 200, 290 - v / 2 }, { 0, v }, MAROON, false };
+        AtualizarJogador(&j, plat, 2, NULL, 0, GRAVIDADE, NULL, NULL, NULL, NULL);
+        if (j.posicao.y != 300 || !j.podePular) atravessou++;
+
+        // Andando pra direita contra a parede
+        j = (Jogador){ JOGADOR_FOGO, { 380, 200 }, { v, 0 }, MAROON, false };
+        AtualizarJogador(&j, plat, 2, NULL, 0, 0.0f, NULL, NULL, NULL, NULL);
+        if (j.posicao.x + 10 > 400) atravessou++;
+    }
+    return atravessou;
+}
+
+// Perigos sorteados (alinhados de 10 em 10 como nas fases e soltos) e retngulos de jogador sorteados: o mapa de
+// ocupao, conferindo pelos retngulos s na dvida, tem que dar o mesmo que testar todos. Devolve quantos erraram.
+static int ConferirMapaPerigos(void) {
+    unsigned int semente = 4242u;
+    Perigo perigos[200];
+    for (int i = 0; i < 200; i++) {
+        Rectangle r = { AleatorioEntre(&semente, 0, 2000), AleatorioEntre(&semente, 0, 600), AleatorioEntre(&semente, 10, 150), 20 };
+        if (i % 2 == 0) r = (Rectangle){ floorf(r.x / 10) * 10, floorf(r.y / 10) * 10, floorf(r.width / 10) * 10, 20 };
+        perigos[i] = (Perigo){ r, (TipoPerigo)(i % 3), RED };
+    }
+    GradeOcupacao mapa = {0};
+    PrepararOcupacao(&mapa, (Rectangle){ 0, 0, 2150, 620 }, TAM_CELULA_OCUPACAO);
+    for (int i = 0; i < 200; i++) MarcarOcupacao(&mapa, perigos[i].retangulo, perigos[i].tipo);
+
+    int erros = 0;
+    for (int k = 0; k < 200000; k++) {
+        Rectangle rec = { AleatorioEntre(&semente, -50, 2200), AleatorioEntre(&semente, -50, 700), 20, 20 };
+        if (k % 4 == 0) { rec.x = floorf(rec.x); rec.y = floorf(rec.y); } // Bordas exatas tambm
+        TipoPerigo inofensivo = (TipoPerigo)(k % 2);
+        bool esperado = false;
+        for (int i = 0; i < 200 && !esperado; i++)
+            esperado = perigos[i].tipo != inofensivo && CheckCollisionRecs(rec, perigos[i].retangulo);
+        unsigned int mortais = 7u & ~(1u << inofensivo);
+        ResultadoOcupacao r = ConsultarOcupacao(&mapa, rec, mortais);
+        bool achou = (r == OCUPACAO_TOCA);
+        if (r == OCUPACAO_DUVIDA)
+            for (int i = 0; i < 200 && !achou; i++)
+                achou = perigos[i].tipo != inofensivo && CheckCollisionRecs(rec, perigos[i].retangulo);
+        if (achou != esperado) erros++;
+    }
+    LiberarOcupacao(&mapa);
+    return erros;
+}
+
+int main(int argc, char **argv) {
+    int maximo = 100000;
+    if (argc > 1) maximo = atoi(argv[1]);
+    if (maximo < 10) {
+        fprintf(stderr, "Uso: %s [maior numero de plataformas (>= 10)]\n", argv[0]);
+        return 1;
+    }
+
+    int atravessou = ConferirPassoGrande();
+    if (atravessou > 0) printf("ERRO: %d casos de passo grande atravessaram a plataforma\n", atravessou);
+    else printf("Passo grande: nenhum caso atravessou chao/parede finos\n");
+
+    int errosMapa = ConferirMapaPerigos();
+    if (errosMapa > 0) printf("ERRO: %d consultas ao mapa de perigos deram resultado diferente\n", errosMapa);
+    else printf("Mapa de perigos: mesmo resultado que testar todos os perigos\n");
+
+    printf("Testes em lote: %s\n", InstrucoesColisores());
+    printf("%10s %12s %12s %12s %8s %12s %12s %8s\n", "colisores", "montar(us)", "varrer(ns)", "indice(ns)", "ganho",
+           "escalar(ns)", "lote(ns)", "ganho");
+
+    IndiceColisao indice = {0};
+    for (int n = 10; n <= maximo; n *= 10) {
+        // Uma plataforma a cada 120x120 px em mdia, num mundo quadrado
+        unsigned int semente = 12345u + n;
+        float lado = sqrtf((float)n) * 120.0f;
+        Plataforma *plat = (Plataforma *)malloc(sizeof(Plataforma) * n);
+        for (int i = 0; i < n; i++) {
+            plat[i].retangulo = (Rectangle){ AleatorioEntre(&semente, 0, lado), AleatorioEntre(&semente, 0, lado),
+                                             AleatorioEntre(&semente, 40, 200), 20 };
+        }
+
+        Jogador estados[NUM_ESTADOS];
+        for (int i = 0; i < NUM_ESTADOS; i++) {
+            estados[i] = (Jogador){ JOGADOR_FOGO, { AleatorioEntre(&semente, 0, lado), AleatorioEntre(&semente, 0, lado) },
+                                    { 0, AleatorioEntre(&semente, -6, 6) }, MAROON, false };
+        }
+
+        auto inicio = std::chrono::steady_clock::now();
+        MontarIndice(&indice, &plat[0].retangulo, sizeof(Plataforma), n);
+        auto fim = std::chrono::steady_clock::now();
+        double montar = std::chrono::duration<double, std::micro>(fim - inicio).count();
+
+        // Com e sem ndice o resultado tem que ser igual
+        int diferentes = 0;
+        for (int i = 0; i < NUM_ESTADOS; i++) {
+            Jogador a = estados[i], b = estados[i];
+            AtualizarJogador(&a, plat, n, NULL, 0, GRAVIDADE, NULL, NULL, NULL, NULL);
+            AtualizarJogador(&b, plat, n, NULL, 0, GRAVIDADE, &indice, NULL, NULL, NULL);
+            if (a.posicao.x != b.posicao.x || a.posicao.y != b.posicao.y || a.podePular != b.podePular) diferentes++;
+        }
+
+        // Mais chamadas nas fases pequenas pra medir algo estvel
+        long long chamadasVarrer = 200000000LL / n;
+        if (chamadasVarrer < 2000) chamadasVarrer = 2000;
+        double nsVarrer = MedirAtualizar(estados, plat, n, NULL, chamadasVarrer);
+        double nsIndice = MedirAtualizar(estados, plat, n, &indice, 2000000);
+        double nsEscalar = MedirEscalar(estados, plat, n, chamadasVarrer);
+        double nsLote = MedirLote(estados, &indice.soa, chamadasVarrer);
+
+        printf("%10d %12.1f %12.1f %12.1f %7.1fx %12.1f %12.1f %7.1fx\n", n, montar, nsVarrer, nsIndice, nsVarrer / nsIndice,
+               nsEscalar, nsLote, nsEscalar / nsLote);
+        if (diferentes > 0) printf("ERRO: %d estados deram resultado diferente com o indice\n", diferentes);
+        free(plat);
+    }
+    LiberarIndice(&indice);
+
+    return 0;
+}
@@ -0,0 +1,351 @@
+// Microbenchmarks das funes da fsica e do carregamento de fase, com tempo confivel:
+// aquecimento, vrias amostras e mediana + MAD (desvio absoluto mediano) em vez de uma medida s.
+// Mede AtualizarJogador, ResolverColisaoJogadores, CarregarFase, AtualizarPlataformasMoveis, a busca de
+// perigos (TocouPerigo pelo mapa de perigos e TocouPerigoIndice s pelo ndice) e a foto de cada passo pra voltar no tempo (GuardarPasso) nas fases do jogo (ou de um pacote) e em fases sintticas de 100 a 10k colisores.
+// Com --json escreve o resultado em JSON (pra guardar e comparar entre verses).
+// Uso: bench_funcoes [--json] [amostras] [pacote|-]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "../simulacao.h"
+#include "../fases.h"
+#include "../pacote.h"
+#include "../rebobinar.h"
+
+#define NUM_ESTADOS 1024          // Estados de jogador usados em rodzio pelas medidas
+#define NS_MIN_AMOSTRA 2000000.0  // Cada amostra roda repeties at passar de 2 ms
+#define AMOSTRAS_AQUECIMENTO 3
+
+static volatile float sumidouro; // Evita que o compilador jogue os laos fora
+
+static unsigned int Aleatorio(unsigned int *estado) {
+    unsigned int x = *estado;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *estado = x;
+    return x;
+}
+
+static float AleatorioEntre(unsigned int *estado, float minimo, float maximo) {
+    return minimo + (maximo - minimo) * (Aleatorio(estado) / 4294967295.0f);
+}
+
+// Uma fase pronta pra medir: o mundo carregado e jogadores espalhados por ela
+typedef struct {
+    char nome[32];
+    int colisores;
+    const DadosFase *dados;
+    Mundo mundo;
+    Rebobinador rebobinar;
+    Jogador estados[NUM_ESTADOS];
+} CasoFase;
+
+// Funes medidas: rodam `repeticoes` vezes a operao; preparar (opcional, fora do tempo) roda antes de cada amostra
+typedef void (*FuncaoMedida)(CasoFase *caso, long long repeticoes);
+typedef void (*FuncaoPreparar)(CasoFase *caso);
+
+typedef struct {
+    double mediana;   // ns por chamada
+    double mad;
+    double minimo;
+    long long repeticoes;
+} Medida;
+
+static double Mediana(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    size_t n = v.size();
+    return (n % 2) ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+}
+
+static double RodarAmostra(CasoFase *caso, FuncaoMedida funcao, FuncaoPreparar preparar, long long repeticoes) {
+    if (preparar) preparar(caso);
+    auto inicio = std::chrono::steady_clock::now();
+    funcao(caso, repeticoes);
+    auto fim = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(fim - inicio).count();
+}
+
+static Medida Medir(CasoFase *caso, FuncaoMedida funcao, FuncaoPreparar preparar, int amostras) {
+    // Repeties por amostra: dobra at a amostra durar NS_MIN_AMOSTRA (o relgio fica desprezvel)
+    long long repeticoes = 1;
+    while (RodarAmostra(caso, funcao, preparar, repeticoes) < NS_MIN_AMOSTRA && repeticoes < (1LL << 40)) repeticoes *= 2;
+    for (int i = 0; i < AMOSTRAS_AQUECIMENTO; i++) RodarAmostra(caso, funcao, preparar, repeticoes);
+
+    std::vector<double> tempos(amostras);
+    for (int i = 0; i < amostras; i++) tempos[i] = RodarAmostra(caso, funcao, preparar, repeticoes) / repeticoes;
+    Medida m;
+    m.mediana = Mediana(tempos);
+    std::vector<double> desvios(amostras);
+    for (int i = 0; i < amostras; i++) desvios[i] = fabs(tempos[i] - m.mediana);
+    m.mad = Mediana(desvios);
+    m.minimo = *std::min_element(tempos.begin(), tempos.end());
+    m.repeticoes = repeticoes;
+    return m;
+}
+
+// ---- Operaes medidas ----
+
+static void MedirAtualizarJogador(CasoFase *caso, long long repeticoes) {
+    Mundo *m = &caso->mundo;
+    float soma = 0;
+    for (long long i = 0; i < repeticoes; i++) {
+        Jogador j = caso->estados[i % NUM_ESTADOS];
+        AtualizarJogador(&j, m->plataformasAtuais, m->numPlataformasAtuais, m->plataformasMoveisAtuais, m->numPlataformasMoveisAtuais,
+                         GRAVIDADE, &m->indicePlataformas, &m->indicePlataformasMoveis, m->corpos, NULL);
+        soma += j.posicao.x + j.posicao.y;
+    }
+    sumidouro = soma;
+}
+
+static void MedirColisaoJogadores(CasoFase *caso, long long repeticoes) {
+    float soma = 0;
+    for (long long i = 0; i < repeticoes; i++) {
+        // Pares vizinhos no rodzio; metade deles fica encostada pra exercitar a correo
+        Jogador a = caso->estados[i % NUM_ESTADOS];
+        Jogador b = caso->estados[(i + 1) % NUM_ESTADOS];
+        if (i & 1) b.posicao = (Vector2){ a.posicao.x + 12, a.posicao.y - 5 };
+        ResolverColisaoJogadores(&a, &b);
+        soma += a.posicao.x + b.posicao.y;
+    }
+    sumidouro = soma;
+}
+
+static void MedirCarregarFase(CasoFase *caso, long long repeticoes) {
+    for (long long i = 0; i < repeticoes; i++) CarregarFase(&caso->mundo, caso->dados);
+    sumidouro = caso->mundo.jogadores[0].posicao.x;
+}
+
+// Plataformas voltam pro comeo e metade  ligada, pra que todas as amostras movam as mesmas plataformas
+static void PrepararMoveis(CasoFase *caso) {
+    ReiniciarFase(&caso->mundo);
+    for (int i = 0; i < caso->mundo.numPlataformasMoveisAtuais; i++) caso->mundo.plataformasMoveisAtuais[i].ativa = (i % 2) == 0;
+    AtualizarIndiceMoveis(&caso->mundo); // Acorda as que foram ligadas
+}
+
+static void MedirPlataformasMoveis(CasoFase *caso, long long repeticoes) {
+    for (long long i = 0; i < repeticoes; i++) AtualizarPlataformasMoveis(&caso->mundo);
+    sumidouro = (caso->mundo.numPlataformasMoveisAtuais > 0) ? caso->mundo.plataformasMoveisAtuais[0].retangulo.x : 0;
+}
+
+static void PrepararRebobinar(CasoFase *caso) {
+    ReiniciarFase(&caso->mundo);
+    ComecarRebobinador(&caso->rebobinar, &caso->mundo);
+}
+
+// Um jogador muda a cada passo (como andando) e o contador de passos anda; o resto do estado fica igual
+static void MedirGuardarPasso(CasoFase *caso, long long repeticoes) {
+    Mundo *m = &caso->mundo;
+    for (long long i = 0; i < repeticoes; i++) {
+        m->jogadores[0] = caso->estados[i % NUM_ESTADOS];
+        m->passosFase++;
+        GuardarPasso(&caso->rebobinar, m);
+    }
+    sumidouro = (float)caso->rebobinar.numPassos;
+}
+
+static void PrepararComMapa(CasoFase *caso) {
+    caso->mundo.usarMapaPerigos = true;
+}
+
+static void PrepararSemMapa(CasoFase *caso) {
+    caso->mundo.usarMapaPerigos = false;
+}
+
+static void MedirPerigos(CasoFase *caso, long long repeticoes) {
+    int soma = 0;
+    for (long long i = 0; i < repeticoes; i++) {
+        Rectangle rec = RetanguloJogador(&caso->estados[i % NUM_ESTADOS]);
+        soma += TocouPerigo(&caso->mundo, rec, (i & 1) ? FOGO : AGUA);
+    }
+    sumidouro = (float)soma;
+}
+
+// ---- Fases ----
+
+// Os jogadores medidos ficam espalhados pela fase toda, ento ela fica inteira carregada (sem pedaos)
+static void IniciarMundoInteiro(Mundo *m, const DadosFase fases[], int numFases, int indice) {
+    IniciarMundo(m, fases, numFases, indice);
+    m->carregarFaseInteira = true;
+    CarregarFaseMundo(m, indice);
+}
+
+// Jogadores em posies sorteadas dentro da rea da fase, com velocidades de quem anda e pula
+static void EspalharJogadores(CasoFase *caso, float largura, float altura, unsigned int semente) {
+    for (int i = 0; i < NUM_ESTADOS; i++) {
+        caso->estados[i] = (Jogador){ (i & 1) ? JOGADOR_AGUA : JOGADOR_FOGO,
+                                      { AleatorioEntre(&semente, 10, largura - 10), AleatorioEntre(&semente, 20, altura) },
+                                      { AleatorioEntre(&semente, -4, 4), AleatorioEntre(&semente, -6, 6) }, MAROON, false };
+    }
+}
+
+// Memria de uma fase sinttica (a DadosFase aponta pra c)
+typedef struct {
+    std::vector<Plataforma> plataformas;
+    std::vector<Perigo> perigos;
+    std::vector<Porta> portas;
+    std::vector<Botao> botoes;
+    std::vector<PlataformaMovel> moveis;
+    DadosFase dados;
+    float lado;
+} FaseSintetica;
+
+// Fase quadrada com a mesma densidade das fases do jogo (um colisor a cada 120x120 px):
+// 70% plataformas, 20% perigos, 5% plataformas mveis e 5% botes
+static void MontarFaseSintetica(FaseSintetica *f, int colisores) {
+    unsigned int semente = 777u + colisores;
+    f->lado = sqrtf((float)colisores) * 120.0f;
+    int numMoveis = colisores / 20, numBotoes = colisores / 20, numPerigos = colisores / 5;
+    int numPlataformas = colisores - numMoveis - numBotoes - numPerigos;
+    for (int i = 0; i < numPlataformas; i++)
+        f->plataformas.push_back((Plataforma){ { AleatorioEntre(&semente, 0, f->lado), AleatorioEntre(&semente, 0, f->lado),
+                                                 AleatorioEntre(&semente, 40, 200), 20 } });
+    for (int i = 0; i < numPerigos; i++)
+        f->perigos.push_back((Perigo){ { AleatorioEntre(&semente, 0, f->lado), AleatorioEntre(&semente, 0, f->lado),
+                                         AleatorioEntre(&semente, 40, 150), 20 }, (TipoPerigo)(i % 3), RED });
+    for (int i = 0; i < numMoveis; i++) {
+        Rectangle r = { AleatorioEntre(&semente, 0, f->lado), AleatorioEntre(&semente, 0, f->lado), 100, 20 };
+        // Caminho longo pra continuar andando durante a amostra inteira
+        f->moveis.push_back((PlataformaMovel){ r, { r.x, r.y }, { r.x + 100000, r.y }, false, AleatorioEntre(&semente, 1, 3) });
+    }
+    for (int i = 0; i < numBotoes; i++)
+        f->botoes.push_back((Botao){ { AleatorioEntre(&semente, 0, f->lado), AleatorioEntre(&semente, 0, f->lado), 50, 10 },
+                                     numMoveis > 0 ? i % numMoveis : -1, false, ORANGE });
+    f->portas.push_back((Porta){ { 0, 0, 40, 40 }, JOGADOR_FOGO, RED });
+    f->portas.push_back((Porta){ { 50, 0, 40, 40 }, JOGADOR_AGUA, BLUE });
+
+    DadosFase *d = &f->dados;
+    d->plataformas = f->plataformas.data();
+    d->perigos = f->perigos.data();
+    d->portas = f->portas.data();
+    d->botoes = f->botoes.data();
+    d->plataformasMoveis = f->moveis.data();
+    d->nosLogicos = NULL;
+    d->ligacoes = NULL;
+    d->numNosLogicos = 0;
+    d->numLigacoes = 0;
+    d->caminhos = NULL;
+    d->pontosCaminho = NULL;
+    d->numCaminhos = 0;
+    d->numPontosCaminho = 0;
+    d->numPlataformas = (int)f->plataformas.size();
+    d->numPerigos = (int)f->perigos.size();
+    d->numPortas = (int)f->portas.size();
+    d->numBotoes = (int)f->botoes.size();
+    d->numPlataformasMoveis = (int)f->moveis.size();
+    d->posInicialFogo = (Vector2){ f->lado / 2, 20 };
+    d->posInicialAgua = (Vector2){ f->lado / 2 + 30, 20 };
+    d->temDiamante = false;
+    d->diamante = (Rectangle){ 0, 0, 0, 0 };
+    d->tempoPar = 0;
+    d->pronta = NULL;
+}
+
+static int ContarColisores(const DadosFase *d) {
+    return d->numPlataformas + d->numPerigos + d->numPortas + d->numBotoes + d->numPlataformasMoveis;
+}
+
+typedef struct {
+    const char *nome;
+    FuncaoMedida funcao;
+    FuncaoPreparar preparar;
+} Operacao;
+
+static const Operacao operacoes[] = {
+    { "AtualizarJogador", MedirAtualizarJogador, NULL },
+    { "ResolverColisaoJogadores", MedirColisaoJogadores, NULL },
+    { "CarregarFase", MedirCarregarFase, NULL },
+    { "AtualizarPlataformasMoveis", MedirPlataformasMoveis, PrepararMoveis },
+    { "TocouPerigo", MedirPerigos, PrepararComMapa },
+    { "TocouPerigoIndice", MedirPerigos, PrepararSemMapa },
+    { "GuardarPasso", MedirGuardarPasso, PrepararRebobinar },
+};
+#define NUM_OPERACOES (int)(sizeof(operacoes) / sizeof(operacoes[0]))
+
+int main(int argc, char **argv) {
+    bool json = false;
+    int amostras = 15;
+    const char *caminhoPacote = NULL;
+    int posicional = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) json = true;
+        else if (posicional++ == 0) amostras = atoi(argv[i]);
+        else if (strcmp(argv[i], "-") != 0) caminhoPacote = argv[i];
+    }
+    if (amostras < 3) {
+        fprintf(stderr, "Uso: %s [--json] [amostras (>= 3)] [pacote|-]\n", argv[0]);
+        return 1;
+    }
+
+    DadosFase dadosPadrao[MAX_FASES];
+    const DadosFase *fases = dadosPadrao;
+    int numFases = MontarDadosFasesPadrao(dadosPadrao);
+    PacoteFases pacote = {0};
+    if (caminhoPacote != NULL) {
+        if (!AbrirPacote(&pacote, caminhoPacote)) return 1;
+        fases = pacote.fases;
+        numFases = pacote.numFases;
+    }
+
+    // Fases do jogo e sintticas
+    const int tamanhosSinteticos[] = { 100, 1000, 10000 };
+    const int numSinteticas = (int)(sizeof(tamanhosSinteticos) / sizeof(tamanhosSinteticos[0]));
+    std::vector<FaseSintetica> sinteticas(numSinteticas);
+    std::vector<CasoFase *> casos;
+    for (int f = 0; f < numFases; f++) {
+        CasoFase *caso = new CasoFase;
+        snprintf(caso->nome, sizeof(caso->nome), "fase%d", f + 1);
+        caso->dados = &fases[f];
+        caso->colisores = ContarColisores(caso->dados);
+        IniciarMundoInteiro(&caso->mundo, fases, numFases, f);
+        IniciarRebobinador(&caso->rebobinar, 10 * TAXA_PASSOS, 8 * 1024 * 1024);
+        EspalharJogadores(caso, LARGURA_TELA, ALTURA_TELA, 4242u + f);
+        casos.push_back(caso);
+    }
+    for (int s = 0; s < numSinteticas; s++) {
+        MontarFaseSintetica(&sinteticas[s], tamanhosSinteticos[s]);
+        CasoFase *caso = new CasoFase;
+        snprintf(caso->nome, sizeof(caso->nome), "sintetica%d", tamanhosSinteticos[s]);
+        caso->dados = &sinteticas[s].dados;
+        caso->colisores = ContarColisores(caso->dados);
+        IniciarMundoInteiro(&caso->mundo, caso->dados, 1, 0);
+        IniciarRebobinador(&caso->rebobinar, 10 * TAXA_PASSOS, 8 * 1024 * 1024);
+        EspalharJogadores(caso, sinteticas[s].lado, sinteticas[s].lado, 4242u + tamanhosSinteticos[s]);
+        casos.push_back(caso);
+    }
+
+    if (json) printf("{\n  \"amostras\": %d,\n  \"unidade\": \"ns por chamada\",\n  \"resultados\": [\n", amostras);
+    else printf("%-28s %-16s %9s %12s %10s %7s %12s\n", "funcao", "fase", "colisores", "mediana(ns)", "mad(ns)", "mad%", "min(ns)");
+
+    bool primeiro = true;
+    for (int o = 0; o < NUM_OPERACOES; o++) {
+        for (size_t c = 0; c < casos.size(); c++) {
+            CasoFase *caso = casos[c];
+            Medida m = Medir(caso, operacoes[o].funcao, operacoes[o].preparar, amostras);
+            ReiniciarFase(&caso->mundo);
+            if (json) {
+                printf("%s    { \"funcao\": \"%s\", \"fase\": \"%s\", \"colisores\": %d, \"mediana_ns\": %.3f, \"mad_ns\": %.3f, "
+                       "\"min_ns\": %.3f, \"repeticoes\": %lld }", primeiro ? "" : ",\n", operacoes[o].nome, caso->nome,
+                       caso->colisores, m.mediana, m.mad, m.minimo, m.repeticoes);
+                primeiro = false;
+            } else {
+                printf("%-28s %-16s %9d %12.1f %10.2f %6.1f%% %12.1f\n", operacoes[o].nome, caso->nome, caso->colisores, m.mediana,
+                       m.mad, m.mediana > 0 ? 100.0 * m.mad / m.mediana : 0.0, m.minimo);
+            }
+            fflush(stdout);
+        }
+    }
+    if (json) printf("\n  ]\n}\n");
+
+    for (size_t c = 0; c < casos.size(); c++) {
+        LiberarMundo(&casos[c]->mundo);
+        LiberarRebobinador(&casos[c]->rebobinar);
+        delete casos[c];
+    }
+    FecharPacote(&pacote);
+    return 0;
+}
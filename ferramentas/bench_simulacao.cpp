@@ -0,0 +1,107 @@
+// Benchmark sem janela: roda milhes de passos em cada fase e mostra passos por segundo.
+// Uso: bench_simulacao [passos por fase] [pacote de fases] [jogadores]   (sem pacote ou com '-' usa as fases padro)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include "../simulacao.h"
+#include "../fases.h"
+#include "../pacote.h"
+
+// Gerador simples e determinstico pras entradas (xorshift32)
+static unsigned int Aleatorio(unsigned int *estado) {
+    unsigned int x = *estado;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *estado = x;
+    return x;
+}
+
+// Sorteia as teclas dos dois jogadores
+static Entradas SortearEntradas(unsigned int *semente) {
+    unsigned int bits = Aleatorio(semente);
+    Entradas e;
+    e.fogo = (EntradaJogador){ (bits & 1) != 0, (bits & 2) != 0, (bits & 4) != 0 };
+    e.agua = (EntradaJogador){ (bits & 8) != 0, (bits & 16) != 0, (bits & 32) != 0 };
+    return e;
+}
+
+// Jogadores alm dos dois primeiros sorteiam do prprio gerador, ento os dois primeiros jogam igual com qualquer nmero
+static EntradaJogador SortearEntradaExtra(unsigned int *semente) {
+    unsigned int bits = Aleatorio(semente);
+    return (EntradaJogador){ (bits & 1) != 0, (bits & 2) != 0, (bits & 4) != 0 };
+}
+
+int main(int argc, char **argv) {
+    long long passos = 5000000;
+    if (argc > 1) passos = atoll(argv[1]);
+    if (passos <= 0) {
+        fprintf(stderr, "Uso: %s [passos por fase] [pacote de fases] [jogadores]\n", argv[0]);
+        return 1;
+    }
+
+    DadosFase dadosPadrao[MAX_FASES];
+    const DadosFase *fases = dadosPadrao;
+    int numFases = MontarDadosFasesPadrao(dadosPadrao);
+    PacoteFases pacote = {0};
+    if (argc > 2 && strcmp(argv[2], "-") != 0) {
+        auto inicio = std::chrono::steady_clock::now();
+        if (!AbrirPacote(&pacote, argv[2])) return 1;
+        auto fim = std::chrono::steady_clock::now();
+        fases = pacote.fases;
+        numFases = pacote.numFases;
+        printf("Pacote %s aberto em %.1f us (%d fases)\n", argv[2], std::chrono::duration<double, std::micro>(fim - inicio).count(), numFases);
+    }
+
+    int numJogadores = (argc > 3) ? atoi(argv[3]) : 2;
+    if (numJogadores < 1) numJogadores = 1;
+    EntradaJogador *entradas = (EntradaJogador *)malloc(sizeof(EntradaJogador) * (size_t)(numJogadores > 2 ? numJogadores : 2));
+    if (numJogadores != 2) printf("%d jogadores\n", numJogadores);
+
+    printf("%-6s %12s %10s %14s %8s %8s %8s %12s\n", "fase", "passos", "segundos", "passos/s", "quedas", "mortes", "vitorias", "reinicio ns");
+
+    for (int f = 0; f < numFases; f++) {
+        Mundo mundo;
+        IniciarMundo(&mundo, fases, numFases, f);
+        if (numJogadores != 2) DefinirJogadores(&mundo, numJogadores);
+
+        unsigned int semente = 0x9E3779B9u + f;
+        unsigned int sementeExtra = 0x85EBCA6Bu + f;
+        long long quedas = 0, mortes = 0, vitorias = 0;
+
+        auto inicio = std::chrono::steady_clock::now();
+        for (long long i = 0; i < passos; i++) {
+            // Troca as teclas a cada 16 passos, parecido com algum jogando
+            if ((i & 15) == 0) {
+                Entradas dois = SortearEntradas(&semente);
+                entradas[0] = dois.fogo;
+                entradas[1] = dois.agua;
+                for (int k = 2; k < numJogadores; k++) entradas[k] = SortearEntradaExtra(&sementeExtra);
+            }
+
+            int resultado = PassoMundoJogadores(&mundo, entradas, numJogadores);
+            if (resultado & PASSO_REINICIOU) quedas++;
+            if (resultado & PASSO_MORTE) mortes++;
+            if (resultado & PASSO_VITORIA) vitorias++;
+            if (mundo.estado != JOGANDO) ReiniciarFase(&mundo);
+        }
+        auto fim = std::chrono::steady_clock::now();
+
+        double segundos = std::chrono::duration<double>(fim - inicio).count();
+
+        // Custo de recomear a fase (o que acontece a cada morte/queda)
+        const int reinicios = 100000;
+        auto inicioReinicio = std::chrono::steady_clock::now();
+        for (int i = 0; i < reinicios; i++) ReiniciarFase(&mundo);
+        auto fimReinicio = std::chrono::steady_clock::now();
+        double nsReinicio = std::chrono::duration<double, std::nano>(fimReinicio - inicioReinicio).count() / reinicios;
+
+        printf("%-6d %12lld %10.3f %14.0f %8lld %8lld %8lld %12.1f\n", f + 1, passos, segundos, passos / segundos, quedas, mortes, vitorias, nsReinicio);
+        LiberarMundo(&mundo);
+    }
+
+    free(entradas);
+    FecharPacote(&pacote);
+    return 0;
+}
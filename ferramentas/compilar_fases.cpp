@@ -0,0 +1,366 @@
+/*
+Compila fases para um header C++ com tudo em constexpr: os itens de cada fase, a DadosFase dela e os dados que
+o CarregarFase montaria ao carregar (AceleracaoFase em simulacao.h): as grades de coliso de plataformas, perigos
+e botes, o mapa de perigos por tipo, as mveis que cada boto alcana e os recursos que a fase usa.
+Compilado junto, o jogo tem as fases em memria s de leitura, sem nada pra montar na partida, e o CarregarFase
+s aponta pros dados prontos (com a fase inteira carregada; fases maiores continuam montando os ndices dos
+pedaos). A simulao d exatamente o mesmo resultado com a fase compilada e com a original.
+Uso: compilar_fases entrada.pack|- saida.h   ('-' usa as fases padro; texto passa antes pelo converter_fases)
+*/
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "../simulacao.h"
+#include "../fases.h"
+#include "../pacote.h"
+#include "../replay.h"
+
+// Real exato: inteiros pequenos em decimal, o resto em hexadecimal (sem perder nenhum bit)
+static void EscreverReal(FILE *s, float v) {
+    if (v == floorf(v) && fabsf(v) < 1e7f) fprintf(s, "%.1ff", v);
+    else fprintf(s, "%af", (double)v);
+}
+
+static void EscreverVetor(FILE *s, Vector2 v) {
+    fprintf(s, "{ ");
+    EscreverReal(s, v.x);
+    fprintf(s, ", ");
+    EscreverReal(s, v.y);
+    fprintf(s, " }");
+}
+
+static void EscreverRetangulo(FILE *s, Rectangle r) {
+    fprintf(s, "{ ");
+    EscreverReal(s, r.x);
+    fprintf(s, ", ");
+    EscreverReal(s, r.y);
+    fprintf(s, ", ");
+    EscreverReal(s, r.width);
+    fprintf(s, ", ");
+    EscreverReal(s, r.height);
+    fprintf(s, " }");
+}
+
+static void EscreverCor(FILE *s, Color c) {
+    fprintf(s, "{ %d, %d, %d, %d }", c.r, c.g, c.b, c.a);
+}
+
+static const char *NomePerigo(TipoPerigo tipo) {
+    if (tipo == FOGO) return "FOGO";
+    if (tipo == AGUA) return "AGUA";
+    return "TERRA";
+}
+
+static const char *NomeLogica(TipoLogica tipo) {
+    if (tipo == LOGICA_OU) return "LOGICA_OU";
+    if (tipo == LOGICA_E) return "LOGICA_E";
+    if (tipo == LOGICA_ALTERNA) return "LOGICA_ALTERNA";
+    return "LOGICA_TEMPO";
+}
+
+static const char *NomePonta(TipoPonta ponta) {
+    if (ponta == PONTA_BOTAO) return "PONTA_BOTAO";
+    if (ponta == PONTA_LOGICA) return "PONTA_LOGICA";
+    return "PONTA_MOVEL";
+}
+
+static const char *NomeCaminho(TipoCaminho tipo) {
+    if (tipo == CAMINHO_LINHA) return "CAMINHO_LINHA";
+    if (tipo == CAMINHO_LACO) return "CAMINHO_LACO";
+    return "CAMINHO_SUAVE";
+}
+
+// Vetor de inteiros (ou bytes) constexpr; vazio no vira vetor (C++ no aceita tamanho zero) e o nome fica nullptr
+static void EscreverInteiros(FILE *s, const char *tipo, const char *nome, const void *dados, size_t tamanho, int n) {
+    if (n <= 0) return;
+    fprintf(s, "static constexpr %s %s[] = {", tipo, nome);
+    for (int i = 0; i < n; i++) {
+        const char *p = (const char *)dados + tamanho * (size_t)i;
+        int v = (tamanho == 1) ? *(const unsigned char *)p : *(const int *)p;
+        fprintf(s, "%s%d,", (i % 24 == 0) ? "\n    " : " ", v);
+    }
+    fprintf(s, "\n};\n");
+}
+
+static const char *NomeOuNulo(char *buffer, size_t tam, const char *prefixo, const char *sufixo, int n) {
+    if (n <= 0) return "nullptr";
+    snprintf(buffer, tam, "%s_%s", prefixo, sufixo);
+    return buffer;
+}
+
+// Grade pronta: os vetores e a GradeColisao que aponta pra eles (const_cast: a simulao s l as grades prontas)
+static void EscreverGrade(FILE *s, const char *prefixo, const char *nome, const GradeColisao *g) {
+    char nomeInicio[96], nomeIds[96], nomeItens[96];
+    int numCelulas = g->colunas * g->linhas;
+    int numIds = g->inicioCelula[numCelulas];
+    snprintf(nomeInicio, sizeof(nomeInicio), "%s_%s_inicio", prefixo, nome);
+    snprintf(nomeIds, sizeof(nomeIds), "%s_%s_ids", prefixo, nome);
+    snprintf(nomeItens, sizeof(nomeItens), "%s_%s_itens", prefixo, nome);
+    EscreverInteiros(s, "int", nomeInicio, g->inicioCelula, sizeof(int), numCelulas + 1);
+    EscreverInteiros(s, "int", nomeIds, g->ids, sizeof(int), numIds);
+    EscreverInteiros(s, "int", nomeItens, g->celulasItem, sizeof(int), g->numItens * 4);
+}
+
+static void EscreverCampoGrade(FILE *s, const char *campo, const char *prefixo, const char *nome, const GradeColisao *g) {
+    int numIds = g->inicioCelula[g->colunas * g->linhas];
+    fprintf(s, "    .%s = { ", campo);
+    EscreverReal(s, g->origemX);
+    fprintf(s, ", ");
+    EscreverReal(s, g->origemY);
+    fprintf(s, ", ");
+    EscreverReal(s, g->tamCelula);
+    fprintf(s, ", %d, %d, %d,\n", g->colunas, g->linhas, g->numItens);
+    fprintf(s, "        const_cast<int *>(%s_%s_inicio), ", prefixo, nome);
+    if (numIds > 0) fprintf(s, "const_cast<int *>(%s_%s_ids), ", prefixo, nome);
+    else fprintf(s, "nullptr, ");
+    if (g->numItens > 0) fprintf(s, "const_cast<int *>(%s_%s_itens), 0, 0, 0 },\n", prefixo, nome);
+    else fprintf(s, "nullptr, 0, 0, 0 },\n");
+}
+
+static void EscreverFase(FILE *s, const DadosFase *f, int numero) {
+    char p[32];
+    snprintf(p, sizeof(p), "fase%d", numero);
+    fprintf(s, "// Fase %d (hash %08x): %d plataformas, %d perigos, %d portas, %d botoes, %d moveis\n", numero, HashFase(f),
+            f->numPlataformas, f->numPerigos, f->numPortas, f->numBotoes, f->numPlataformasMoveis);
+
+    if (f->numPlataformas > 0) {
+        fprintf(s, "static constexpr Plataforma %s_plataformas[] = {\n", p);
+        for (int i = 0; i < f->numPlataformas; i++) {
+            fprintf(s, "    { ");
+            EscreverRetangulo(s, f->plataformas[i].retangulo);
+            fprintf(s, " },\n");
+        }
+        fprintf(s, "};\n");
+    }
+    if (f->numPerigos > 0) {
+        fprintf(s, "static constexpr Perigo %s_perigos[] = {\n", p);
+        for (int i = 0; i < f->numPerigos; i++) {
+            fprintf(s, "    { ");
+            EscreverRetangulo(s, f->perigos[i].retangulo);
+            fprintf(s, ", %s, ", NomePerigo(f->perigos[i].tipo));
+            EscreverCor(s, f->perigos[i].cor);
+            fprintf(s, " },\n");
+        }
+        fprintf(s, "};\n");
+    }
+    if (f->numPortas > 0) {
+        fprintf(s, "static constexpr Porta %s_portas[] = {\n", p);
+        for (int i = 0; i < f->numPortas; i++) {
+            fprintf(s, "    { ");
+            EscreverRetangulo(s, f->portas[i].retangulo);
+            fprintf(s, ", %s, ", (f->portas[i].tipoJogador == JOGADOR_FOGO) ? "JOGADOR_FOGO" : "JOGADOR_AGUA");
+            EscreverCor(s, f->portas[i].cor);
+            fprintf(s, " },\n");
+        }
+        fprintf(s, "};\n");
+    }
+    if (f->numBotoes > 0) {
+        fprintf(s, "static constexpr Botao %s_botoes[] = {\n", p);
+        for (int i = 0; i < f->numBotoes; i++) {
+            fprintf(s, "    { ");
+            EscreverRetangulo(s, f->botoes[i].retangulo);
+            fprintf(s, ", %d, %s, ", f->botoes[i].idAlvo, f->botoes[i].pressionado ? "true" : "false");
+            EscreverCor(s, f->botoes[i].cor);
+            fprintf(s, " },\n");
+        }
+        fprintf(s, "};\n");
+    }
+    if (f->numPlataformasMoveis > 0) {
+        fprintf(s, "static constexpr PlataformaMovel %s_moveis[] = {\n", p);
+        for (int i = 0; i < f->numPlataformasMoveis; i++) {
+            const PlataformaMovel *m = &f->plataformasMoveis[i];
+            fprintf(s, "    { ");
+            EscreverRetangulo(s, m->retangulo);
+            fprintf(s, ", ");
+            EscreverVetor(s, m->posInicial);
+            fprintf(s, ", ");
+            EscreverVetor(s, m->posFinal);
+            fprintf(s, ", %s, ", m->ativa ? "true" : "false");
+            EscreverReal(s, m->velocidade);
+            fprintf(s, " },\n");
+        }
+        fprintf(s, "};\n");
+    }
+    if (f->numNosLogicos > 0) {
+        fprintf(s, "static constexpr NoLogico %s_nosLogicos[] = {\n", p);
+        for (int i = 0; i < f->numNosLogicos; i++)
+            fprintf(s, "    { %s, %d },\n", NomeLogica(f->nosLogicos[i].tipo), f->nosLogicos[i].passos);
+        fprintf(s, "};\n");
+    }
+    if (f->numLigacoes > 0) {
+        fprintf(s, "static constexpr Ligacao %s_ligacoes[] = {\n", p);
+        for (int i = 0; i < f->numLigacoes; i++) {
+            const Ligacao *l = &f->ligacoes[i];
+            fprintf(s, "    { %s, %d, %s, %d },\n", NomePonta(l->tipoOrigem), l->origem, NomePonta(l->tipoDestino), l->destino);
+        }
+        fprintf(s, "};\n");
+    }
+    if (f->numCaminhos > 0) {
+        fprintf(s, "static constexpr CaminhoMovel %s_caminhos[] = {\n", p);
+        for (int i = 0; i < f->numCaminhos; i++) {
+            const CaminhoMovel *c = &f->caminhos[i];
+            fprintf(s, "    { %d, %s, %d, %d, %s },\n", c->movel, NomeCaminho(c->tipo), c->primeiroPonto, c->numPontos,
+                    c->sempreAtiva ? "true" : "false");
+        }
+        fprintf(s, "};\n");
+    }
+    if (f->numPontosCaminho > 0) {
+        fprintf(s, "static constexpr Vector2 %s_pontos[] = {\n", p);
+        for (int i = 0; i < f->numPontosCaminho; i++) {
+            fprintf(s, "    ");
+            EscreverVetor(s, f->pontosCaminho[i]);
+            fprintf(s, ",\n");
+        }
+        fprintf(s, "};\n");
+    }
+
+    // O que o CarregarFase montaria: as mesmas funes, s que aqui
+    GradeColisao grades[3] = { {0}, {0}, {0} };
+    ConstruirGrade(&grades[0], f->numPlataformas > 0 ? &f->plataformas[0].retangulo : NULL, sizeof(Plataforma), f->numPlataformas, TAM_CELULA_GRADE);
+    ConstruirGrade(&grades[1], f->numPerigos > 0 ? &f->perigos[0].retangulo : NULL, sizeof(Perigo), f->numPerigos, TAM_CELULA_GRADE);
+    ConstruirGrade(&grades[2], f->numBotoes > 0 ? &f->botoes[0].retangulo : NULL, sizeof(Botao), f->numBotoes, TAM_CELULA_GRADE);
+    const char *nomesGrades[3] = { "gradePlataformas", "gradePerigos", "gradeBotoes" };
+    for (int k = 0; k < 3; k++) EscreverGrade(s, p, nomesGrades[k], &grades[k]);
+
+    GradeOcupacao mapa = {0};
+    MontarMapaPerigos(&mapa, f);
+    char nome[96];
+    snprintf(nome, sizeof(nome), "%s_mapaPerigos", p);
+    EscreverInteiros(s, "unsigned char", nome, mapa.celulas, 1, mapa.colunas * mapa.linhas);
+
+    GrafoGatilhos g = {0};
+    MontarGatilhos(&g, f->numBotoes > 0 ? &f->botoes[0].idAlvo : NULL, sizeof(Botao), f->numBotoes, f->numPlataformasMoveis,
+                   f->nosLogicos, f->numNosLogicos, f->ligacoes, f->numLigacoes, NULL, NULL);
+    int numAlcance = g.inicioAlcance[f->numBotoes];
+    snprintf(nome, sizeof(nome), "%s_inicioAlcance", p);
+    EscreverInteiros(s, "int", nome, g.inicioAlcance, sizeof(int), f->numBotoes + 1);
+    snprintf(nome, sizeof(nome), "%s_alcance", p);
+    EscreverInteiros(s, "int", nome, g.alcance, sizeof(int), numAlcance);
+
+    fprintf(s, "static constexpr AceleracaoFase %s_pronta = {\n", p);
+    fprintf(s, "    .recursos = 0x%x,\n", RecursosDaFase(f));
+    fprintf(s, "    .mapaPerigos = { ");
+    EscreverReal(s, mapa.origemX);
+    fprintf(s, ", ");
+    EscreverReal(s, mapa.origemY);
+    fprintf(s, ", ");
+    EscreverReal(s, mapa.tamCelula);
+    fprintf(s, ", ");
+    EscreverReal(s, mapa.inversoCelula);
+    if (mapa.colunas * mapa.linhas > 0)
+        fprintf(s, ", %d, %d, const_cast<unsigned char *>(%s_mapaPerigos), 0 },\n", mapa.colunas, mapa.linhas, p);
+    else
+        fprintf(s, ", 0, 0, nullptr, 0 },\n");
+    for (int k = 0; k < 3; k++) EscreverCampoGrade(s, nomesGrades[k], p, nomesGrades[k], &grades[k]);
+    char b1[96], b2[96];
+    fprintf(s, "    .inicioAlcance = %s,\n", NomeOuNulo(b1, sizeof(b1), p, "inicioAlcance", f->numBotoes + 1));
+    fprintf(s, "    .alcance = %s\n};\n", NomeOuNulo(b2, sizeof(b2), p, "alcance", numAlcance));
+
+    for (int k = 0; k < 3; k++) LiberarGrade(&grades[k]);
+    LiberarOcupacao(&mapa);
+    LiberarGatilhos(&g);
+}
+
+static void EscreverDados(FILE *s, const DadosFase *f, int numero) {
+    char p[32], b[96];
+    snprintf(p, sizeof(p), "fase%d", numero);
+    fprintf(s, "    {\n");
+    fprintf(s, "        .plataformas = %s,\n", NomeOuNulo(b, sizeof(b), p, "plataformas", f->numPlataformas));
+    fprintf(s, "        .perigos = %s,\n", NomeOuNulo(b, sizeof(b), p, "perigos", f->numPerigos));
+    fprintf(s, "        .portas = %s,\n", NomeOuNulo(b, sizeof(b), p, "portas", f->numPortas));
+    fprintf(s, "        .botoes = %s,\n", NomeOuNulo(b, sizeof(b), p, "botoes", f->numBotoes));
+    fprintf(s, "        .plataformasMoveis = %s,\n", NomeOuNulo(b, sizeof(b), p, "moveis", f->numPlataformasMoveis));
+    fprintf(s, "        .nosLogicos = %s,\n", NomeOuNulo(b, sizeof(b), p, "nosLogicos", f->numNosLogicos));
+    fprintf(s, "        .ligacoes = %s,\n", NomeOuNulo(b, sizeof(b), p, "ligacoes", f->numLigacoes));
+    fprintf(s, "        .caminhos = %s,\n", NomeOuNulo(b, sizeof(b), p, "caminhos", f->numCaminhos));
+    fprintf(s, "        .pontosCaminho = %s,\n", NomeOuNulo(b, sizeof(b), p, "pontos", f->numPontosCaminho));
+    fprintf(s, "        .numPlataformas = %d, .numPerigos = %d, .numPortas = %d, .numBotoes = %d, .numPlataformasMoveis = %d,\n",
+            f->numPlataformas, f->numPerigos, f->numPortas, f->numBotoes, f->numPlataformasMoveis);
+    fprintf(s, "        .numNosLogicos = %d, .numLigacoes = %d, .numCaminhos = %d, .numPontosCaminho = %d,\n",
+            f->numNosLogicos, f->numLigacoes, f->numCaminhos, f->numPontosCaminho);
+    fprintf(s, "        .posInicialFogo = ");
+    EscreverVetor(s, f->posInicialFogo);
+    fprintf(s, ",\n        .posInicialAgua = ");
+    EscreverVetor(s, f->posInicialAgua);
+    fprintf(s, ",\n        .temDiamante = %s,\n        .diamante = ", f->temDiamante ? "true" : "false");
+    EscreverRetangulo(s, f->diamante);
+    fprintf(s, ",\n        .tempoPar = ");
+    EscreverReal(s, f->tempoPar);
+    fprintf(s, ",\n        .pronta = &%s_pronta\n    },\n", p);
+}
+
+// true se os dois arquivos existem e tm os mesmos bytes
+static bool MesmoConteudo(const char *caminhoA, const char *caminhoB) {
+    FILE *a = fopen(caminhoA, "rb");
+    FILE *b = fopen(caminhoB, "rb");
+    bool igual = a != NULL && b != NULL;
+    while (igual) {
+        char blocoA[4096], blocoB[4096];
+        size_t lidosA = fread(blocoA, 1, sizeof(blocoA), a);
+        size_t lidosB = fread(blocoB, 1, sizeof(blocoB), b);
+        if (lidosA != lidosB || memcmp(blocoA, blocoB, lidosA) != 0) igual = false;
+        else if (lidosA == 0) break;
+    }
+    if (a != NULL) fclose(a);
+    if (b != NULL) fclose(b);
+    return igual;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "Uso: %s entrada.pack|- saida.h\n", argv[0]);
+        return 1;
+    }
+    DadosFase dadosPadrao[MAX_FASES];
+    const DadosFase *fases = dadosPadrao;
+    int numFases = MontarDadosFasesPadrao(dadosPadrao);
+    PacoteFases pacote = {0};
+    if (strcmp(argv[1], "-") != 0) {
+        if (!AbrirPacote(&pacote, argv[1])) return 1;
+        fases = pacote.fases;
+        numFases = pacote.numFases;
+    }
+    if (numFases < 1) {
+        fprintf(stderr, "%s nao tem fases\n", argv[1]);
+        FecharPacote(&pacote);
+        return 1;
+    }
+
+    // Escreve num temporrio e s troca o header se mudou: com a mesma data o make no recompila o jogo
+    char temporario[1024];
+    snprintf(temporario, sizeof(temporario), "%s.tmp", argv[2]);
+    FILE *saida = fopen(temporario, "w");
+    if (saida == NULL) {
+        fprintf(stderr, "Nao foi possivel criar %s\n", temporario);
+        FecharPacote(&pacote);
+        return 1;
+    }
+    fprintf(saida, "// Gerado pelo compilar_fases a partir de %s. Nao editar: mude as fases e compile de novo.\n",
+            strcmp(argv[1], "-") == 0 ? "fases.cpp" : argv[1]);
+    fprintf(saida, "#ifndef FASES_COMPILADAS_H\n#define FASES_COMPILADAS_H\n\n#include \"simulacao.h\"\n\n");
+    for (int i = 0; i < numFases; i++) {
+        EscreverFase(saida, &fases[i], i + 1);
+        fprintf(saida, "\n");
+    }
+    fprintf(saida, "#define NUM_FASES_COMPILADAS %d\n\n", numFases);
+    fprintf(saida, "static constexpr DadosFase fasesCompiladas[NUM_FASES_COMPILADAS] = {\n");
+    for (int i = 0; i < numFases; i++) EscreverDados(saida, &fases[i], i + 1);
+    fprintf(saida, "};\n\n#endif\n");
+    bool ok = ferror(saida) == 0;
+    ok = (fclose(saida) == 0) && ok;
+    bool mudou = true;
+    if (ok && MesmoConteudo(temporario, argv[2])) {
+        mudou = false;
+        remove(temporario);
+    } else if (ok && rename(temporario, argv[2]) != 0) {
+        fprintf(stderr, "Nao foi possivel trocar %s\n", argv[2]);
+        ok = false;
+    }
+    if (!ok) remove(temporario);
+
+    for (int i = 0; i < numFases; i++)
+        printf("Fase %d: hash %08x, recursos 0x%x\n", i + 1, HashFase(&fases[i]), RecursosDaFase(&fases[i]));
+    if (ok) printf("%d fases compiladas em %s%s\n", numFases, argv[2], mudou ? "" : " (sem mudancas)");
+    FecharPacote(&pacote);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,243 @@
+/*
+Converte fases em texto para um pacote binrio (pacote.h).
+Uso: converter_fases entrada.txt saida.pack
+
+Formato do texto (uma coisa por linha, # comea comentrio, cores r g b a so opcionais):
+    fase
+    inicio_fogo x y
+    inicio_agua x y
+    diamante x y w h
+    par segundos                (tempo par, ver resolver_fases; sem ele as estrelas usam 20 s e 40 s)
+    plataforma x y w h
+    perigo x y w h FOGO|AGUA|TERRA [r g b a]
+    porta x y w h FOGO|AGUA [r g b a]
+    botao x y w h idAlvo [r g b a]   (idAlvo -1 = o boto s liga pelo que tiver em 'liga')
+    movel x y w h xInicial yInicial xFinal yFinal velocidade
+    logica OU|E|ALTERNA|TEMPO [passos]
+    liga botao|logica id logica|movel id
+    caminho idMovel LINHA|LACO|SUAVE [sempre] x y x y ...   (pontos do canto da mvel; 'sempre' anda sem boto)
+    fim
+Botes, mveis e ns lgicos so numerados a partir de 0, na ordem em que aparecem (ver gatilhos.h).
+Mvel com caminho usa do 'movel' s o tamanho e a velocidade (ver cinematica.h).
+*/
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "../simulacao.h"
+#include "../pacote.h"
+
+// Fase sendo lida (os vetores crescem  vontade, sem os MAX_* da struct Fase)
+typedef struct {
+    std::vector<Plataforma> plataformas;
+    std::vector<Perigo> perigos;
+    std::vector<Porta> portas;
+    std::vector<Botao> botoes;
+    std::vector<PlataformaMovel> plataformasMoveis;
+    std::vector<NoLogico> nosLogicos;
+    std::vector<Ligacao> ligacoes;
+    std::vector<CaminhoMovel> caminhos;
+    std::vector<Vector2> pontosCaminho;
+    Vector2 posInicialFogo;
+    Vector2 posInicialAgua;
+    bool temDiamante;
+    Rectangle diamante;
+    float tempoPar;
+} FaseTexto;
+
+// L "r g b a" do resto da linha; se no tiver, usa a cor padro
+static Color LerCor(const char *resto, Color padrao) {
+    int r, g, b, a;
+    if (resto != NULL && sscanf(resto, "%d %d %d %d", &r, &g, &b, &a) == 4)
+        return (Color){ (unsigned char)r, (unsigned char)g, (unsigned char)b, (unsigned char)a };
+    return padrao;
+}
+
+// "botao", "logica" ou "movel"; devolve false se no for nenhum
+static bool LerPonta(const char *nome, TipoPonta *ponta) {
+    if (strcmp(nome, "botao") == 0) *ponta = PONTA_BOTAO;
+    else if (strcmp(nome, "logica") == 0) *ponta = PONTA_LOGICA;
+    else if (strcmp(nome, "movel") == 0) *ponta = PONTA_MOVEL;
+    else return false;
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "Uso: %s entrada.txt saida.pack\n", argv[0]);
+        return 1;
+    }
+    FILE *entrada = fopen(argv[1], "r");
+    if (entrada == NULL) {
+        fprintf(stderr, "Nao foi possivel abrir %s\n", argv[1]);
+        return 1;
+    }
+
+    std::vector<FaseTexto> fases;
+    FaseTexto *atual = NULL;
+    char linha[512];
+    int numLinha = 0;
+    bool ok = true;
+
+    while (ok && fgets(linha, sizeof(linha), entrada)) {
+        numLinha++;
+        char *comentario = strchr(linha, '#');
+        if (comentario) *comentario = '\0';
+
+        char comando[32];
+        int lidos = 0;
+        if (sscanf(linha, "%31s%n", comando, &lidos) != 1) continue; // Linha vazia
+        const char *args = linha + lidos;
+
+        if (strcmp(comando, "fase") == 0) {
+            fases.push_back(FaseTexto());
+            atual = &fases.back();
+            atual->posInicialFogo = (Vector2){ 0, 0 };
+            atual->posInicialAgua = (Vector2){ 0, 0 };
+            atual->temDiamante = false;
+            atual->diamante = (Rectangle){ 0, 0, 0, 0 };
+            atual->tempoPar = 0;
+            continue;
+        }
+        if (atual == NULL) {
+            fprintf(stderr, "%s:%d: '%s' fora de uma fase\n", argv[1], numLinha, comando);
+            ok = false;
+            break;
+        }
+
+        Rectangle r;
+        char tipo[16];
+        int n = 0;
+        if (strcmp(comando, "fim") == 0) {
+            atual = NULL;
+        } else if (strcmp(comando, "inicio_fogo") == 0 && sscanf(args, "%f %f", &atual->posInicialFogo.x, &atual->posInicialFogo.y) == 2) {
+        } else if (strcmp(comando, "inicio_agua") == 0 && sscanf(args, "%f %f", &atual->posInicialAgua.x, &atual->posInicialAgua.y) == 2) {
+        } else if (strcmp(comando, "diamante") == 0 && sscanf(args, "%f %f %f %f", &r.x, &r.y, &r.width, &r.height) == 4) {
+            atual->temDiamante = true;
+            atual->diamante = r;
+        } else if (strcmp(comando, "par") == 0 && sscanf(args, "%f", &atual->tempoPar) == 1) {
+        } else if (strcmp(comando, "plataforma") == 0 && sscanf(args, "%f %f %f %f", &r.x, &r.y, &r.width, &r.height) == 4) {
+            atual->plataformas.push_back((Plataforma){ r });
+        } else if (strcmp(comando, "perigo") == 0 && sscanf(args, "%f %f %f %f %15s%n", &r.x, &r.y, &r.width, &r.height, tipo, &n) == 5 &&
+                   (strcmp(tipo, "FOGO") == 0 || strcmp(tipo, "AGUA") == 0 || strcmp(tipo, "TERRA") == 0)) {
+            TipoPerigo t = (strcmp(tipo, "FOGO") == 0) ? FOGO : (strcmp(tipo, "AGUA") == 0) ? AGUA : TERRA;
+            Color padrao = (t == FOGO) ? RED : (t == AGUA) ? SKYBLUE : GREEN;
+            atual->perigos.push_back((Perigo){ r, t, LerCor(args + n, padrao) });
+        } else if (strcmp(comando, "porta") == 0 && sscanf(args, "%f %f %f %f %15s%n", &r.x, &r.y, &r.width, &r.height, tipo, &n) == 5 &&
+                   (strcmp(tipo, "FOGO") == 0 || strcmp(tipo, "AGUA") == 0)) {
+            TipoJogador t = (strcmp(tipo, "FOGO") == 0) ? JOGADOR_FOGO : JOGADOR_AGUA;
+            Color padrao = (t == JOGADOR_FOGO) ? (Color){255,100,100,255} : (Color){100,100,255,255};
+            atual->portas.push_back((Porta){ r, t, LerCor(args + n, padrao) });
+        } else if (strcmp(comando, "botao") == 0) {
+            int idAlvo;
+            if (sscanf(args, "%f %f %f %f %d%n", &r.x, &r.y, &r.width, &r.height, &idAlvo, &n) != 5) {
+                fprintf(stderr, "%s:%d: botao precisa de x y w h idAlvo\n", argv[1], numLinha);
+                ok = false;
+                break;
+            }
+            atual->botoes.push_back((Botao){ r, idAlvo, false, LerCor(args + n, ORANGE) });
+        } else if (strcmp(comando, "movel") == 0) {
+            PlataformaMovel p = { { 0, 0, 0, 0 }, { 0, 0 }, { 0, 0 }, false, 0 };
+            if (sscanf(args, "%f %f %f %f %f %f %f %f %f", &p.retangulo.x, &p.retangulo.y, &p.retangulo.width, &p.retangulo.height,
+                       &p.posInicial.x, &p.posInicial.y, &p.posFinal.x, &p.posFinal.y, &p.velocidade) != 9) {
+                fprintf(stderr, "%s:%d: movel precisa de x y w h xIni yIni xFim yFim velocidade\n", argv[1], numLinha);
+                ok = false;
+                break;
+            }
+            atual->plataformasMoveis.push_back(p);
+        } else if (strcmp(comando, "logica") == 0) {
+            NoLogico no = { LOGICA_OU, 0 };
+            if (sscanf(args, "%15s %d", tipo, &no.passos) < 1 || (strcmp(tipo, "OU") != 0 && strcmp(tipo, "E") != 0 &&
+                                                               strcmp(tipo, "ALTERNA") != 0 && strcmp(tipo, "TEMPO") != 0)) {
+                fprintf(stderr, "%s:%d: logica precisa de OU|E|ALTERNA|TEMPO [passos]\n", argv[1], numLinha);
+                ok = false;
+                break;
+            }
+            no.tipo = (strcmp(tipo, "OU") == 0) ? LOGICA_OU : (strcmp(tipo, "E") == 0) ? LOGICA_E :
+                      (strcmp(tipo, "ALTERNA") == 0) ? LOGICA_ALTERNA : LOGICA_TEMPO;
+            atual->nosLogicos.push_back(no);
+        } else if (strcmp(comando, "liga") == 0) {
+            char de[16], para[16];
+            Ligacao l;
+            if (sscanf(args, "%15s %d %15s %d", de, &l.origem, para, &l.destino) != 4 || !LerPonta(de, &l.tipoOrigem) ||
+                !LerPonta(para, &l.tipoDestino) || l.tipoOrigem == PONTA_MOVEL || l.tipoDestino == PONTA_BOTAO) {
+                fprintf(stderr, "%s:%d: liga precisa de botao|logica id logica|movel id\n", argv[1], numLinha);
+                ok = false;
+                break;
+            }
+            atual->ligacoes.push_back(l);
+        } else if (strcmp(comando, "caminho") == 0) {
+            CaminhoMovel c = { 0, CAMINHO_LINHA, (int)atual->pontosCaminho.size(), 0, false };
+            bool valido = sscanf(args, "%d %15s%n", &c.movel, tipo, &n) == 2 &&
+                          (strcmp(tipo, "LINHA") == 0 || strcmp(tipo, "LACO") == 0 || strcmp(tipo, "SUAVE") == 0);
+            if (valido) {
+                c.tipo = (strcmp(tipo, "LINHA") == 0) ? CAMINHO_LINHA : (strcmp(tipo, "LACO") == 0) ? CAMINHO_LACO : CAMINHO_SUAVE;
+                const char *resto = args + n;
+                int k = 0;
+                char palavra[16];
+                if (sscanf(resto, "%15s%n", palavra, &k) == 1 && strcmp(palavra, "sempre") == 0) {
+                    c.sempreAtiva = true;
+                    resto += k;
+                }
+                Vector2 ponto;
+                while (sscanf(resto, "%f %f%n", &ponto.x, &ponto.y, &k) == 2) {
+                    atual->pontosCaminho.push_back(ponto);
+                    c.numPontos++;
+                    resto += k;
+                }
+                valido = c.numPontos > 0 && sscanf(resto, "%15s", palavra) != 1; // Sobrou algo que no  ponto
+            }
+            if (!valido) {
+                fprintf(stderr, "%s:%d: caminho precisa de idMovel LINHA|LACO|SUAVE [sempre] x y [x y ...]\n", argv[1], numLinha);
+                ok = false;
+                break;
+            }
+            atual->caminhos.push_back(c);
+        } else {
+            fprintf(stderr, "%s:%d: linha invalida: %s\n", argv[1], numLinha, comando);
+            ok = false;
+        }
+    }
+    fclose(entrada);
+
+    if (ok && atual != NULL) {
+        fprintf(stderr, "%s: faltou 'fim' na ultima fase\n", argv[1]);
+        ok = false;
+    }
+    if (!ok) return 1;
+
+    // Vises das fases lidas, pra gravar igual s do jogo
+    std::vector<DadosFase> dados(fases.size());
+    for (size_t i = 0; i < fases.size(); i++) {
+        FaseTexto *f = &fases[i];
+        DadosFase *d = &dados[i];
+        d->plataformas = f->plataformas.data();
+        d->perigos = f->perigos.data();
+        d->portas = f->portas.data();
+        d->botoes = f->botoes.data();
+        d->plataformasMoveis = f->plataformasMoveis.data();
+        d->nosLogicos = f->nosLogicos.data();
+        d->ligacoes = f->ligacoes.data();
+        d->caminhos = f->caminhos.data();
+        d->pontosCaminho = f->pontosCaminho.data();
+        d->numPlataformas = (int)f->plataformas.size();
+        d->numPerigos = (int)f->perigos.size();
+        d->numPortas = (int)f->portas.size();
+        d->numBotoes = (int)f->botoes.size();
+        d->numPlataformasMoveis = (int)f->plataformasMoveis.size();
+        d->numNosLogicos = (int)f->nosLogicos.size();
+        d->numLigacoes = (int)f->ligacoes.size();
+        d->numCaminhos = (int)f->caminhos.size();
+        d->numPontosCaminho = (int)f->pontosCaminho.size();
+        d->posInicialFogo = f->posInicialFogo;
+        d->posInicialAgua = f->posInicialAgua;
+        d->temDiamante = f->temDiamante;
+        d->diamante = f->diamante;
+        d->tempoPar = f->tempoPar;
+        d->pronta = NULL;
+        if (d->numPortas < 2) printf("Aviso: fase %d tem menos de 2 portas e nao pode ser vencida\n", (int)i + 1);
+    }
+
+    if (!SalvarPacote(argv[2], dados.data(), (int)dados.size())) return 1;
+    printf("%d fases gravadas em %s\n", (int)dados.size(), argv[2]);
+    return 0;
+}
@@ -0,0 +1,117 @@
+// Exporta as fases que vm no cdigo para o formato texto do converter_fases.
+// Uso: exportar_fases [saida.txt]   (sem arquivo escreve na tela)
+#include <stdio.h>
+#include "../simulacao.h"
+#include "../fases.h"
+
+static const char *NomePerigo(TipoPerigo tipo) {
+    if (tipo == FOGO) return "FOGO";
+    if (tipo == AGUA) return "AGUA";
+    return "TERRA";
+}
+
+static const char *NomeLogica(TipoLogica tipo) {
+    if (tipo == LOGICA_OU) return "OU";
+    if (tipo == LOGICA_E) return "E";
+    if (tipo == LOGICA_ALTERNA) return "ALTERNA";
+    return "TEMPO";
+}
+
+static const char *NomePonta(TipoPonta ponta) {
+    if (ponta == PONTA_BOTAO) return "botao";
+    if (ponta == PONTA_LOGICA) return "logica";
+    return "movel";
+}
+
+static const char *NomeCaminho(TipoCaminho tipo) {
+    if (tipo == CAMINHO_LINHA) return "LINHA";
+    if (tipo == CAMINHO_LACO) return "LACO";
+    return "SUAVE";
+}
+
+static void EscreverRetangulo(FILE *saida, Rectangle r) {
+    fprintf(saida, " %.9g %.9g %.9g %.9g", r.x, r.y, r.width, r.height);
+}
+
+static void EscreverCor(FILE *saida, Color c) {
+    fprintf(saida, " %d %d %d %d", c.r, c.g, c.b, c.a);
+}
+
+static void EscreverFase(FILE *saida, const DadosFase *f, int numero) {
+    fprintf(saida, "# Fase %d\nfase\n", numero);
+    fprintf(saida, "inicio_fogo %.9g %.9g\n", f->posInicialFogo.x, f->posInicialFogo.y);
+    fprintf(saida, "inicio_agua %.9g %.9g\n", f->posInicialAgua.x, f->posInicialAgua.y);
+    if (f->temDiamante) {
+        fprintf(saida, "diamante");
+        EscreverRetangulo(saida, f->diamante);
+        fprintf(saida, "\n");
+    }
+    if (f->tempoPar > 0) fprintf(saida, "par %.9g\n", f->tempoPar);
+    for (int i = 0; i < f->numPlataformas; i++) {
+        fprintf(saida, "plataforma");
+        EscreverRetangulo(saida, f->plataformas[i].retangulo);
+        fprintf(saida, "\n");
+    }
+    for (int i = 0; i < f->numPerigos; i++) {
+        fprintf(saida, "perigo");
+        EscreverRetangulo(saida, f->perigos[i].retangulo);
+        fprintf(saida, " %s", NomePerigo(f->perigos[i].tipo));
+        EscreverCor(saida, f->perigos[i].cor);
+        fprintf(saida, "\n");
+    }
+    for (int i = 0; i < f->numPortas; i++) {
+        fprintf(saida, "porta");
+        EscreverRetangulo(saida, f->portas[i].retangulo);
+        fprintf(saida, " %s", f->portas[i].tipoJogador == JOGADOR_FOGO ? "FOGO" : "AGUA");
+        EscreverCor(saida, f->portas[i].cor);
+        fprintf(saida, "\n");
+    }
+    for (int i = 0; i < f->numBotoes; i++) {
+        fprintf(saida, "botao");
+        EscreverRetangulo(saida, f->botoes[i].retangulo);
+        fprintf(saida, " %d", f->botoes[i].idAlvo);
+        EscreverCor(saida, f->botoes[i].cor);
+        fprintf(saida, "\n");
+    }
+    for (int i = 0; i < f->numPlataformasMoveis; i++) {
+        const PlataformaMovel *p = &f->plataformasMoveis[i];
+        fprintf(saida, "movel");
+        EscreverRetangulo(saida, p->retangulo);
+        fprintf(saida, " %.9g %.9g %.9g %.9g %.9g\n", p->posInicial.x, p->posInicial.y, p->posFinal.x, p->posFinal.y, p->velocidade);
+    }
+    for (int i = 0; i < f->numNosLogicos; i++) {
+        if (f->nosLogicos[i].tipo == LOGICA_TEMPO) fprintf(saida, "logica TEMPO %d\n", f->nosLogicos[i].passos);
+        else fprintf(saida, "logica %s\n", NomeLogica(f->nosLogicos[i].tipo));
+    }
+    for (int i = 0; i < f->numLigacoes; i++) {
+        const Ligacao *l = &f->ligacoes[i];
+        fprintf(saida, "liga %s %d %s %d\n", NomePonta(l->tipoOrigem), l->origem, NomePonta(l->tipoDestino), l->destino);
+    }
+    for (int i = 0; i < f->numCaminhos; i++) {
+        const CaminhoMovel *c = &f->caminhos[i];
+        fprintf(saida, "caminho %d %s%s", c->movel, NomeCaminho(c->tipo), c->sempreAtiva ? " sempre" : "");
+        for (int k = 0; k < c->numPontos; k++)
+            fprintf(saida, " %.9g %.9g", f->pontosCaminho[c->primeiroPonto + k].x, f->pontosCaminho[c->primeiroPonto + k].y);
+        fprintf(saida, "\n");
+    }
+    fprintf(saida, "fim\n\n");
+}
+
+int main(int argc, char **argv) {
+    FILE *saida = stdout;
+    if (argc > 1) {
+        saida = fopen(argv[1], "w");
+        if (saida == NULL) {
+            fprintf(stderr, "Nao foi possivel criar %s\n", argv[1]);
+            return 1;
+        }
+    }
+
+    DadosFase fases[MAX_FASES];
+    int numFases = MontarDadosFasesPadrao(fases);
+    fprintf(saida, "# Fases padrao do Fogo e Agua (gerado por exportar_fases)\n\n");
+    for (int i = 0; i < numFases; i++) EscreverFase(saida, &fases[i], i + 1);
+
+    if (saida != stdout) fclose(saida);
+    return 0;
+}
@@ -0,0 +1,373 @@
+// Fuzzer da simulao: roda muitos episdios sem janela, em todos os ncleos, com teclas sorteadas (ou com
+// mutaes de um replay), e confere a cada passo que nada impossvel aconteceu:
+//   - posio ou velocidade NaN/infinita
+//   - jogador dentro de uma plataforma (fixa ou mvel) depois da coliso
+//   - jogador que estava de um lado de uma plataforma fixa e, no passo seguinte, est do outro (atravessou)
+// Cada tipo de falha (por fase, plataforma e jogador)  contado uma vez e o primeiro episdio que achou 
+// reduzido ao menor trecho de teclas que ainda falha e salvo como replay (falha_faseN_....rep), pra abrir
+// com o reproduzir_replay. Morte reinicia a fase e vitria termina o episdio, igual  reproduo de replays.
+// Uso: fuzz_fases [episodios] [passos por episodio] [pacote|-] [semente] [pasta de saida] [replay base]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+#include <map>
+#include <tuple>
+#include "../simulacao.h"
+#include "../fases.h"
+#include "../pacote.h"
+#include "../replay.h"
+#include "../pool_tarefas.h"
+
+#define EPISODIOS_POR_TRABALHADOR 32 // Episdios por trabalhador em cada rodada
+#define FOLGA_FUZZ 1.0f              // Sobreposio menor que isso  encostar, no entrar
+#define MAX_TENTATIVAS_REDUCAO 20000
+
+typedef enum {
+    FALHA_NENHUMA = 0,
+    FALHA_NAN,
+    FALHA_DENTRO_PLATAFORMA,
+    FALHA_DENTRO_MOVEL,
+    FALHA_ATRAVESSOU,
+    NUM_TIPOS_FALHA
+} TipoFalha;
+
+static const char *nomesFalha[NUM_TIPOS_FALHA] = { "nenhuma", "nan", "dentro_plataforma", "dentro_movel", "atravessou" };
+
+typedef struct {
+    TipoFalha tipo;
+    long long passo;   // Passo (a partir de 0) em que a falha apareceu
+    int indice;        // Plataforma (fixa ou mvel) envolvida, -1 se no tem
+    int jogador;       // 0 = Fogo, 1 = gua
+} Falha;
+
+// Mesmo gerador do bench_simulacao (xorshift32)
+static unsigned int Aleatorio(unsigned int *estado) {
+    unsigned int x = *estado;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *estado = x;
+    return x;
+}
+
+static bool Finito(Vector2 v) {
+    return isfinite(v.x) && isfinite(v.y);
+}
+
+// Os dois retngulos se sobrepem mais que a folga nos dois eixos
+static bool Dentro(Rectangle a, Rectangle b) {
+    return a.x + FOLGA_FUZZ < b.x + b.width && b.x + FOLGA_FUZZ < a.x + a.width &&
+           a.y + FOLGA_FUZZ < b.y + b.height && b.y + FOLGA_FUZZ < a.y + a.height;
+}
+
+// Estava inteiro de um lado de p e agora est inteiro do outro, cruzando p na mesma faixa
+static bool Atravessou(Rectangle antes, Rectangle depois, Rectangle p) {
+    bool faixaY = antes.y + FOLGA_FUZZ < p.y + p.height && p.y + FOLGA_FUZZ < antes.y + antes.height &&
+                  depois.y + FOLGA_FUZZ < p.y + p.height && p.y + FOLGA_FUZZ < depois.y + depois.height;
+    if (faixaY && ((antes.x + antes.width <= p.x + FOLGA_FUZZ && depois.x >= p.x + p.width - FOLGA_FUZZ) ||
+                   (antes.x >= p.x + p.width - FOLGA_FUZZ && depois.x + depois.width <= p.x + FOLGA_FUZZ)))
+        return true;
+    bool faixaX = antes.x + FOLGA_FUZZ < p.x + p.width && p.x + FOLGA_FUZZ < antes.x + antes.width &&
+                  depois.x + FOLGA_FUZZ < p.x + p.width && p.x + FOLGA_FUZZ < depois.x + depois.width;
+    return faixaX && ((antes.y + antes.height <= p.y + FOLGA_FUZZ && depois.y >= p.y + p.height - FOLGA_FUZZ) ||
+                      (antes.y >= p.y + p.height - FOLGA_FUZZ && depois.y + depois.height <= p.y + FOLGA_FUZZ));
+}
+
+static bool ConferirJogador(const Mundo *m, const Jogador *j, Rectangle antes, bool temAntes, int jogador, Falha *falha) {
+    falha->jogador = jogador;
+    falha->indice = -1;
+    if (!Finito(j->posicao) || !Finito(j->velocidade)) {
+        falha->tipo = FALHA_NAN;
+        return true;
+    }
+    Rectangle rec = RetanguloJogador(j);
+    for (int i = 0; i < m->numPlataformasAtuais; i++) {
+        Rectangle p = m->plataformasAtuais[i].retangulo;
+        if (Dentro(rec, p)) {
+            falha->tipo = FALHA_DENTRO_PLATAFORMA;
+            falha->indice = i;
+            return true;
+        }
+        if (temAntes && Atravessou(antes, rec, p)) {
+            falha->tipo = FALHA_ATRAVESSOU;
+            falha->indice = i;
+            return true;
+        }
+    }
+    for (int i = 0; i < m->numPlataformasMoveisAtuais; i++) {
+        if (Dentro(rec, m->plataformasMoveisAtuais[i].retangulo)) {
+            falha->tipo = FALHA_DENTRO_MOVEL;
+            falha->indice = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Roda as teclas do comeo da fase at a primeira falha (true) ou at o fim/vitria (false)
+static bool RodarEpisodio(Mundo *m, int fase, const uint8_t *teclas, long long numPassos, Falha *falha) {
+    if (m->faseAtualIndex != fase) CarregarFaseMundo(m, fase);
+    else ReiniciarFase(m);
+
+    falha->tipo = FALHA_NENHUMA;
+    bool temAntes = false;
+    for (long long i = 0; i < numPassos; i++) {
+        if (m->estado == FIM_DE_JOGO) {
+            ReiniciarFase(m);
+            temAntes = false;
+        }
+        Rectangle antesFogo = RetanguloJogador(&m->jogadores[0]);
+        Rectangle antesAgua = RetanguloJogador(&m->jogadores[1]);
+        int resultado = PassoMundo(m, EntradasDeTeclas(teclas[i]));
+        // Reincio teleporta os jogadores, ento no d pra comparar com o passo anterior
+        if (resultado & PASSO_REINICIOU) temAntes = false;
+        if (ConferirJogador(m, &m->jogadores[0], antesFogo, temAntes, 0, falha) ||
+            ConferirJogador(m, &m->jogadores[1], antesAgua, temAntes, 1, falha)) {
+            falha->passo = i;
+            return true;
+        }
+        if (resultado & PASSO_VITORIA) break;
+        temAntes = true;
+    }
+    falha->tipo = FALHA_NENHUMA;
+    return false;
+}
+
+// Teclas sorteadas em trechos de 1 a 32 passos, com o pulo s no primeiro passo do trecho
+static void SortearTeclas(unsigned int *semente, uint8_t *teclas, long long numPassos) {
+    long long i = 0;
+    while (i < numPassos) {
+        uint8_t t = (uint8_t)(Aleatorio(semente) & 63);
+        long long duracao = 1 + Aleatorio(semente) % 32;
+        for (long long k = 0; k < duracao && i < numPassos; k++, i++)
+            teclas[i] = (k == 0) ? t : (uint8_t)(t & ~(TECLA_FOGO_PULAR | TECLA_AGUA_PULAR));
+    }
+}
+
+// Mutaes de um replay base: troca trechos por teclas sorteadas, liga/desliga teclas e repete pedaos
+static void MutarTeclas(unsigned int *semente, const std::vector<uint8_t> &base, uint8_t *teclas, long long numPassos) {
+    long long n = (long long)base.size();
+    for (long long i = 0; i < numPassos; i++) teclas[i] = (i < n) ? base[i] : 0;
+    if (numPassos > n) SortearTeclas(semente, teclas + n, numPassos - n);
+    int mutacoes = 1 + Aleatorio(semente) % 8;
+    for (int k = 0; k < mutacoes; k++) {
+        long long inicio = Aleatorio(semente) % numPassos;
+        long long tamanho = 1 + Aleatorio(semente) % 64;
+        if (inicio + tamanho > numPassos) tamanho = numPassos - inicio;
+        switch (Aleatorio(semente) % 3) {
+        case 0:
+            SortearTeclas(semente, teclas + inicio, tamanho);
+            break;
+        case 1: {
+            uint8_t bit = (uint8_t)(1u << (Aleatorio(semente) % 6));
+            for (long long i = inicio; i < inicio + tamanho; i++) teclas[i] ^= bit;
+            break;
+        }
+        default: {
+            long long origem = Aleatorio(semente) % numPassos;
+            for (long long i = 0; i < tamanho && origem + i < numPassos; i++) teclas[inicio + i] = teclas[origem + i];
+            break;
+        }
+        }
+    }
+}
+
+typedef struct {
+    Mundo *mundos;                  // Um por trabalhador
+    int numFases;
+    int faseFixa;                   // -1 = episdio e vai pra fase e % numFases
+    long long primeiroEpisodio;     // ndice global do primeiro episdio da rodada
+    long long passosPorEpisodio;
+    unsigned int semente;
+    const std::vector<uint8_t> *base; // Teclas do replay base (NULL = s sorteio)
+    uint8_t *teclas;                // passosPorEpisodio por episdio da rodada
+    Falha *falhas;
+    long long *passosRodados;       // Por trabalhador
+} ContextoFuzz;
+
+static int FaseDoEpisodio(const ContextoFuzz *c, long long episodio) {
+    return (c->faseFixa >= 0) ? c->faseFixa : (int)(episodio % c->numFases);
+}
+
+static void RodarTarefa(void *contexto, int tarefa, int trabalhador) {
+    ContextoFuzz *c = (ContextoFuzz *)contexto;
+    long long episodio = c->primeiroEpisodio + tarefa;
+    uint8_t *teclas = c->teclas + (size_t)tarefa * c->passosPorEpisodio;
+    // Semente s do episdio: o resultado no depende de qual thread rodou
+    unsigned int semente = (c->semente ^ (unsigned int)(episodio * 2654435761u)) | 1u;
+    if (c->base) MutarTeclas(&semente, *c->base, teclas, c->passosPorEpisodio);
+    else SortearTeclas(&semente, teclas, c->passosPorEpisodio);
+
+    Falha *falha = &c->falhas[tarefa];
+    RodarEpisodio(&c->mundos[trabalhador], FaseDoEpisodio(c, episodio), teclas, c->passosPorEpisodio, falha);
+    c->passosRodados[trabalhador] += (falha->tipo != FALHA_NENHUMA) ? falha->passo + 1 : c->passosPorEpisodio;
+}
+
+// Mesma falha (tipo, plataforma e jogador)?
+static bool MesmaFalha(const Falha *a, const Falha *b) {
+    return a->tipo == b->tipo && a->indice == b->indice && a->jogador == b->jogador;
+}
+
+static bool AindaFalha(Mundo *m, int fase, const std::vector<uint8_t> &teclas, const Falha *alvo, Falha *falha) {
+    return RodarEpisodio(m, fase, teclas.data(), (long long)teclas.size(), falha) && MesmaFalha(falha, alvo);
+}
+
+// Reduz as teclas que causam a falha: corta o que vem depois dela, tira pedaos cada vez menores (ddmin)
+// e depois solta teclas uma a uma, sempre conferindo que a mesma falha continua acontecendo
+static void ReduzirTeclas(Mundo *m, int fase, std::vector<uint8_t> *teclas, const Falha *alvo) {
+    Falha falha;
+    int tentativas = 0;
+    teclas->resize((size_t)alvo->passo + 1);
+
+    for (size_t tamanho = teclas->size() / 2; tamanho >= 1 && tentativas < MAX_TENTATIVAS_REDUCAO; tamanho /= 2) {
+        for (size_t inicio = 0; inicio + tamanho <= teclas->size() && tentativas < MAX_TENTATIVAS_REDUCAO;) {
+            std::vector<uint8_t> menor(*teclas);
+            menor.erase(menor.begin() + inicio, menor.begin() + inicio + tamanho);
+            tentativas++;
+            if (!menor.empty() && AindaFalha(m, fase, menor, alvo, &falha)) {
+                menor.resize((size_t)falha.passo + 1);
+                teclas->swap(menor);
+            } else {
+                inicio += tamanho;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < teclas->size() && tentativas < MAX_TENTATIVAS_REDUCAO; i++) {
+        for (int bit = 0; bit < 6 && tentativas < MAX_TENTATIVAS_REDUCAO; bit++) {
+            if (!((*teclas)[i] & (1u << bit))) continue;
+            std::vector<uint8_t> menor(*teclas);
+            menor[i] &= (uint8_t)~(1u << bit);
+            tentativas++;
+            if (AindaFalha(m, fase, menor, alvo, &falha)) {
+                menor.resize((size_t)falha.passo + 1);
+                teclas->swap(menor);
+                if (i >= teclas->size()) break;
+            }
+        }
+    }
+}
+
+// Grava as teclas como replay (com hash por passo), rodando do comeo da fase
+static bool SalvarFalha(Mundo *m, int fase, const std::vector<uint8_t> &teclas, const char *caminho) {
+    CarregarFaseMundo(m, fase);
+    Replay replay = {0};
+    IniciarGravacao(&replay, m, true);
+    for (size_t i = 0; i < teclas.size(); i++) {
+        if (m->estado == FIM_DE_JOGO) ReiniciarFase(m);
+        Entradas entradas = EntradasDeTeclas(teclas[i]);
+        PassoMundo(m, entradas);
+        GravarPasso(&replay, entradas, m);
+    }
+    bool ok = SalvarReplay(&replay, caminho);
+    LiberarReplay(&replay);
+    return ok;
+}
+
+// Teclas de um replay, um byte por passo
+static bool TeclasDoReplay(const char *caminho, std::vector<uint8_t> *teclas, int *fase) {
+    Replay replay;
+    if (!CarregarReplay(&replay, caminho)) return false;
+    teclas->clear();
+    for (int i = 0; i < replay.numTrechos; i++) teclas->insert(teclas->end(), replay.trechos[i].passos, replay.trechos[i].teclas);
+    *fase = replay.fase;
+    LiberarReplay(&replay);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    long long episodios = (argc > 1) ? atoll(argv[1]) : 20000;
+    long long passosPorEpisodio = (argc > 2) ? atoll(argv[2]) : 3000;
+    const char *caminhoPacote = (argc > 3 && strcmp(argv[3], "-") != 0) ? argv[3] : NULL;
+    unsigned int semente = (argc > 4) ? (unsigned int)strtoul(argv[4], NULL, 0) : 0x9E3779B9u;
+    const char *pastaSaida = (argc > 5) ? argv[5] : ".";
+    const char *caminhoBase = (argc > 6) ? argv[6] : NULL;
+    if (episodios <= 0 || passosPorEpisodio <= 0) {
+        fprintf(stderr, "Uso: %s [episodios] [passos por episodio] [pacote|-] [semente] [pasta de saida] [replay base]\n", argv[0]);
+        return 1;
+    }
+
+    DadosFase dadosPadrao[MAX_FASES];
+    const DadosFase *fases = dadosPadrao;
+    int numFases = MontarDadosFasesPadrao(dadosPadrao);
+    PacoteFases pacote = {0};
+    if (caminhoPacote != NULL) {
+        if (!AbrirPacote(&pacote, caminhoPacote)) return 1;
+        fases = pacote.fases;
+        numFases = pacote.numFases;
+    }
+
+    std::vector<uint8_t> base;
+    int faseFixa = -1;
+    if (caminhoBase != NULL) {
+        if (!TeclasDoReplay(caminhoBase, &base, &faseFixa)) return 1;
+        if (faseFixa < 0 || faseFixa >= numFases || base.empty()) {
+            fprintf(stderr, "%s: replay vazio ou de uma fase que nao existe\n", caminhoBase);
+            return 1;
+        }
+    }
+
+    PoolTarefas *pool = CriarPool(0);
+    int trabalhadores = TrabalhadoresPool(pool);
+    std::vector<Mundo> mundos(trabalhadores);
+    for (int i = 0; i < trabalhadores; i++) IniciarMundo(&mundos[i], fases, numFases, 0);
+    printf("%lld episodios de %lld passos, %d threads, semente 0x%08x%s%s\n", episodios, passosPorEpisodio, trabalhadores,
+           semente, caminhoBase ? ", mutando " : "", caminhoBase ? caminhoBase : "");
+
+    int porRodada = trabalhadores * EPISODIOS_POR_TRABALHADOR;
+    std::vector<uint8_t> teclas((size_t)porRodada * passosPorEpisodio);
+    std::vector<Falha> falhas(porRodada);
+    std::vector<long long> passosRodados(trabalhadores, 0);
+
+    // Falhas j vistas: (fase, tipo, plataforma, jogador) -> quantos episdios deram nela
+    std::map<std::tuple<int, int, int, int>, long long> vistas;
+    long long episodiosComFalha = 0;
+    double segundos = 0; // S a simulao dos episdios (a reduo das falhas fica de fora)
+
+    for (long long primeiro = 0; primeiro < episodios; primeiro += porRodada) {
+        int n = (int)((episodios - primeiro < porRodada) ? episodios - primeiro : porRodada);
+        ContextoFuzz contexto = { mundos.data(), numFases, faseFixa, primeiro, passosPorEpisodio, semente,
+                                  caminhoBase ? &base : NULL, teclas.data(), falhas.data(), passosRodados.data() };
+        auto inicio = std::chrono::steady_clock::now();
+        ExecutarTarefas(pool, n, RodarTarefa, &contexto);
+        segundos += std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+
+        // Na ordem dos episdios, pra sada no depender do nmero de threads
+        for (int k = 0; k < n; k++) {
+            const Falha *f = &falhas[k];
+            if (f->tipo == FALHA_NENHUMA) continue;
+            episodiosComFalha++;
+            int fase = FaseDoEpisodio(&contexto, primeiro + k);
+            long long &contagem = vistas[std::make_tuple(fase, (int)f->tipo, f->indice, f->jogador)];
+            if (contagem++ > 0) continue;
+
+            const uint8_t *t = &teclas[(size_t)k * passosPorEpisodio];
+            std::vector<uint8_t> reduzidas(t, t + f->passo + 1);
+            ReduzirTeclas(&mundos[0], fase, &reduzidas, f);
+            char caminho[512];
+            snprintf(caminho, sizeof(caminho), "%s/falha_fase%d_%s_%s_%d.rep", pastaSaida, fase + 1, nomesFalha[f->tipo],
+                     f->jogador == 0 ? "fogo" : "agua", f->indice + 1);
+            bool salvo = SalvarFalha(&mundos[0], fase, reduzidas, caminho);
+            printf("Fase %d: %s (%s, plataforma %d) no episodio %lld, passo %lld; reduzido a %zu passos%s%s\n", fase + 1,
+                   nomesFalha[f->tipo], f->jogador == 0 ? "fogo" : "agua", f->indice + 1, primeiro + k, f->passo,
+                   reduzidas.size(), salvo ? " -> " : " (erro ao salvar)", salvo ? caminho : "");
+        }
+    }
+
+    long long totalPassos = 0;
+    for (int i = 0; i < trabalhadores; i++) totalPassos += passosRodados[i];
+
+    printf("%lld passos em %.2f s (%.0f passos/s, %.1f milhoes/min), %lld de %lld episodios com falha\n", totalPassos,
+           segundos, totalPassos / segundos, totalPassos / segundos * 60 / 1e6, episodiosComFalha, episodios);
+    for (auto &v : vistas)
+        printf("  fase %d %-18s %s plataforma %-3d %lld episodios\n", std::get<0>(v.first) + 1, nomesFalha[std::get<1>(v.first)],
+               std::get<3>(v.first) == 0 ? "fogo" : "agua", std::get<2>(v.first) + 1, v.second);
+
+    for (int i = 0; i < trabalhadores; i++) LiberarMundo(&mundos[i]);
+    DestruirPool(pool);
+    FecharPacote(&pacote);
+    return vistas.empty() ? 0 : 1;
+}
@@ -0,0 +1,48 @@
+/*
+Gera fases procedurais (gerador.h) e grava num pacote, pra usar nos benchmarks e no fuzz com fases grandes.
+Uso: gerar_fases saida.pack [semente] [largura] [andares] [numFases]
+A fase i usa a semente + i, ento o mesmo comando gera sempre o mesmo pacote; o hash de cada fase
+(o mesmo dos replays) sai na tela pra conferir.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "../simulacao.h"
+#include "../gerador.h"
+#include "../pacote.h"
+#include "../replay.h"
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Uso: %s saida.pack [semente] [largura] [andares] [numFases]\n", argv[0]);
+        return 1;
+    }
+    unsigned int semente = (argc > 2) ? (unsigned int)strtoul(argv[2], NULL, 10) : 1;
+    int largura = (argc > 3) ? atoi(argv[3]) : 8000;
+    int andares = (argc > 4) ? atoi(argv[4]) : 20;
+    int numFases = (argc > 5) ? atoi(argv[5]) : 1;
+    if (largura < LARGURA_MIN_GERADA || andares < 1 || numFases < 1) {
+        fprintf(stderr, "largura >= %d, andares >= 1 e numFases >= 1\n", LARGURA_MIN_GERADA);
+        return 1;
+    }
+
+    FaseGerada *geradas = (FaseGerada *)calloc((size_t)numFases, sizeof(FaseGerada));
+    DadosFase *fases = (DadosFase *)calloc((size_t)numFases, sizeof(DadosFase));
+    if (geradas == NULL || fases == NULL) {
+        fprintf(stderr, "Sem memria\n");
+        return 1;
+    }
+    for (int i = 0; i < numFases; i++) {
+        GerarFase(&geradas[i], semente + (unsigned int)i, largura, andares);
+        fases[i] = geradas[i].dados;
+        printf("Fase %d: semente %u, %.0fx%.0f px, %d plataformas, %d perigos, %d botes, %d mveis, hash %08x\n",
+               i + 1, semente + (unsigned int)i, geradas[i].largura, geradas[i].altura, fases[i].numPlataformas,
+               fases[i].numPerigos, fases[i].numBotoes, fases[i].numPlataformasMoveis, HashFase(&fases[i]));
+    }
+
+    bool ok = SalvarPacote(argv[1], fases, numFases);
+    if (ok) printf("Pacote gravado em %s\n", argv[1]);
+    for (int i = 0; i < numFases; i++) LiberarFaseGerada(&geradas[i]);
+    free(geradas);
+    free(fases);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+// Reproduz um replay sem janela, conferindo o hash do mundo a cada passo, e mede passos por segundo.
+// Serve de carga fixa pra benchmark e de teste de regresso (a simulao tem que dar sempre o mesmo resultado).
+// Uso: reproduzir_replay <arquivo.rep> [pacote] [repeticoes]              (pacote "-" = fases padro)
+//      reproduzir_replay gravar <saida.rep> <fase> <passos> [pacote]   (grava um replay com teclas sorteadas)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include "../simulacao.h"
+#include "../fases.h"
+#include "../pacote.h"
+#include "../replay.h"
+
+// Mesmo gerador do bench_simulacao (xorshift32)
+static unsigned int Aleatorio(unsigned int *estado) {
+    unsigned int x = *estado;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *estado = x;
+    return x;
+}
+
+// Fases do pacote (se foi passado) ou as padro
+static bool AbrirFases(const char *caminhoPacote, PacoteFases *pacote, DadosFase dadosPadrao[MAX_FASES],
+                       const DadosFase **fases, int *numFases) {
+    *fases = dadosPadrao;
+    *numFases = MontarDadosFasesPadrao(dadosPadrao);
+    if (caminhoPacote == NULL || strcmp(caminhoPacote, "-") == 0) return true;
+    if (!AbrirPacote(pacote, caminhoPacote)) return false;
+    *fases = pacote->fases;
+    *numFases = pacote->numFases;
+    return true;
+}
+
+static int Gravar(int argc, char **argv) {
+    if (argc < 5) {
+        fprintf(stderr, "Uso: %s gravar <saida.rep> <fase> <passos> [pacote]\n", argv[0]);
+        return 1;
+    }
+    int fase = atoi(argv[3]) - 1;
+    long long passos = atoll(argv[4]);
+    PacoteFases pacote = {0};
+    DadosFase dadosPadrao[MAX_FASES];
+    const DadosFase *fases;
+    int numFases;
+    if (!AbrirFases(argc > 5 ? argv[5] : NULL, &pacote, dadosPadrao, &fases, &numFases)) return 1;
+    if (fase < 0 || fase >= numFases || passos <= 0) {
+        fprintf(stderr, "Fase (1 a %d) ou numero de passos invalido\n", numFases);
+        FecharPacote(&pacote);
+        return 1;
+    }
+
+    Mundo mundo;
+    IniciarMundo(&mundo, fases, numFases, fase);
+    Replay replay = {0};
+    IniciarGravacao(&replay, &mundo, true);
+
+    // Teclas trocam a cada 16 passos, como no bench_simulacao; a morte reinicia igual  reproduo
+    unsigned int semente = 0x9E3779B9u + fase;
+    Entradas entradas = EntradasDeTeclas(0);
+    for (long long i = 0; i < passos; i++) {
+        if ((i & 15) == 0) entradas = EntradasDeTeclas((uint8_t)(Aleatorio(&semente) & 63));
+        if (mundo.estado == FIM_DE_JOGO) ReiniciarFase(&mundo);
+        int resultado = PassoMundo(&mundo, entradas);
+        GravarPasso(&replay, entradas, &mundo);
+        if (resultado & PASSO_VITORIA) break;
+    }
+
+    bool ok = SalvarReplay(&replay, argv[2]);
+    if (ok) printf("%s: fase %d, %lld passos em %d trechos\n", argv[2], fase + 1, replay.numPassos, replay.numTrechos);
+    LiberarReplay(&replay);
+    LiberarMundo(&mundo);
+    FecharPacote(&pacote);
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Uso: %s <arquivo.rep> [pacote] [repeticoes]\n"
+                        "     %s gravar <saida.rep> <fase> <passos> [pacote]\n", argv[0], argv[0]);
+        return 1;
+    }
+    if (strcmp(argv[1], "gravar") == 0) return Gravar(argc, argv);
+
+    Replay replay;
+    if (!CarregarReplay(&replay, argv[1])) return 1;
+    int repeticoes = (argc > 3) ? atoi(argv[3]) : 1;
+    if (repeticoes < 1) repeticoes = 1;
+
+    PacoteFases pacote = {0};
+    DadosFase dadosPadrao[MAX_FASES];
+    const DadosFase *fases;
+    int numFases;
+    if (!AbrirFases(argc > 2 ? argv[2] : NULL, &pacote, dadosPadrao, &fases, &numFases)) {
+        LiberarReplay(&replay);
+        return 1;
+    }
+
+    Mundo mundo;
+    IniciarMundo(&mundo, fases, numFases, 0);
+    printf("Replay %s: fase %d, %lld passos em %d trechos, %s\n", argv[1], replay.fase + 1, replay.numPassos,
+           replay.numTrechos, replay.hashes != NULL ? "com hash por passo" : "sem hash");
+
+    int codigo = 0;
+    ResultadoReplay r;
+    uint32_t hashPrimeira = 0;
+    auto inicio = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeticoes; i++) {
+        if (!ReproduzirReplay(&replay, &mundo, true, &r)) {
+            codigo = 1;
+            break;
+        }
+        if (i == 0) hashPrimeira = r.hashFinal;
+        if (r.divergiu >= 0) {
+            printf("ERRO: simulacao divergiu do replay no passo %lld\n", r.divergiu);
+            codigo = 1;
+            break;
+        }
+        if (r.hashFinal != hashPrimeira) {
+            printf("ERRO: repeticao %d terminou diferente da primeira\n", i + 1);
+            codigo = 1;
+            break;
+        }
+    }
+    auto fim = std::chrono::steady_clock::now();
+
+    if (codigo == 0) {
+        double segundos = std::chrono::duration<double>(fim - inicio).count();
+        printf("%d repeticoes em %.3f s (%.0f passos/s): %s, %d mortes, %d quedas, hash final %08x\n", repeticoes, segundos,
+               (double)r.passos * repeticoes / segundos, r.venceu ? "venceu" : "nao venceu", r.mortes, r.quedas, r.hashFinal);
+    }
+
+    LiberarMundo(&mundo);
+    LiberarReplay(&replay);
+    FecharPacote(&pacote);
+    return codigo;
+}
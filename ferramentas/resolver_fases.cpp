@@ -0,0 +1,1059 @@
+// Resolve as fases procurando a sequncia de teclas mais curta que leva os dois jogadores s portas
+// (pegando o diamante quando a fase tem um). Busca A* no espao conjunto dos dois jogadores, botes e
+// plataformas mveis: cada ao  uma combinao de teclas segurada por PASSOS_POR_ACAO passos, e estados
+// parecidos (posies em grade de 2 px, velocidade arredondada) contam como o mesmo.
+// A estimativa vem de mapas de cada jogador sozinho, ento a soluo  a mais curta que a busca acha
+// (um limite de cima pro tempo par), no uma prova de que no existe outra mais curta.
+// Os ns de cada rodada so expandidos em paralelo no pool de threads (roubo de trabalho).
+// Se a busca conjunta no acha (fase em que um segura o boto pro outro passar), tenta a busca por metas:
+// trechos de um jogador sozinho at um boto, uma mvel, o diamante ou a porta, com o outro parado.
+// Tambm confere erros comuns nos dados da fase (itens com tamanho zero, boto sem alvo etc.).
+// A soluo de cada fase vira um replay (solucao_faseN.rep) e o tempo dela  o tempo par da fase.
+// Uso: resolver_fases [pacote|-] [limite de nos por fase] [pasta de saida] [peso da estimativa]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <queue>
+#include <vector>
+#include <unordered_set>
+#include <unordered_map>
+#include "../simulacao.h"
+#include "../fases.h"
+#include "../pacote.h"
+#include "../replay.h"
+#include "../pool_tarefas.h"
+
+#define PASSOS_POR_ACAO 8
+#define NUM_ACOES 36 // (nada, esquerda, direita) x (pula ou no), pra cada jogador
+#define MAX_MOVEIS_BUSCA 16
+#define MAX_BOTOES_BUSCA 32
+#define NOS_POR_TRABALHADOR 16 // Ns expandidos por trabalhador em cada rodada
+
+// Mapas de distncia de um jogador sozinho (usados na estimativa da busca)
+#define ACOES_SOZINHO 6        // (nada, esquerda, direita) x (pula ou no)
+#define TAM_CELULA_MAPA 8.0f
+#define MAX_ESTADOS_MAPA 200000
+#define CONFIGS_MOVEIS 7       // Mveis paradas onde comeam, na posio inicial, na final, sem elas e em 3 pontos no meio
+#define SEM_CAMINHO 1e30f
+
+// Tudo que muda durante a fase (o resto vem da fase)
+typedef struct {
+    Jogador fogo;
+    Jogador agua;
+    Rectangle moveis[MAX_MOVEIS_BUSCA];
+    unsigned int moveisAtivas;
+    unsigned int botoesApertados;
+    bool diamanteColetado;
+} EstadoBusca;
+
+typedef struct {
+    EstadoBusca estado;
+    int pai;        // -1 na raiz
+    int acao;
+    int passos;     // Passos desde o comeo da fase
+    float custo;    // passos + estimativa do que falta
+    float desempate; // Soma do que falta pros dois (no empate, expande quem est mais perto no total)
+} NoBusca;
+
+typedef struct {
+    EstadoBusca estado;
+    int passos;     // Passos gastos nesta ao (menos que PASSOS_POR_ACAO se venceu no meio)
+    bool valido;    // false = morreu ou caiu
+    bool venceu;
+} Sucessor;
+
+typedef struct {
+    const DadosFase *fase;
+    Mundo *mundos;            // Um por trabalhador
+    const NoBusca *lote;      // Ns da rodada
+    Sucessor *sucessores;     // NUM_ACOES por n do lote
+} ContextoBusca;
+
+static Entradas EntradasDaAcao(int acao, bool primeiroPasso) {
+    int fogo = acao % 6, agua = acao / 6;
+    Entradas e;
+    e.fogo = (EntradaJogador){ fogo % 3 == 1, fogo % 3 == 2, primeiroPasso && fogo >= 3 };
+    e.agua = (EntradaJogador){ agua % 3 == 1, agua % 3 == 2, primeiroPasso && agua >= 3 };
+    return e;
+}
+
+// A busca pula entre estados longe um do outro (RestaurarEstado), ento a fase fica inteira carregada
+static void IniciarMundoInteiro(Mundo *m, const DadosFase fases[], int numFases, int indice) {
+    IniciarMundo(m, fases, numFases, indice);
+    m->carregarFaseInteira = true;
+    CarregarFaseMundo(m, indice);
+}
+
+static void SalvarEstado(const Mundo *m, EstadoBusca *e) {
+    memset(e, 0, sizeof(*e));
+    e->fogo = m->jogadores[0];
+    e->agua = m->jogadores[1];
+    for (int i = 0; i < m->numPlataformasMoveisAtuais; i++) {
+        e->moveis[i] = m->plataformasMoveisAtuais[i].retangulo;
+        if (m->plataformasMoveisAtuais[i].ativa) e->moveisAtivas |= 1u << i;
+    }
+    for (int i = 0; i < m->numBotoesAtuais; i++)
+        if (m->botoesAtuais[i].pressionado) e->botoesApertados |= 1u << i;
+    e->diamanteColetado = m->diamanteColetado;
+}
+
+static void RestaurarEstado(Mundo *m, const EstadoBusca *e) {
+    m->jogadores[0] = e->fogo;
+    m->jogadores[1] = e->agua;
+    for (int i = 0; i < m->numPlataformasMoveisAtuais; i++) {
+        m->plataformasMoveisAtuais[i].retangulo = e->moveis[i];
+        m->plataformasMoveisAtuais[i].ativa = (e->moveisAtivas >> i) & 1u;
+    }
+    for (int i = 0; i < m->numBotoesAtuais; i++) m->botoesAtuais[i].pressionado = (e->botoesApertados >> i) & 1u;
+    RefazerBotoes(m);
+    AtualizarIndiceMoveis(m);
+    m->diamanteColetado = e->diamanteColetado;
+    m->diamantesColetados = e->diamanteColetado ? 1 : 0;
+    m->estado = JOGANDO;
+}
+
+// Chave do estado pra no visitar de novo: posies em grade de 2 px e velocidade em quartos de px.
+// Cada mvel entra como ativa ou no e parada no comeo, parada no fim ou no meio, com o quanto andou desde
+// posInicial na mesma grade de 2 px (1 px separava estados que s diferem pelo arredondamento da mvel).
+static unsigned long long ChaveEstado(const DadosFase *fase, const EstadoBusca *e) {
+    unsigned long long h = 1469598103934665603ULL;
+    long long campos[8] = {
+        lroundf(e->fogo.posicao.x / 2), lroundf(e->fogo.posicao.y / 2), lroundf(e->fogo.velocidade.y * 4), e->fogo.podePular,
+        lroundf(e->agua.posicao.x / 2), lroundf(e->agua.posicao.y / 2), lroundf(e->agua.velocidade.y * 4), e->agua.podePular
+    };
+    for (int i = 0; i < 8; i++) h = (h ^ (unsigned long long)campos[i]) * 1099511628211ULL;
+    for (int i = 0; i < fase->numPlataformasMoveis; i++) {
+        const PlataformaMovel *p = &fase->plataformasMoveis[i];
+        Rectangle r = e->moveis[i];
+        long long onde, andouX = 0, andouY = 0;
+        if (r.x == p->posInicial.x && r.y == p->posInicial.y) {
+            onde = 0;
+        } else if (r.x == p->posFinal.x && r.y == p->posFinal.y) {
+            onde = 1;
+        } else {
+            onde = 2;
+            andouX = lroundf((r.x - p->posInicial.x) / 2);
+            andouY = lroundf((r.y - p->posInicial.y) / 2);
+        }
+        h = (h ^ (unsigned long long)(onde * 2 + ((e->moveisAtivas >> i) & 1u))) * 1099511628211ULL;
+        h = (h ^ (unsigned long long)andouX) * 1099511628211ULL;
+        h = (h ^ (unsigned long long)andouY) * 1099511628211ULL;
+    }
+    h = (h ^ e->botoesApertados) * 1099511628211ULL;
+    return (h ^ (unsigned long long)e->diamanteColetado) * 1099511628211ULL;
+}
+
+// Passos que faltam, no mnimo, pro jogador (centro em x) encostar em alvo andando s na horizontal
+static float PassosAte(float x, Rectangle alvo, float velocidadeMaxima) {
+    float distancia = fmaxf(0.0f, fmaxf((alvo.x - 10) - x, x - (alvo.x + alvo.width + 10)));
+    return distancia / velocidadeMaxima;
+}
+
+// Estimativa s pela distncia horizontal (nunca passa do custo real, mas ignora que precisa subir):
+// cada jogador ainda tem que chegar na sua porta e algum ainda tem que passar pelo diamante
+static float EstimativaHorizontal(const DadosFase *fase, const EstadoBusca *e, float velocidadeMaxima) {
+    Rectangle portaFogo = fase->portas[0].retangulo, portaAgua = fase->portas[1].retangulo;
+    float fogo = PassosAte(e->fogo.posicao.x, portaFogo, velocidadeMaxima);
+    float agua = PassosAte(e->agua.posicao.x, portaAgua, velocidadeMaxima);
+    float h = fmaxf(fogo, agua);
+    if (fase->temDiamante && !e->diamanteColetado) {
+        float centroDiamante = fase->diamante.x + fase->diamante.width / 2;
+        float viaFogo = PassosAte(e->fogo.posicao.x, fase->diamante, velocidadeMaxima) + PassosAte(centroDiamante, portaFogo, velocidadeMaxima);
+        float viaAgua = PassosAte(e->agua.posicao.x, fase->diamante, velocidadeMaxima) + PassosAte(centroDiamante, portaAgua, velocidadeMaxima);
+        h = fmaxf(h, fminf(viaFogo, viaAgua));
+    }
+    return h;
+}
+
+// Alvos de um trecho da busca por metas, nesta ordem: cada boto, cada mvel (parado em cima dela), o
+// diamante e a porta do jogador
+static int AlvoDiamante(const DadosFase *fase) { return fase->numBotoes + fase->numPlataformasMoveis; }
+static int AlvoPorta(const DadosFase *fase) { return AlvoDiamante(fase) + 1; }
+
+// Lugar dos alvos at o diamante, com as mveis onde esto em m (o de uma mvel  a faixa logo acima dela)
+static Rectangle RetanguloAlvo(const Mundo *m, const DadosFase *fase, int alvo) {
+    if (alvo < fase->numBotoes) return fase->botoes[alvo].retangulo;
+    if (alvo == AlvoDiamante(fase)) return fase->diamante;
+    Rectangle r = m->plataformasMoveisAtuais[alvo - fase->numBotoes].retangulo;
+    return (Rectangle){ r.x, r.y - 2, r.width, 2 };
+}
+
+// Mapa de um jogador sozinho numa verso simplificada da fase: o outro jogador fica parado num canto e as
+// plataformas mveis ficam congeladas. Os estados so clulas de 8 px (mais velocidade e podePular), e cada
+// um guarda quantos passos faltam pra encostar na porta (e no diamante e depois na porta) e em cada alvo.
+typedef struct {
+    TipoJogador tipo;
+    std::unordered_map<long long, int> ids;
+    std::vector<Jogador> estados;       // Primeiro jogador que chegou em cada clula
+    std::vector<int> proximos;          // ACOES_SOZINHO por estado (-1 = morreu ou caiu)
+    std::vector<signed char> tocouPorta;    // Passo da ao em que encostou na porta (-1 = no encostou)
+    std::vector<signed char> tocouDiamante;
+    std::vector<float> ateporta;
+    std::vector<float> ateDiamante;     // Passando pelo diamante e depois indo pra porta
+    // Menor distncia entre os estados de cada clula s de posio (a busca conjunta cai em
+    // velocidades que o mapa no viu, mas quase sempre em posies que ele viu)
+    std::unordered_map<long long, float> ateportaCelula;
+    std::unordered_map<long long, float> ateDiamanteCelula;
+    std::vector<std::unordered_map<long long, float>> ateAlvoCelula; // Por alvo de trecho com lugar (ver AlvoDiamante)
+} MapaJogador;
+
+typedef struct {
+    Mundo *mundos;
+    const MapaJogador *mapa;
+    const int *camada;
+    Jogador *saida;                     // ACOES_SOZINHO por estado da camada
+    signed char *porta;
+    signed char *diamante;
+    char *valido;                       // 0 = morreu ou caiu
+    Rectangle retanguloPorta;
+    Rectangle retanguloDiamante;
+    bool temDiamante;
+} ContextoMapa;
+
+static long long ChavePosicao(const Jogador *j) {
+    long long cx = (long long)floorf(j->posicao.x / TAM_CELULA_MAPA);
+    long long cy = (long long)floorf(j->posicao.y / TAM_CELULA_MAPA);
+    return cx * 4096 + cy;
+}
+
+static long long ChaveCelula(const Jogador *j) {
+    long long cx = (long long)floorf(j->posicao.x / TAM_CELULA_MAPA);
+    long long cy = (long long)floorf(j->posicao.y / TAM_CELULA_MAPA);
+    long long vy = lroundf(j->velocidade.y);
+    if (vy < -16) vy = -16;
+    if (vy > 47) vy = 47;
+    return ((cx * 4096 + cy) * 64 + (vy + 16)) * 2 + (j->podePular ? 1 : 0);
+}
+
+static Jogador *JogadorDoTipo(Mundo *m, TipoJogador tipo) {
+    return (tipo == JOGADOR_FOGO) ? &m->jogadores[0] : &m->jogadores[1];
+}
+
+// Congela as plataformas mveis numa das configuraes (0 = onde comeam, 1 = inicial, 2 = final, 3 = fora da
+// tela, 4 a 6 = a 1/4, 2/4 e 3/4 do caminho: um elevador que s passa subindo tem que aparecer parado no meio)
+static void CongelarMoveis(Mundo *m, int config) {
+    for (int i = 0; i < m->numPlataformasMoveisAtuais; i++) {
+        PlataformaMovel *p = &m->plataformasMoveisAtuais[i];
+        if (config == 1) {
+            p->retangulo.x = p->posInicial.x;
+            p->retangulo.y = p->posInicial.y;
+        } else if (config == 2) {
+            p->retangulo.x = p->posFinal.x;
+            p->retangulo.y = p->posFinal.y;
+        } else if (config == 3) {
+            p->retangulo.y = -100000.0f;
+        } else if (config >= 4) {
+            float t = (config - 3) / 4.0f;
+            p->retangulo.x = p->posInicial.x + (p->posFinal.x - p->posInicial.x) * t;
+            p->retangulo.y = p->posInicial.y + (p->posFinal.y - p->posInicial.y) * t;
+        }
+        p->velocidade = 0;
+    }
+    AtualizarIndiceMoveis(m);
+}
+
+static void ExpandirEstadoMapa(void *contexto, int tarefa, int trabalhador) {
+    ContextoMapa *c = (ContextoMapa *)contexto;
+    Mundo *m = &c->mundos[trabalhador];
+    const Jogador inicio = c->mapa->estados[c->camada[tarefa]];
+    TipoJogador outro = (c->mapa->tipo == JOGADOR_FOGO) ? JOGADOR_AGUA : JOGADOR_FOGO;
+    for (int acao = 0; acao < ACOES_SOZINHO; acao++) {
+        int k = tarefa * ACOES_SOZINHO + acao;
+        *JogadorDoTipo(m, c->mapa->tipo) = inicio;
+        // O outro fica no canto de cima, longe de tudo
+        JogadorDoTipo(m, outro)->posicao = (Vector2){ 10, 20 };
+        JogadorDoTipo(m, outro)->velocidade = (Vector2){ 0, 0 };
+        m->estado = JOGANDO;
+        c->valido[k] = 1;
+        c->porta[k] = -1;
+        c->diamante[k] = -1;
+        Jogador *j = JogadorDoTipo(m, c->mapa->tipo);
+        for (int p = 0; p < PASSOS_POR_ACAO; p++) {
+            // A ao do jogador sozinho  a mesma codificao do conjunto, com o outro parado
+            int acaoConjunta = (c->mapa->tipo == JOGADOR_FOGO) ? acao : acao * 6;
+            int r = PassoMundo(m, EntradasDaAcao(acaoConjunta, p == 0));
+            if (r & (PASSO_MORTE | PASSO_REINICIOU)) {
+                c->valido[k] = 0;
+                break;
+            }
+            Rectangle rec = RetanguloJogador(j);
+            if (c->porta[k] < 0 && CheckCollisionRecs(rec, c->retanguloPorta)) c->porta[k] = (signed char)p;
+            if (c->temDiamante && c->diamante[k] < 0 && CheckCollisionRecs(rec, c->retanguloDiamante)) c->diamante[k] = (signed char)p;
+        }
+        c->saida[k] = *j;
+    }
+}
+
+// Menores distncias at os alvos, andando de trs pra frente nas aes (Dijkstra)
+static void DistanciasAte(const MapaJogador *mapa, const std::vector<std::vector<int>> &anteriores, std::vector<float> *dist) {
+    typedef std::pair<float, int> Item;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> fila;
+    for (size_t i = 0; i < dist->size(); i++)
+        if ((*dist)[i] < SEM_CAMINHO) fila.push(Item((*dist)[i], (int)i));
+    while (!fila.empty()) {
+        Item item = fila.top();
+        fila.pop();
+        if (item.first > (*dist)[item.second]) continue;
+        for (int anterior : anteriores[item.second]) {
+            float d = item.first + PASSOS_POR_ACAO;
+            if (d < (*dist)[anterior]) {
+                (*dist)[anterior] = d;
+                fila.push(Item(d, anterior));
+            }
+        }
+    }
+}
+
+// Menor distncia entre os estados de cada clula s de posio
+static void MenorPorCelula(const MapaJogador *mapa, const std::vector<float> &dist, std::unordered_map<long long, float> *celulas) {
+    for (size_t e = 0; e < dist.size(); e++) {
+        long long chave = ChavePosicao(&mapa->estados[e]);
+        auto achou = celulas->find(chave);
+        if (achou == celulas->end() || dist[e] < achou->second) (*celulas)[chave] = dist[e];
+    }
+}
+
+static void MontarMapa(MapaJogador *mapa, const DadosFase fases[], int numFases, int indice, TipoJogador tipo,
+                       int config, PoolTarefas *pool) {
+    const DadosFase *fase = &fases[indice];
+    int trabalhadores = TrabalhadoresPool(pool);
+    std::vector<Mundo> mundos(trabalhadores);
+    for (int i = 0; i < trabalhadores; i++) {
+        IniciarMundoInteiro(&mundos[i], fases, numFases, indice);
+        CongelarMoveis(&mundos[i], config);
+    }
+
+    mapa->tipo = tipo;
+    Jogador inicio = *JogadorDoTipo(&mundos[0], tipo);
+    mapa->ids[ChaveCelula(&inicio)] = 0;
+    mapa->estados.push_back(inicio);
+
+    // Busca em largura a partir do comeo, uma camada por vez (cada camada em paralelo)
+    std::vector<int> camada(1, 0);
+    std::vector<Jogador> saida;
+    std::vector<signed char> porta, diamante;
+    std::vector<char> valido;
+    while (!camada.empty() && (int)mapa->estados.size() < MAX_ESTADOS_MAPA) {
+        size_t n = camada.size() * ACOES_SOZINHO;
+        saida.resize(n);
+        porta.resize(n);
+        diamante.resize(n);
+        valido.resize(n);
+        ContextoMapa contexto = { mundos.data(), mapa, camada.data(), saida.data(), porta.data(), diamante.data(),
+                                  valido.data(), fase->portas[tipo == JOGADOR_FOGO ? 0 : 1].retangulo,
+                                  fase->diamante, fase->temDiamante };
+        ExecutarTarefas(pool, (int)camada.size(), ExpandirEstadoMapa, &contexto);
+
+        std::vector<int> proxima;
+        for (size_t k = 0; k < camada.size(); k++) {
+            int origem = camada[k];
+            if ((int)mapa->proximos.size() < (origem + 1) * ACOES_SOZINHO) {
+                mapa->proximos.resize((origem + 1) * ACOES_SOZINHO, -1);
+                mapa->tocouPorta.resize((origem + 1) * ACOES_SOZINHO, -1);
+                mapa->tocouDiamante.resize((origem + 1) * ACOES_SOZINHO, -1);
+            }
+            for (int acao = 0; acao < ACOES_SOZINHO; acao++) {
+                size_t i = k * ACOES_SOZINHO + acao;
+                int aresta = origem * ACOES_SOZINHO + acao;
+                if (!valido[i]) continue;
+                mapa->tocouPorta[aresta] = porta[i];
+                mapa->tocouDiamante[aresta] = diamante[i];
+                long long chave = ChaveCelula(&saida[i]);
+                auto achou = mapa->ids.find(chave);
+                int destino;
+                if (achou == mapa->ids.end()) {
+                    destino = (int)mapa->estados.size();
+                    mapa->ids[chave] = destino;
+                    mapa->estados.push_back(saida[i]);
+                    proxima.push_back(destino);
+                } else {
+                    destino = achou->second;
+                }
+                mapa->proximos[aresta] = destino;
+            }
+        }
+        camada.swap(proxima);
+    }
+    mapa->proximos.resize(mapa->estados.size() * ACOES_SOZINHO, -1);
+    mapa->tocouPorta.resize(mapa->estados.size() * ACOES_SOZINHO, -1);
+    mapa->tocouDiamante.resize(mapa->estados.size() * ACOES_SOZINHO, -1);
+
+    // Distncias: primeiro at a porta, depois at o diamante seguido da porta
+    size_t numEstados = mapa->estados.size();
+    std::vector<std::vector<int>> anteriores(numEstados);
+    for (size_t e = 0; e < numEstados; e++)
+        for (int acao = 0; acao < ACOES_SOZINHO; acao++) {
+            int destino = mapa->proximos[e * ACOES_SOZINHO + acao];
+            if (destino >= 0) anteriores[destino].push_back((int)e);
+        }
+
+    mapa->ateporta.assign(numEstados, SEM_CAMINHO);
+    for (size_t e = 0; e < numEstados; e++)
+        for (int acao = 0; acao < ACOES_SOZINHO; acao++) {
+            int p = mapa->tocouPorta[e * ACOES_SOZINHO + acao];
+            if (p >= 0) mapa->ateporta[e] = fminf(mapa->ateporta[e], (float)(p + 1));
+        }
+    DistanciasAte(mapa, anteriores, &mapa->ateporta);
+
+    mapa->ateDiamante.assign(numEstados, SEM_CAMINHO);
+    for (size_t e = 0; e < numEstados; e++)
+        for (int acao = 0; acao < ACOES_SOZINHO; acao++) {
+            int aresta = (int)e * ACOES_SOZINHO + acao;
+            int destino = mapa->proximos[aresta];
+            if (mapa->tocouDiamante[aresta] >= 0 && destino >= 0 && mapa->ateporta[destino] < SEM_CAMINHO)
+                mapa->ateDiamante[e] = fminf(mapa->ateDiamante[e], PASSOS_POR_ACAO + mapa->ateporta[destino]);
+        }
+    DistanciasAte(mapa, anteriores, &mapa->ateDiamante);
+
+    MenorPorCelula(mapa, mapa->ateporta, &mapa->ateportaCelula);
+    MenorPorCelula(mapa, mapa->ateDiamante, &mapa->ateDiamanteCelula);
+
+    // At cada alvo com lugar, com as mveis desta configurao
+    std::vector<float> ateAlvo;
+    mapa->ateAlvoCelula.assign(AlvoDiamante(fase) + 1, std::unordered_map<long long, float>());
+    for (int alvo = 0; alvo <= AlvoDiamante(fase); alvo++) {
+        Rectangle lugar = RetanguloAlvo(&mundos[0], fase, alvo);
+        ateAlvo.assign(numEstados, SEM_CAMINHO);
+        for (size_t e = 0; e < numEstados; e++)
+            if (CheckCollisionRecs(RetanguloJogador(&mapa->estados[e]), lugar)) ateAlvo[e] = 0;
+        DistanciasAte(mapa, anteriores, &ateAlvo);
+        MenorPorCelula(mapa, ateAlvo, &mapa->ateAlvoCelula[alvo]);
+    }
+
+    for (int i = 0; i < trabalhadores; i++) LiberarMundo(&mundos[i]);
+}
+
+// Menor distncia do jogador nas clulas de todas as configuraes (SEM_CAMINHO se a clula no apareceu em nenhuma)
+static float MenorDistancia(const std::unordered_map<long long, float> *celulas[CONFIGS_MOVEIS], const Jogador *j) {
+    long long chave = ChavePosicao(j);
+    float melhor = SEM_CAMINHO;
+    for (int c = 0; c < CONFIGS_MOVEIS; c++) {
+        auto achou = celulas[c]->find(chave);
+        if (achou != celulas[c]->end()) melhor = fminf(melhor, achou->second);
+    }
+    if (melhor < SEM_CAMINHO) return melhor;
+    // Posio que o jogador sozinho no alcana do mesmo jeito (ex.: empurrado pelo outro): usa as vizinhas
+    for (int c = 0; c < CONFIGS_MOVEIS; c++)
+        for (int dx = -1; dx <= 1; dx++)
+            for (int dy = -1; dy <= 1; dy++) {
+                auto achou = celulas[c]->find(chave + dx * 4096 + dy);
+                if (achou != celulas[c]->end()) melhor = fminf(melhor, achou->second);
+            }
+    return melhor;
+}
+
+// Menor distncia do jogador at a porta (ou o diamante e a porta) nos mapas dele
+static float DistanciaNosMapas(const MapaJogador mapas[CONFIGS_MOVEIS], const Jogador *j, bool viaDiamante) {
+    const std::unordered_map<long long, float> *celulas[CONFIGS_MOVEIS];
+    for (int c = 0; c < CONFIGS_MOVEIS; c++) celulas[c] = viaDiamante ? &mapas[c].ateDiamanteCelula : &mapas[c].ateportaCelula;
+    return MenorDistancia(celulas, j);
+}
+
+// Menor distncia do jogador at um alvo com lugar (boto, mvel ou diamante) nos mapas dele
+static float DistanciaAteAlvo(const MapaJogador mapas[CONFIGS_MOVEIS], const Jogador *j, int alvo) {
+    const std::unordered_map<long long, float> *celulas[CONFIGS_MOVEIS];
+    for (int c = 0; c < CONFIGS_MOVEIS; c++) celulas[c] = &mapas[c].ateAlvoCelula[alvo];
+    return MenorDistancia(celulas, j);
+}
+
+typedef struct {
+    MapaJogador fogo[CONFIGS_MOVEIS];
+    MapaJogador agua[CONFIGS_MOVEIS];
+    float velocidadeMaxima;
+} Estimador;
+
+static void MontarEstimador(Estimador *estimador, const DadosFase fases[], int numFases, int indice, PoolTarefas *pool) {
+    const DadosFase *fase = &fases[indice];
+    // Plataforma mvel ativa empurra o jogador junto, ento ele pode andar um pouco mais rpido que o normal
+    float maisRapida = 0;
+    for (int i = 0; i < fase->numPlataformasMoveis; i++) maisRapida = fmaxf(maisRapida, fase->plataformasMoveis[i].velocidade);
+    estimador->velocidadeMaxima = VELOCIDADE_MOVIMENTO + maisRapida;
+    for (int c = 0; c < CONFIGS_MOVEIS; c++) {
+        MontarMapa(&estimador->fogo[c], fases, numFases, indice, JOGADOR_FOGO, c, pool);
+        MontarMapa(&estimador->agua[c], fases, numFases, indice, JOGADOR_AGUA, c, pool);
+    }
+}
+
+// Estimativa de passos at o fim: o jogador mais longe da porta (nos mapas de jogador sozinho) e,
+// se o diamante ainda est l, o que chega mais rpido passando por ele.
+// Clula que nenhum mapa conhece usa a estimativa horizontal.
+static float Estimativa(const DadosFase *fase, const Estimador *est, const EstadoBusca *e, float *soma) {
+    float horizontal = EstimativaHorizontal(fase, e, est->velocidadeMaxima);
+    float fogo = DistanciaNosMapas(est->fogo, &e->fogo, false);
+    float agua = DistanciaNosMapas(est->agua, &e->agua, false);
+    if (fogo >= SEM_CAMINHO || agua >= SEM_CAMINHO) {
+        *soma = horizontal;
+        return horizontal;
+    }
+    *soma = fogo + agua;
+    float h = fmaxf(fogo, agua);
+    if (fase->temDiamante && !e->diamanteColetado) {
+        float viaDiamante = fminf(DistanciaNosMapas(est->fogo, &e->fogo, true), DistanciaNosMapas(est->agua, &e->agua, true));
+        if (viaDiamante < SEM_CAMINHO) h = fmaxf(h, viaDiamante);
+    }
+    return fmaxf(h, horizontal);
+}
+
+// Uma tarefa do pool: todas as aes a partir de um n
+static void ExpandirNo(void *contexto, int tarefa, int trabalhador) {
+    ContextoBusca *c = (ContextoBusca *)contexto;
+    Mundo *m = &c->mundos[trabalhador];
+    const NoBusca *no = &c->lote[tarefa];
+    for (int acao = 0; acao < NUM_ACOES; acao++) {
+        Sucessor *s = &c->sucessores[tarefa * NUM_ACOES + acao];
+        RestaurarEstado(m, &no->estado);
+        s->valido = true;
+        s->venceu = false;
+        s->passos = PASSOS_POR_ACAO;
+        for (int p = 0; p < PASSOS_POR_ACAO; p++) {
+            int r = PassoMundo(m, EntradasDaAcao(acao, p == 0));
+            if (r & (PASSO_MORTE | PASSO_REINICIOU)) {
+                s->valido = false;
+                break;
+            }
+            if (r & PASSO_VITORIA) {
+                // Vencer sem o diamante no serve pro tempo par
+                s->valido = !c->fase->temDiamante || m->diamanteColetado;
+                s->venceu = true;
+                s->passos = p + 1;
+                break;
+            }
+        }
+        if (s->valido) SalvarEstado(m, &s->estado);
+    }
+}
+
+// Erros comuns nos dados da fase. Devolve quantos achou.
+static int ConferirFase(int indice, const DadosFase *fase) {
+    int problemas = 0;
+    for (int i = 0; i < fase->numPlataformas; i++)
+        if (fase->plataformas[i].retangulo.width <= 0 || fase->plataformas[i].retangulo.height <= 0) {
+            printf("  fase %d: plataforma %d tem tamanho zero\n", indice + 1, i + 1);
+            problemas++;
+        }
+    for (int i = 0; i < fase->numPerigos; i++)
+        if (fase->perigos[i].retangulo.width <= 0 || fase->perigos[i].retangulo.height <= 0) {
+            printf("  fase %d: perigo %d tem tamanho zero\n", indice + 1, i + 1);
+            problemas++;
+        }
+    for (int i = 0; i < fase->numBotoes; i++) {
+        if (fase->botoes[i].retangulo.width <= 0 || fase->botoes[i].retangulo.height <= 0) {
+            printf("  fase %d: botao %d tem tamanho zero (numBotoes maior que a lista?)\n", indice + 1, i + 1);
+            problemas++;
+        }
+        if (fase->botoes[i].idAlvo < -1 || fase->botoes[i].idAlvo >= fase->numPlataformasMoveis) {
+            printf("  fase %d: botao %d aponta pra plataforma movel %d, que nao existe\n", indice + 1, i + 1, fase->botoes[i].idAlvo + 1);
+            problemas++;
+        }
+    }
+    for (int i = 0; i < fase->numPlataformasMoveis; i++) {
+        const PlataformaMovel *p = &fase->plataformasMoveis[i];
+        if (p->retangulo.width <= 0 || p->retangulo.height <= 0) {
+            printf("  fase %d: plataforma movel %d tem tamanho zero (numPlataformasMoveis maior que a lista?)\n", indice + 1, i + 1);
+            problemas++;
+        } else if (p->velocidade <= 0 && (p->posInicial.x != p->posFinal.x || p->posInicial.y != p->posFinal.y)) {
+            printf("  fase %d: plataforma movel %d tem velocidade zero\n", indice + 1, i + 1);
+            problemas++;
+        }
+    }
+    for (int i = 0; i < fase->numNosLogicos; i++)
+        if (fase->nosLogicos[i].tipo == LOGICA_TEMPO && fase->nosLogicos[i].passos <= 0) {
+            printf("  fase %d: no logico %d e TEMPO sem passos\n", indice + 1, i + 1);
+            problemas++;
+        }
+    int limites[3] = { fase->numBotoes, fase->numNosLogicos, fase->numPlataformasMoveis };
+    for (int i = 0; i < fase->numLigacoes; i++) {
+        const Ligacao *l = &fase->ligacoes[i];
+        bool origemOk = (l->tipoOrigem == PONTA_BOTAO || l->tipoOrigem == PONTA_LOGICA) && l->origem >= 0 && l->origem < limites[l->tipoOrigem];
+        bool destinoOk = (l->tipoDestino == PONTA_LOGICA || l->tipoDestino == PONTA_MOVEL) && l->destino >= 0 && l->destino < limites[l->tipoDestino];
+        if (!origemOk || !destinoOk) {
+            printf("  fase %d: ligacao %d liga coisas que nao existem (ou de tras pra frente)\n", indice + 1, i + 1);
+            problemas++;
+        }
+    }
+    for (int i = 0; i < fase->numCaminhos; i++) {
+        const CaminhoMovel *c = &fase->caminhos[i];
+        if (c->movel < 0 || c->movel >= fase->numPlataformasMoveis || c->numPontos < 1 || c->primeiroPonto < 0 ||
+            c->primeiroPonto + c->numPontos > fase->numPontosCaminho) {
+            printf("  fase %d: caminho %d aponta pra movel ou pontos que nao existem\n", indice + 1, i + 1);
+            problemas++;
+        }
+    }
+    if (fase->numPortas < 2) {
+        printf("  fase %d: precisa de 2 portas pra ter como vencer\n", indice + 1);
+        problemas++;
+    }
+    return problemas;
+}
+
+// Busca A* de uma fase. Devolve o nmero de passos da soluo (-1 se no achou) e as aes em acoes.
+// peso > 1 multiplica a estimativa: acha soluo com menos ns, mas no necessariamente a mais curta.
+static int ResolverFase(const DadosFase fases[], int numFases, int indice, PoolTarefas *pool, const Estimador *estimador,
+                        long long limiteNos, float peso, std::vector<int> *acoes, long long *nosExpandidos) {
+    const DadosFase *fase = &fases[indice];
+    int trabalhadores = TrabalhadoresPool(pool);
+    std::vector<Mundo> mundos(trabalhadores);
+    for (int i = 0; i < trabalhadores; i++) IniciarMundoInteiro(&mundos[i], fases, numFases, indice);
+
+    std::vector<NoBusca> nos;
+    NoBusca raiz;
+    SalvarEstado(&mundos[0], &raiz.estado);
+    raiz.pai = -1;
+    raiz.acao = -1;
+    raiz.passos = 0;
+    raiz.custo = peso * Estimativa(fase, estimador, &raiz.estado, &raiz.desempate);
+    nos.push_back(raiz);
+
+    // Menor custo primeiro; no empate, quem est mais perto no total
+    auto pior = [&](int a, int b) {
+        if (nos[a].custo != nos[b].custo) return nos[a].custo > nos[b].custo;
+        return nos[a].desempate > nos[b].desempate;
+    };
+    std::priority_queue<int, std::vector<int>, decltype(pior)> abertos(pior);
+    std::unordered_set<unsigned long long> vistos;
+    abertos.push(0);
+    vistos.insert(ChaveEstado(fase, &raiz.estado));
+
+    int melhorPassos = -1, melhorPai = -1, melhorAcao = -1;
+    std::vector<NoBusca> lote;
+    std::vector<Sucessor> sucessores;
+    *nosExpandidos = 0;
+
+    while (!abertos.empty() && *nosExpandidos < limiteNos) {
+        // Achou soluo e nenhum n aberto pode dar uma mais curta
+        if (melhorPassos >= 0 && nos[abertos.top()].custo >= melhorPassos) break;
+
+        lote.clear();
+        std::vector<int> indicesLote;
+        while (!abertos.empty() && (int)lote.size() < trabalhadores * NOS_POR_TRABALHADOR) {
+            int i = abertos.top();
+            abertos.pop();
+            if (melhorPassos >= 0 && nos[i].custo >= melhorPassos) continue;
+            lote.push_back(nos[i]);
+            indicesLote.push_back(i);
+        }
+        if (lote.empty()) break;
+        sucessores.resize(lote.size() * NUM_ACOES);
+
+        ContextoBusca contexto = { fase, mundos.data(), lote.data(), sucessores.data() };
+        ExecutarTarefas(pool, (int)lote.size(), ExpandirNo, &contexto);
+        *nosExpandidos += (long long)lote.size();
+
+        // Junta os resultados na ordem (mesma resposta com qualquer nmero de threads)
+        for (size_t k = 0; k < lote.size(); k++) {
+            for (int acao = 0; acao < NUM_ACOES; acao++) {
+                const Sucessor *s = &sucessores[k * NUM_ACOES + acao];
+                if (!s->valido) continue;
+                int passos = lote[k].passos + s->passos;
+                if (s->venceu) {
+                    if (melhorPassos < 0 || passos < melhorPassos) {
+                        melhorPassos = passos;
+                        melhorPai = indicesLote[k];
+                        melhorAcao = acao;
+                    }
+                    continue;
+                }
+                if (!vistos.insert(ChaveEstado(fase, &s->estado)).second) continue;
+                NoBusca novo;
+                novo.estado = s->estado;
+                novo.pai = indicesLote[k];
+                novo.acao = acao;
+                novo.passos = passos;
+                novo.custo = passos + peso * Estimativa(fase, estimador, &s->estado, &novo.desempate);
+                nos.push_back(novo);
+                abertos.push((int)nos.size() - 1);
+            }
+        }
+    }
+
+    for (int i = 0; i < trabalhadores; i++) LiberarMundo(&mundos[i]);
+    acoes->clear();
+    if (melhorPassos < 0) return -1;
+    acoes->push_back(melhorAcao);
+    for (int i = melhorPai; nos[i].pai >= 0; i = nos[i].pai) acoes->push_back(nos[i].acao);
+    for (size_t a = 0, b = acoes->size() - 1; a < b; a++, b--) {
+        int t = (*acoes)[a];
+        (*acoes)[a] = (*acoes)[b];
+        (*acoes)[b] = t;
+    }
+    return melhorPassos;
+}
+
+// Busca por metas, pra fase em que um jogador tem que segurar um boto enquanto o outro passa (a estimativa da
+// busca conjunta no sabe dos botes). Cada trecho leva um jogador sozinho at um alvo, com o outro parado onde
+// est, numa busca A* guiada pela distncia at o alvo nos mapas; os trechos so juntados por outra A*, nos
+// passos mais a estimativa. A soluo costuma ser mais longa que a da busca conjunta (os dois nunca andam juntos).
+#define NOS_POR_TRECHO 1500
+#define PESO_METAS 2.0f // Peso da estimativa nos trechos e nas metas (aqui a mais curta j no  garantida)
+
+typedef struct {
+    EstadoBusca estado;
+    int alvo[2];              // Alvo do ltimo trecho de cada jogador (-1 = ainda no andou)
+    int passos;
+    int pai;                  // -1 na raiz
+    std::vector<int> acoes;   // Aes conjuntas do trecho que chegou aqui
+} Meta;
+
+typedef struct {
+    int jogador;              // 0 = Fogo, 1 = gua
+    int alvo;
+    bool chegou;
+    bool venceu;
+    EstadoBusca estado;       // Onde o trecho terminou
+    int passos;
+    long long nos;
+    std::vector<int> acoes;
+} Trecho;
+
+typedef struct {
+    const DadosFase *fase;
+    const Estimador *estimador;
+    Mundo *mundos;            // Um por trabalhador
+    const EstadoBusca *origem;
+    Trecho *trechos;
+} ContextoTrechos;
+
+// O jogador k chegou no alvo? Fora o diamante, s conta parado em cima de alguma coisa: o prximo trecho
+// pode ser do outro, e este fica esperando ali
+static bool ChegouNoAlvo(const Mundo *m, const DadosFase *fase, int k, int alvo) {
+    if (alvo == AlvoDiamante(fase)) return m->diamanteColetado;
+    const Jogador *j = &m->jogadores[k];
+    if (!j->podePular) return false;
+    Rectangle rec = RetanguloJogador(j);
+    if (alvo < fase->numBotoes) return CheckCollisionRecs(rec, fase->botoes[alvo].retangulo);
+    if (alvo < AlvoDiamante(fase)) return MovelQueCarrega(&m->contatosJogadores[k]) == alvo - fase->numBotoes;
+    return CheckCollisionRecs(rec, fase->portas[k].retangulo);
+}
+
+// Passos at o alvo nos mapas do jogador k (fora dos mapas, s na horizontal)
+static float EstimativaTrecho(const DadosFase *fase, const Estimador *est, const EstadoBusca *e, int k, int alvo) {
+    const Jogador *j = (k == 0) ? &e->fogo : &e->agua;
+    const MapaJogador *mapas = (k == 0) ? est->fogo : est->agua;
+    float d = (alvo == AlvoPorta(fase)) ? DistanciaNosMapas(mapas, j, false) : DistanciaAteAlvo(mapas, j, alvo);
+    if (d < SEM_CAMINHO) return d;
+    Rectangle lugar;
+    if (alvo == AlvoPorta(fase)) lugar = fase->portas[k].retangulo;
+    else if (alvo < fase->numBotoes) lugar = fase->botoes[alvo].retangulo;
+    else if (alvo < AlvoDiamante(fase)) lugar = e->moveis[alvo - fase->numBotoes];
+    else lugar = fase->diamante;
+    return PassosAte(j->posicao.x, lugar, est->velocidadeMaxima);
+}
+
+// Uma tarefa do pool: um trecho inteiro (busca A* do jogador sozinho, at NOS_POR_TRECHO ns)
+static void BuscarTrecho(void *contexto, int tarefa, int trabalhador) {
+    ContextoTrechos *c = (ContextoTrechos *)contexto;
+    Trecho *t = &c->trechos[tarefa];
+    Mundo *m = &c->mundos[trabalhador];
+    const DadosFase *fase = c->fase;
+    t->chegou = false;
+    t->venceu = false;
+    t->nos = 0;
+    t->acoes.clear();
+
+    std::vector<NoBusca> nos;
+    NoBusca raiz;
+    raiz.estado = *c->origem;
+    raiz.pai = -1;
+    raiz.acao = -1;
+    raiz.passos = 0;
+    raiz.desempate = EstimativaTrecho(fase, c->estimador, &raiz.estado, t->jogador, t->alvo);
+    raiz.custo = PESO_METAS * raiz.desempate;
+    nos.push_back(raiz);
+    // Menor custo primeiro; no empate, quem est mais perto do alvo
+    auto pior = [&](int a, int b) {
+        if (nos[a].custo != nos[b].custo) return nos[a].custo > nos[b].custo;
+        return nos[a].desempate > nos[b].desempate;
+    };
+    std::priority_queue<int, std::vector<int>, decltype(pior)> abertos(pior);
+    std::unordered_set<unsigned long long> vistos;
+    abertos.push(0);
+    vistos.insert(ChaveEstado(fase, &raiz.estado));
+
+    int achou = -1;
+    while (!abertos.empty() && t->nos < NOS_POR_TRECHO && achou < 0) {
+        int i = abertos.top();
+        abertos.pop();
+        t->nos++;
+        for (int a = 0; a < ACOES_SOZINHO && achou < 0; a++) {
+            // Mesma codificao da busca conjunta, com o outro parado
+            int acao = (t->jogador == 0) ? a : a * 6;
+            RestaurarEstado(m, &nos[i].estado);
+            bool valido = true, venceu = false;
+            int passos = PASSOS_POR_ACAO;
+            for (int p = 0; p < PASSOS_POR_ACAO; p++) {
+                int r = PassoMundo(m, EntradasDaAcao(acao, p == 0));
+                if (r & (PASSO_MORTE | PASSO_REINICIOU)) {
+                    valido = false;
+                    break;
+                }
+                if (r & PASSO_VITORIA) {
+                    valido = !fase->temDiamante || m->diamanteColetado;
+                    venceu = true;
+                    passos = p + 1;
+                    break;
+                }
+            }
+            if (!valido) continue;
+            NoBusca novo;
+            SalvarEstado(m, &novo.estado);
+            bool chegou = venceu || ChegouNoAlvo(m, fase, t->jogador, t->alvo);
+            if (!chegou && !vistos.insert(ChaveEstado(fase, &novo.estado)).second) continue;
+            novo.pai = i;
+            novo.acao = acao;
+            novo.passos = nos[i].passos + passos;
+            novo.desempate = chegou ? 0 : EstimativaTrecho(fase, c->estimador, &novo.estado, t->jogador, t->alvo);
+            novo.custo = novo.passos + PESO_METAS * novo.desempate;
+            nos.push_back(novo);
+            if (chegou) {
+                achou = (int)nos.size() - 1;
+                t->venceu = venceu;
+            } else {
+                abertos.push((int)nos.size() - 1);
+            }
+        }
+    }
+    if (achou < 0) return;
+    t->chegou = true;
+    t->estado = nos[achou].estado;
+    t->passos = nos[achou].passos;
+    for (int i = achou; nos[i].pai >= 0; i = nos[i].pai) t->acoes.push_back(nos[i].acao);
+    for (size_t a = 0, b = t->acoes.size() - 1; a < b; a++, b--) {
+        int x = t->acoes[a];
+        t->acoes[a] = t->acoes[b];
+        t->acoes[b] = x;
+    }
+}
+
+// Estimativa da busca por metas: os trechos andam um jogador de cada vez, ento soma o que falta pros dois
+// (mais o desvio de quem passa mais perto do diamante, se ele ainda est l)
+static float EstimativaMetas(const DadosFase *fase, const Estimador *est, const EstadoBusca *e) {
+    float fogo = DistanciaNosMapas(est->fogo, &e->fogo, false);
+    float agua = DistanciaNosMapas(est->agua, &e->agua, false);
+    if (fogo >= SEM_CAMINHO) fogo = PassosAte(e->fogo.posicao.x, fase->portas[0].retangulo, est->velocidadeMaxima);
+    if (agua >= SEM_CAMINHO) agua = PassosAte(e->agua.posicao.x, fase->portas[1].retangulo, est->velocidadeMaxima);
+    float h = fogo + agua;
+    if (fase->temDiamante && !e->diamanteColetado) {
+        float desvio = fminf(DistanciaNosMapas(est->fogo, &e->fogo, true) - fogo, DistanciaNosMapas(est->agua, &e->agua, true) - agua);
+        if (desvio < SEM_CAMINHO / 2) h += fmaxf(desvio, 0.0f);
+    }
+    return h;
+}
+
+// Chave de uma meta: onde cada jogador terminou o ltimo trecho, os botes, o diamante e onde esto as mveis
+static unsigned long long ChaveMeta(const DadosFase *fase, const Meta *meta) {
+    const EstadoBusca *e = &meta->estado;
+    unsigned long long h = 1469598103934665603ULL;
+    h = (h ^ (unsigned long long)(meta->alvo[0] + 1)) * 1099511628211ULL;
+    h = (h ^ (unsigned long long)(meta->alvo[1] + 1)) * 1099511628211ULL;
+    for (int i = 0; i < fase->numPlataformasMoveis; i++) {
+        const PlataformaMovel *p = &fase->plataformasMoveis[i];
+        Rectangle r = e->moveis[i];
+        long long onde = 2;
+        if (r.x == p->posInicial.x && r.y == p->posInicial.y) onde = 0;
+        else if (r.x == p->posFinal.x && r.y == p->posFinal.y) onde = 1;
+        h = (h ^ (unsigned long long)(onde * 2 + ((e->moveisAtivas >> i) & 1u))) * 1099511628211ULL;
+    }
+    h = (h ^ e->botoesApertados) * 1099511628211ULL;
+    return (h ^ (unsigned long long)e->diamanteColetado) * 1099511628211ULL;
+}
+
+// Devolve o nmero de passos da soluo (-1 se no achou) e as aes em acoes, como ResolverFase.
+// limiteNos conta os ns de todos os trechos.
+static int ResolverPorMetas(const DadosFase fases[], int numFases, int indice, PoolTarefas *pool, const Estimador *estimador,
+                            long long limiteNos, std::vector<int> *acoes, long long *nosExpandidos) {
+    const DadosFase *fase = &fases[indice];
+    int trabalhadores = TrabalhadoresPool(pool);
+    std::vector<Mundo> mundos(trabalhadores);
+    for (int i = 0; i < trabalhadores; i++) IniciarMundoInteiro(&mundos[i], fases, numFases, indice);
+
+    std::vector<Meta> metas(1);
+    SalvarEstado(&mundos[0], &metas[0].estado);
+    metas[0].alvo[0] = metas[0].alvo[1] = -1;
+    metas[0].passos = 0;
+    metas[0].pai = -1;
+    typedef std::pair<float, int> Item; // (passos + estimativa, meta)
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> abertos;
+    std::unordered_map<unsigned long long, int> melhores; // Menos passos j vistos em cada chave
+    abertos.push(Item(PESO_METAS * EstimativaMetas(fase, estimador, &metas[0].estado), 0));
+    melhores[ChaveMeta(fase, &metas[0])] = 0;
+
+    int melhorPassos = -1, melhorMeta = -1;
+    std::vector<Trecho> trechos;
+    *nosExpandidos = 0;
+    while (!abertos.empty() && *nosExpandidos < limiteNos) {
+        Item item = abertos.top();
+        abertos.pop();
+        if (melhorPassos >= 0 && item.first >= melhorPassos) break;
+        int atual = item.second;
+        if (melhores[ChaveMeta(fase, &metas[atual])] < metas[atual].passos) continue;
+
+        // Um trecho por jogador e alvo (menos o alvo onde ele j est)
+        EstadoBusca origem = metas[atual].estado;
+        trechos.clear();
+        for (int k = 0; k < 2; k++)
+            for (int alvo = 0; alvo <= AlvoPorta(fase); alvo++) {
+                if (alvo == metas[atual].alvo[k]) continue;
+                if (alvo == AlvoDiamante(fase) && (!fase->temDiamante || origem.diamanteColetado)) continue;
+                Trecho t = Trecho();
+                t.jogador = k;
+                t.alvo = alvo;
+                trechos.push_back(t);
+            }
+        ContextoTrechos contexto = { fase, estimador, mundos.data(), &origem, trechos.data() };
+        ExecutarTarefas(pool, (int)trechos.size(), BuscarTrecho, &contexto);
+
+        // Junta os resultados na ordem (mesma resposta com qualquer nmero de threads)
+        for (const Trecho &t : trechos) {
+            *nosExpandidos += t.nos;
+            if (!t.chegou) continue;
+            Meta nova;
+            nova.estado = t.estado;
+            nova.alvo[0] = metas[atual].alvo[0];
+            nova.alvo[1] = metas[atual].alvo[1];
+            nova.alvo[t.jogador] = t.alvo;
+            nova.passos = metas[atual].passos + t.passos;
+            nova.pai = atual;
+            nova.acoes = t.acoes;
+            if (t.venceu) {
+                if (melhorPassos < 0 || nova.passos < melhorPassos) {
+                    melhorPassos = nova.passos;
+                    metas.push_back(nova);
+                    melhorMeta = (int)metas.size() - 1;
+                }
+                continue;
+            }
+            unsigned long long chave = ChaveMeta(fase, &nova);
+            auto achou = melhores.find(chave);
+            if (achou != melhores.end() && achou->second <= nova.passos) continue;
+            melhores[chave] = nova.passos;
+            metas.push_back(nova);
+            abertos.push(Item(nova.passos + PESO_METAS * EstimativaMetas(fase, estimador, &nova.estado), (int)metas.size() - 1));
+        }
+    }
+
+    for (int i = 0; i < trabalhadores; i++) LiberarMundo(&mundos[i]);
+    acoes->clear();
+    if (melhorPassos < 0) return -1;
+    for (int i = melhorMeta; i > 0; i = metas[i].pai) acoes->insert(acoes->begin(), metas[i].acoes.begin(), metas[i].acoes.end());
+    return melhorPassos;
+}
+
+// Roda as aes de novo do comeo da fase, gravando o replay. Devolve se a soluo vence mesmo; *gravou diz
+// se o replay foi salvo em caminho (s tenta salvar se venceu).
+static bool GravarSolucao(const DadosFase fases[], int numFases, int indice, const std::vector<int> &acoes,
+                          const char *caminho, long long *passos, bool *gravou) {
+    Mundo mundo;
+    IniciarMundo(&mundo, fases, numFases, indice);
+    Replay replay = {0};
+    IniciarGravacao(&replay, &mundo, true);
+    bool venceu = false;
+    for (size_t a = 0; a < acoes.size() && !venceu; a++) {
+        for (int p = 0; p < PASSOS_POR_ACAO && !venceu; p++) {
+            Entradas entradas = EntradasDaAcao(acoes[a], p == 0);
+            int r = PassoMundo(&mundo, entradas);
+            GravarPasso(&replay, entradas, &mundo);
+            if (r & PASSO_VITORIA) venceu = true;
+        }
+    }
+    *passos = replay.numPassos;
+    *gravou = venceu && SalvarReplay(&replay, caminho);
+    LiberarReplay(&replay);
+    LiberarMundo(&mundo);
+    return venceu;
+}
+
+int main(int argc, char **argv) {
+    const char *caminhoPacote = (argc > 1 && strcmp(argv[1], "-") != 0) ? argv[1] : NULL;
+    long long limiteNos = (argc > 2) ? atoll(argv[2]) : 200000;
+    const char *pastaSaida = (argc > 3) ? argv[3] : ".";
+    float peso = (argc > 4) ? (float)atof(argv[4]) : 1.0f;
+    if (limiteNos <= 0 || peso < 1.0f) {
+        fprintf(stderr, "Uso: %s [pacote|-] [limite de nos por fase] [pasta de saida] [peso da estimativa >= 1]\n", argv[0]);
+        return 1;
+    }
+
+    DadosFase dadosPadrao[MAX_FASES];
+    const DadosFase *fases = dadosPadrao;
+    int numFases = MontarDadosFasesPadrao(dadosPadrao);
+    PacoteFases pacote = {0};
+    if (caminhoPacote != NULL) {
+        if (!AbrirPacote(&pacote, caminhoPacote)) return 1;
+        fases = pacote.fases;
+        numFases = pacote.numFases;
+    }
+
+    PoolTarefas *pool = CriarPool(0);
+    printf("%d threads, %d passos por acao, limite de %lld nos por fase, peso %.2f\n", TrabalhadoresPool(pool), PASSOS_POR_ACAO,
+           limiteNos, peso);
+
+    int semSolucao = 0;
+    for (int f = 0; f < numFases; f++) {
+        const DadosFase *fase = &fases[f];
+        printf("Fase %d:\n", f + 1);
+        ConferirFase(f, fase);
+        // O estado da busca guarda s os botes apertados e a posio das mveis: ALTERNA, TEMPO e os
+        // caminhos (tempo andado) guardam mais coisa
+        bool logicaComEstado = fase->numCaminhos > 0;
+        for (int i = 0; i < fase->numNosLogicos; i++)
+            if (fase->nosLogicos[i].tipo == LOGICA_ALTERNA || fase->nosLogicos[i].tipo == LOGICA_TEMPO) logicaComEstado = true;
+        if (fase->numPortas < 2 || fase->numPlataformasMoveis > MAX_MOVEIS_BUSCA || fase->numBotoes > MAX_BOTOES_BUSCA || logicaComEstado) {
+            printf("  nao da pra resolver esta fase\n");
+            semSolucao++;
+            continue;
+        }
+
+        std::vector<int> acoes;
+        long long expandidos = 0, expandidosMetas = 0;
+        auto inicio = std::chrono::steady_clock::now();
+        Estimador *estimador = new Estimador;
+        MontarEstimador(estimador, fases, numFases, f, pool);
+        int passos = ResolverFase(fases, numFases, f, pool, estimador, limiteNos, peso, &acoes, &expandidos);
+        bool limiteAtingido = expandidos >= limiteNos;
+        bool porMetas = false;
+        if (passos < 0) {
+            // N de trecho simula ACOES_SOZINHO aes e n conjunto NUM_ACOES: o mesmo trabalho d mais ns
+            long long limiteMetas = limiteNos * (NUM_ACOES / ACOES_SOZINHO);
+            printf("  busca conjunta sem solucao em %lld nos, tentando por metas\n", expandidos);
+            passos = ResolverPorMetas(fases, numFases, f, pool, estimador, limiteMetas, &acoes, &expandidosMetas);
+            limiteAtingido = limiteAtingido || expandidosMetas >= limiteMetas;
+            porMetas = passos >= 0;
+            expandidos += expandidosMetas;
+        }
+        delete estimador;
+        auto fim = std::chrono::steady_clock::now();
+        double segundos = std::chrono::duration<double>(fim - inicio).count();
+
+        if (passos < 0) {
+            printf("  sem solucao em %lld nos (%.1f s)%s\n", expandidos, segundos,
+                   limiteAtingido ? " - limite atingido, tente um limite maior" : " - a fase nao tem saida");
+            semSolucao++;
+            continue;
+        }
+
+        char caminho[512];
+        snprintf(caminho, sizeof(caminho), "%s/solucao_fase%d.rep", pastaSaida, f + 1);
+        long long passosGravados = 0;
+        bool gravou = false;
+        if (!GravarSolucao(fases, numFases, f, acoes, caminho, &passosGravados, &gravou)) {
+            printf("  ERRO: a solucao achada nao vence quando rodada de novo\n");
+            semSolucao++;
+            continue;
+        }
+        if (!gravou) {
+            printf("  ERRO: nao deu pra gravar %s (a pasta existe?)\n", caminho);
+            semSolucao++;
+            continue;
+        }
+        printf("  resolvida%s: %lld passos = tempo par %.2f s (%lld nos, %.1f s, %.0f nos/s) -> %s\n", porMetas ? " por metas" : "",
+               passosGravados, passosGravados * DT_PASSO, expandidos, segundos, expandidos / segundos, caminho);
+        if (fase->tempoPar > 0 && passosGravados * DT_PASSO < fase->tempoPar - 0.005)
+            printf("  tempo par da fase (%.2f s) pode baixar para %.2f s\n", fase->tempoPar, passosGravados * DT_PASSO);
+    }
+    printf("Roubos de tarefa no pool: %lld\n", RoubosPool(pool));
+
+    DestruirPool(pool);
+    FecharPacote(&pacote);
+    return semSolucao > 0 ? 1 : 0;
+}
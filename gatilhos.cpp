@@ -0,0 +1,336 @@
+// Grafo de gatilhos dos botes (ver gatilhos.h)
+#include "gatilhos.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Tipos dos ns que no so lgicos (depois dos TipoLogica)
+#define NO_BOTAO 100
+#define NO_MOVEL 101
+
+// realloc que aceita n == 0 (devolve um bloco pequeno em vez de NULL)
+static void *Realocar(void *vetor, size_t tamanho, int n) {
+    return realloc(vetor, tamanho * (size_t)(n > 0 ? n : 1));
+}
+
+// N de uma ponta de ligao, ou -1 se a ponta no existe ou no pode estar desse lado
+static int NoDaPonta(const GrafoGatilhos *g, TipoPonta tipo, int id, bool origem) {
+    if (tipo == PONTA_BOTAO && origem && id >= 0 && id < g->numBotoes) return id;
+    if (tipo == PONTA_LOGICA && id >= 0 && id < g->numLogicos) return g->numBotoes + id;
+    if (tipo == PONTA_MOVEL && !origem && id >= 0 && id < g->numMoveis) return g->numBotoes + g->numLogicos + id;
+    return -1;
+}
+
+void MontarGatilhos(GrafoGatilhos *g, const int *alvos, size_t passo, int numBotoes, int numMoveis,
+                    const NoLogico nos[], int numLogicos, const Ligacao ligacoes[], int numLigacoes,
+                    const int inicioAlcance[], const int alcance[]) {
+    g->numBotoes = numBotoes;
+    g->numLogicos = numLogicos;
+    g->numMoveis = numMoveis;
+    int n = g->numNos = numBotoes + numLogicos + numMoveis;
+    int primeiraMovel = numBotoes + numLogicos;
+
+    g->tipos = (unsigned char *)Realocar(g->tipos, sizeof(unsigned char), n);
+    g->passos = (int *)Realocar(g->passos, sizeof(int), n);
+    for (int k = 0; k < n; k++) {
+        g->tipos[k] = (k < numBotoes) ? NO_BOTAO : (k < primeiraMovel) ? (unsigned char)nos[k - numBotoes].tipo : NO_MOVEL;
+        g->passos[k] = (k >= numBotoes && k < primeiraMovel) ? nos[k - numBotoes].passos : 0;
+    }
+
+    // Ligaes vlidas (as do idAlvo primeiro) contadas por origem, depois espalhadas no CSR
+    g->inicioSaidas = (int *)Realocar(g->inicioSaidas, sizeof(int), n + 1);
+    g->numEntradas = (int *)Realocar(g->numEntradas, sizeof(int), n);
+    memset(g->inicioSaidas, 0, sizeof(int) * (size_t)(n + 1));
+    memset(g->numEntradas, 0, sizeof(int) * (size_t)(n > 0 ? n : 1));
+    for (int pass = 0; pass < 2; pass++) {
+        int *posicao = g->inicioSaidas; // Na segunda passada  a prxima posio livre de cada origem
+        for (int b = 0; b < numBotoes; b++) {
+            int alvo = *(const int *)((const char *)alvos + passo * (size_t)b);
+            if (alvo < 0 || alvo >= numMoveis) continue;
+            if (pass == 0) {
+                posicao[b + 1]++;
+                g->numEntradas[primeiraMovel + alvo]++;
+            } else {
+                g->destinos[posicao[b]++] = primeiraMovel + alvo;
+            }
+        }
+        for (int i = 0; i < numLigacoes; i++) {
+            int de = NoDaPonta(g, ligacoes[i].tipoOrigem, ligacoes[i].origem, true);
+            int para = NoDaPonta(g, ligacoes[i].tipoDestino, ligacoes[i].destino, false);
+            if (de < 0 || para < 0) continue;
+            if (pass == 0) {
+                posicao[de + 1]++;
+                g->numEntradas[para]++;
+            } else {
+                g->destinos[posicao[de]++] = para;
+            }
+        }
+        if (pass == 0) {
+            for (int k = 0; k < n; k++) g->inicioSaidas[k + 1] += g->inicioSaidas[k];
+            g->destinos = (int *)Realocar(g->destinos, sizeof(int), g->inicioSaidas[n]);
+        } else {
+            // A segunda passada deixou cada posio no comeo da origem seguinte: volta uma casa
+            memmove(g->inicioSaidas + 1, g->inicioSaidas, sizeof(int) * (size_t)n);
+            g->inicioSaidas[0] = 0;
+        }
+    }
+    int numArestas = g->inicioSaidas[n];
+
+    g->entradasLigadas = (int *)Realocar(g->entradasLigadas, sizeof(int), n);
+    g->estado = (int *)Realocar(g->estado, sizeof(int), n);
+    g->ligado = (bool *)Realocar(g->ligado, sizeof(bool), n);
+    g->naFila = (bool *)Realocar(g->naFila, sizeof(bool), n);
+    g->fila = (int *)Realocar(g->fila, sizeof(int), n);
+    g->temporizadores = (int *)Realocar(g->temporizadores, sizeof(int), numLogicos);
+    g->contatos = (int *)Realocar(g->contatos, sizeof(int), numBotoes);
+    g->novosContatos = (int *)Realocar(g->novosContatos, sizeof(int), numBotoes);
+    // Cada reavaliao muda no mximo um n; o limite delas por passo  numNos + numArestas (ver AvancarGatilhos)
+    g->mudados = (int *)Realocar(g->mudados, sizeof(int), n + numArestas + numBotoes);
+    g->tocados = (int *)Realocar(g->tocados, sizeof(int), n);
+    g->foiTocado = (bool *)Realocar(g->foiTocado, sizeof(bool), n);
+    if (n > 0) memset(g->foiTocado, 0, sizeof(bool) * (size_t)n);
+    g->numTocados = 0;
+
+    g->inicioAlcance = (int *)Realocar(g->inicioAlcance, sizeof(int), numBotoes + 1);
+    if (inicioAlcance != NULL && alcance != NULL) {
+        int numAlcance = inicioAlcance[numBotoes];
+        memcpy(g->inicioAlcance, inicioAlcance, sizeof(int) * (size_t)(numBotoes + 1));
+        g->alcance = (int *)Realocar(g->alcance, sizeof(int), numAlcance > 0 ? numAlcance : 1);
+        if (numAlcance > 0) memcpy(g->alcance, alcance, sizeof(int) * (size_t)numAlcance);
+        ReiniciarGatilhos(g);
+        return;
+    }
+
+    // Mveis que cada boto alcana, andando pelas ligaes (marca = ltimo boto que visitou o n)
+    int *marca = (int *)malloc(sizeof(int) * (size_t)(n > 0 ? n : 1));
+    int *pilha = (int *)malloc(sizeof(int) * (size_t)(n > 0 ? n : 1));
+    for (int k = 0; k < n; k++) marca[k] = -1;
+    int capAlcance = numBotoes > 0 ? numBotoes : 1;
+    g->alcance = (int *)Realocar(g->alcance, sizeof(int), capAlcance);
+    int numAlcance = 0;
+    for (int b = 0; b < numBotoes; b++) {
+        g->inicioAlcance[b] = numAlcance;
+        int topo = 0;
+        pilha[topo++] = b;
+        marca[b] = b;
+        while (topo > 0) {
+            int k = pilha[--topo];
+            if (k >= primeiraMovel) {
+                if (numAlcance == capAlcance) {
+                    capAlcance *= 2;
+                    g->alcance = (int *)realloc(g->alcance, sizeof(int) * (size_t)capAlcance);
+                }
+                g->alcance[numAlcance++] = k - primeiraMovel;
+            }
+            for (int e = g->inicioSaidas[k]; e < g->inicioSaidas[k + 1]; e++) {
+                int d = g->destinos[e];
+                if (marca[d] == b) continue;
+                marca[d] = b;
+                pilha[topo++] = d;
+            }
+        }
+    }
+    g->inicioAlcance[numBotoes] = numAlcance;
+    free(marca);
+    free(pilha);
+
+    ReiniciarGatilhos(g);
+}
+
+void LiberarGatilhos(GrafoGatilhos *g) {
+    free(g->tipos);
+    free(g->passos);
+    free(g->inicioSaidas);
+    free(g->destinos);
+    free(g->numEntradas);
+    free(g->entradasLigadas);
+    free(g->estado);
+    free(g->ligado);
+    free(g->naFila);
+    free(g->inicioAlcance);
+    free(g->alcance);
+    free(g->fila);
+    free(g->temporizadores);
+    free(g->contatos);
+    free(g->novosContatos);
+    free(g->mudados);
+    free(g->tocados);
+    free(g->foiTocado);
+    memset(g, 0, sizeof(*g));
+}
+
+static void EsquecerTocados(GrafoGatilhos *g) {
+    for (int i = 0; i < g->numTocados; i++) g->foiTocado[g->tocados[i]] = false;
+    g->numTocados = 0;
+}
+
+static inline void Tocar(GrafoGatilhos *g, int k) {
+    if (g->foiTocado[k]) return;
+    g->foiTocado[k] = true;
+    g->tocados[g->numTocados++] = k;
+}
+
+void ReiniciarGatilhos(GrafoGatilhos *g) {
+    int n = g->numNos;
+    if (n > 0) {
+        memset(g->entradasLigadas, 0, sizeof(int) * (size_t)n);
+        memset(g->estado, 0, sizeof(int) * (size_t)n);
+        memset(g->ligado, 0, sizeof(bool) * (size_t)n);
+        memset(g->naFila, 0, sizeof(bool) * (size_t)n);
+    }
+    g->inicioFila = 0;
+    g->numFila = 0;
+    g->numTemporizadores = 0;
+    g->numContatos = 0;
+    g->numMudados = 0;
+    EsquecerTocados(g);
+}
+
+static void Enfileirar(GrafoGatilhos *g, int k) {
+    if (g->naFila[k]) return;
+    g->naFila[k] = true;
+    g->fila[(g->inicioFila + g->numFila) % g->numNos] = k;
+    g->numFila++;
+}
+
+// Muda o n k e avisa os destinos dele (as contagens mudam na hora, a reavaliao vai pra fila)
+static void Mudar(GrafoGatilhos *g, int k, bool ligado) {
+    g->ligado[k] = ligado;
+    Tocar(g, k);
+    if (g->tipos[k] == NO_BOTAO || g->tipos[k] == NO_MOVEL) g->mudados[g->numMudados++] = k;
+    for (int e = g->inicioSaidas[k]; e < g->inicioSaidas[k + 1]; e++) {
+        int d = g->destinos[e];
+        Tocar(g, d);
+        if (ligado) {
+            g->entradasLigadas[d]++;
+            if (g->tipos[d] == LOGICA_ALTERNA) g->estado[d] ^= 1;
+        } else {
+            g->entradasLigadas[d]--;
+            // TEMPO que ficou sem entrada comea a contar (ou recomea, se j estava contando)
+            if (g->tipos[d] == LOGICA_TEMPO && g->entradasLigadas[d] == 0 && g->passos[d] > 0) {
+                if (g->estado[d] == 0) g->temporizadores[g->numTemporizadores++] = d;
+                g->estado[d] = g->passos[d];
+            }
+        }
+        Enfileirar(g, d);
+    }
+}
+
+static bool Avaliar(const GrafoGatilhos *g, int k) {
+    switch (g->tipos[k]) {
+        case LOGICA_E: return g->numEntradas[k] > 0 && g->entradasLigadas[k] == g->numEntradas[k];
+        case LOGICA_ALTERNA: return g->estado[k] != 0;
+        case LOGICA_TEMPO: return g->entradasLigadas[k] > 0 || g->estado[k] > 0;
+        default: return g->entradasLigadas[k] > 0; // OU e mvel
+    }
+}
+
+int AvancarGatilhos(GrafoGatilhos *g, const int botoes[], int num) {
+    g->numMudados = 0;
+    EsquecerTocados(g);
+    bool mesmosContatos = num == g->numContatos && memcmp(botoes, g->contatos, sizeof(int) * (size_t)num) == 0;
+    if (mesmosContatos && g->numTemporizadores == 0 && g->numFila == 0) return 0;
+
+    // TEMPO: quem voltou a ter entrada sai da lista, quem acabou de contar  reavaliado. Vem antes dos
+    // contatos pra um TEMPO que comea a contar neste passo s descontar a partir do prximo.
+    int restantes = 0;
+    for (int i = 0; i < g->numTemporizadores; i++) {
+        int k = g->temporizadores[i];
+        Tocar(g, k);
+        if (g->entradasLigadas[k] > 0) {
+            g->estado[k] = 0;
+        } else if (--g->estado[k] == 0) {
+            Enfileirar(g, k);
+        } else {
+            g->temporizadores[restantes++] = k;
+        }
+    }
+    g->numTemporizadores = restantes;
+
+    // Comeo e fim de contato: as duas listas esto em ordem
+    if (!mesmosContatos) {
+        int i = 0, j = 0;
+        while (i < g->numContatos || j < num) {
+            if (j == num || (i < g->numContatos && g->contatos[i] < botoes[j])) {
+                Mudar(g, g->contatos[i++], false);
+            } else if (i == g->numContatos || botoes[j] < g->contatos[i]) {
+                Mudar(g, botoes[j++], true);
+            } else {
+                i++;
+                j++;
+            }
+        }
+        memcpy(g->novosContatos, botoes, sizeof(int) * (size_t)num);
+        int *troca = g->contatos;
+        g->contatos = g->novosContatos;
+        g->novosContatos = troca;
+        g->numContatos = num;
+    }
+
+    // Sem ciclo, cada n  reavaliado no mximo uma vez por entrada que mudou. Com ciclo (ex.: dois ALTERNA
+    // ligados um no outro) o que passar do limite fica na fila pro prximo passo, em vez de travar aqui.
+    int limite = g->numNos + g->inicioSaidas[g->numNos];
+    for (int avaliados = 0; g->numFila > 0 && avaliados < limite; avaliados++) {
+        int k = g->fila[g->inicioFila];
+        g->inicioFila = (g->inicioFila + 1) % g->numNos;
+        g->numFila--;
+        g->naFila[k] = false;
+        Tocar(g, k);
+        bool novo = Avaliar(g, k);
+        if (novo != g->ligado[k]) Mudar(g, k, novo);
+    }
+    return g->numMudados;
+}
+
+void RefazerGatilhos(GrafoGatilhos *g, const int botoes[], int num) {
+    ReiniciarGatilhos(g);
+    AvancarGatilhos(g, botoes, num);
+}
+
+// Tamanhos das listas, uma palavra por n (entradas ligadas, estado, ligado e naFila) e depois as listas.
+// As partes que mudam de tamanho ficam no fim pra no desalinhar o resto entre um estado e o prximo.
+int MaxPalavrasGatilhos(const GrafoGatilhos *g) {
+    return CABECALHO_GATILHOS + PALAVRAS_NO_GATILHO * g->numNos + 2 * g->numNos + g->numBotoes;
+}
+
+void SalvarNoGatilhos(const GrafoGatilhos *g, int k, uint32_t saida[]) {
+    uint32_t *s = &saida[CABECALHO_GATILHOS + PALAVRAS_NO_GATILHO * k];
+    s[0] = (uint32_t)g->entradasLigadas[k];
+    s[1] = (uint32_t)g->estado[k];
+    s[2] = (uint32_t)g->ligado[k] | ((uint32_t)g->naFila[k] << 1);
+}
+
+int SalvarGatilhos(const GrafoGatilhos *g, uint32_t saida[]) {
+    for (int k = 0; k < g->numNos; k++) SalvarNoGatilhos(g, k, saida);
+    return SalvarListasGatilhos(g, saida);
+}
+
+int SalvarListasGatilhos(const GrafoGatilhos *g, uint32_t saida[]) {
+    saida[0] = (uint32_t)g->numFila;
+    saida[1] = (uint32_t)g->numTemporizadores;
+    saida[2] = (uint32_t)g->numContatos;
+    int n = CABECALHO_GATILHOS + PALAVRAS_NO_GATILHO * g->numNos;
+    for (int i = 0; i < g->numFila; i++) saida[n++] = (uint32_t)g->fila[(g->inicioFila + i) % g->numNos];
+    for (int i = 0; i < g->numTemporizadores; i++) saida[n++] = (uint32_t)g->temporizadores[i];
+    for (int i = 0; i < g->numContatos; i++) saida[n++] = (uint32_t)g->contatos[i];
+    return n;
+}
+
+void RestaurarGatilhos(GrafoGatilhos *g, const uint32_t entrada[]) {
+    int n = 0;
+    g->numFila = (int)entrada[n++];
+    g->numTemporizadores = (int)entrada[n++];
+    g->numContatos = (int)entrada[n++];
+    for (int k = 0; k < g->numNos; k++) {
+        g->entradasLigadas[k] = (int)entrada[n++];
+        g->estado[k] = (int)entrada[n++];
+        g->ligado[k] = (entrada[n] & 1) != 0;
+        g->naFila[k] = (entrada[n] & 2) != 0;
+        n++;
+    }
+    g->inicioFila = 0;
+    for (int i = 0; i < g->numFila; i++) g->fila[i] = (int)entrada[n++];
+    for (int i = 0; i < g->numTemporizadores; i++) g->temporizadores[i] = (int)entrada[n++];
+    for (int i = 0; i < g->numContatos; i++) g->contatos[i] = (int)entrada[n++];
+    g->numMudados = 0;
+    EsquecerTocados(g);
+}
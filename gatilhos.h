@@ -0,0 +1,118 @@
+/*
+Grafo de gatilhos: botes, ns lgicos e plataformas mveis ligados uns nos outros.
+Os botes so as entradas, as mveis as sadas e os ns lgicos (OU, E, ALTERNA, TEMPO) ficam no meio;
+uma ligao pode sair de um boto ou n e chegar num n ou mvel, e cada um pode ter quantas quiser.
+O idAlvo de um boto continua valendo como uma ligao direta pra mvel (mvel com vrias entradas  OU).
+
+Nada  refeito a cada passo: s o comeo e o fim do contato com um boto (e o fim de um TEMPO) mudam o grafo,
+e a mudana anda s pelas ligaes que saem do que mudou. Parado, o grafo no custa nada.
+*/
+#ifndef GATILHOS_H
+#define GATILHOS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum {
+    LOGICA_OU,      // Ligado se alguma entrada estiver ligada
+    LOGICA_E,       // Ligado se todas as entradas estiverem ligadas
+    LOGICA_ALTERNA, // Troca de estado cada vez que uma entrada liga (interruptor)
+    LOGICA_TEMPO    // Ligado enquanto alguma entrada est ligada e mais 'passos' passos depois
+} TipoLogica;
+
+// N lgico de uma fase
+typedef struct {
+    TipoLogica tipo;
+    int passos; // S do LOGICA_TEMPO
+} NoLogico;
+
+typedef enum {
+    PONTA_BOTAO,
+    PONTA_LOGICA,
+    PONTA_MOVEL
+} TipoPonta;
+
+// Ligao de uma fase: a origem  um boto ou n lgico e o destino um n lgico ou mvel (ids na fase)
+typedef struct {
+    TipoPonta tipoOrigem;
+    int origem;
+    TipoPonta tipoDestino;
+    int destino;
+} Ligacao;
+
+// Grafo montado ao carregar a fase. Os ns so numerados botes, depois ns lgicos, depois mveis.
+typedef struct {
+    int numBotoes;
+    int numLogicos;
+    int numMoveis;
+    int numNos;
+
+    unsigned char *tipos;  // TipoLogica dos ns lgicos; os botes e as mveis tm tipos prprios
+    int *passos;           // Durao dos TEMPO
+    int *inicioSaidas;     // numNos + 1 posies; destinos do n k ficam em [inicioSaidas[k], inicioSaidas[k+1])
+    int *destinos;
+    int *numEntradas;
+    int *entradasLigadas;  // Quantas entradas esto ligadas agora
+    int *estado;           // ALTERNA: 0/1; TEMPO: passos que faltam depois que as entradas desligaram
+    bool *ligado;
+    bool *naFila;
+    int *inicioAlcance;    // numBotoes + 1 posies: mveis (ids na fase) que cada boto alcana
+    int *alcance;
+
+    int *fila;             // Ns pra reavaliar (circular, numNos posies)
+    int inicioFila;
+    int numFila;
+    int *temporizadores;   // TEMPO com tempo correndo
+    int numTemporizadores;
+    int *contatos;         // Botes encostados no ltimo passo, em ordem
+    int numContatos;
+    int *novosContatos;
+    int *mudados;          // Botes e mveis (ns) que mudaram no ltimo AvancarGatilhos
+    int numMudados;
+    int *tocados;          // Ns com alguma palavra do estado salvo mudada no ltimo AvancarGatilhos (sem repetir)
+    int numTocados;
+    bool *foiTocado;
+} GrafoGatilhos;
+
+// Monta o grafo. alvos aponta pro idAlvo do primeiro boto e passo  a distncia em bytes entre dois botes
+// (igual ao ConstruirGrade). Ligaes com ponta invlida so ignoradas. Comea tudo desligado.
+// inicioAlcance/alcance so as mveis que cada boto alcana j calculadas (fase compilada), copiadas em vez de
+// andar pelo grafo; NULL calcula.
+void MontarGatilhos(GrafoGatilhos *g, const int *alvos, size_t passo, int numBotoes, int numMoveis,
+                    const NoLogico nos[], int numLogicos, const Ligacao ligacoes[], int numLigacoes,
+                    const int inicioAlcance[], const int alcance[]);
+void LiberarGatilhos(GrafoGatilhos *g);
+
+// Desliga tudo (ALTERNA volta pra desligado e os TEMPO param)
+void ReiniciarGatilhos(GrafoGatilhos *g);
+
+// Um passo: botoes so os ids (em ordem crescente, sem repetir) dos botes encostados agora.
+// Compara com o passo anterior, avana os TEMPO e propaga o que mudou. Os botes e mveis que mudaram
+// ficam em g->mudados. Devolve quantos so.
+int AvancarGatilhos(GrafoGatilhos *g, const int botoes[], int num);
+
+// Refaz o grafo do zero com esses botes encostados (pra voltar um estado salvo; ALTERNA e TEMPO desligam)
+void RefazerGatilhos(GrafoGatilhos *g, const int botoes[], int num);
+
+// Estado que muda no grafo (contagens, ALTERNA, TEMPO, fila e contatos) em palavras de 32 bits, pra guardar e
+// voltar exatamente (ver rebobinar.h). Cabe em MaxPalavrasGatilhos palavras; SalvarGatilhos devolve quantas usou.
+// So CABECALHO_GATILHOS palavras, PALAVRAS_NO_GATILHO de cada n e as listas. Depois de um AvancarGatilhos s
+// mudam o cabealho, os ns tocados e as listas: SalvarNoGatilhos e SalvarListasGatilhos escrevem s essas partes,
+// nas mesmas posies do SalvarGatilhos (a segunda devolve o total, como ele).
+#define CABECALHO_GATILHOS 3
+#define PALAVRAS_NO_GATILHO 3
+int MaxPalavrasGatilhos(const GrafoGatilhos *g);
+int SalvarGatilhos(const GrafoGatilhos *g, uint32_t saida[]);
+void SalvarNoGatilhos(const GrafoGatilhos *g, int k, uint32_t saida[]);
+int SalvarListasGatilhos(const GrafoGatilhos *g, uint32_t saida[]);
+void RestaurarGatilhos(GrafoGatilhos *g, const uint32_t entrada[]);
+
+static inline bool BotaoLigado(const GrafoGatilhos *g, int botao) {
+    return g->ligado[botao];
+}
+static inline bool MovelLigada(const GrafoGatilhos *g, int movel) {
+    return g->ligado[g->numBotoes + g->numLogicos + movel];
+}
+
+#endif
@@ -0,0 +1,268 @@
+// Gerador de fases procedural (ver gerador.h)
+#include "gerador.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define ESPESSURA_ANDAR 20
+#define ABERTURA_MIN 80          // Largura das aberturas (o jogador tem 20 px)
+#define ABERTURA_MAX 120
+#define MARGEM_ABERTURA 100      // Cho embaixo de uma abertura vai at essa distncia dos lados dela
+#define MARGEM_CAMINHO 80        // Folga dos lados do trecho protegido
+#define ALTURA_SOLTA 65          // Plataformas soltas e mveis ficam no meio do andar
+#define MAX_ABERTURAS_ANDAR 64
+#define TENTATIVAS_SORTEIO 32
+
+static unsigned int Aleatorio(unsigned int *estado) {
+    unsigned int x = *estado;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *estado = x;
+    return x;
+}
+
+// Inteiro em [minimo, maximo]
+static int Sortear(unsigned int *estado, int minimo, int maximo) {
+    if (maximo <= minimo) return minimo;
+    return minimo + (int)(Aleatorio(estado) % (unsigned int)(maximo - minimo + 1));
+}
+
+// Garante espao pra mais um item no vetor. A parte nova  zerada pra o pacote gravado (com os bytes
+// de alinhamento das structs) sair igual byte a byte.
+static void *Crescer(void *vetor, int *cap, int n, size_t tamanho) {
+    if (n < *cap) return vetor;
+    int capAntiga = *cap;
+    *cap = (*cap > 0) ? *cap * 2 : 64;
+    char *novo = (char *)realloc(vetor, (size_t)*cap * tamanho);
+    memset(novo + (size_t)capAntiga * tamanho, 0, (size_t)(*cap - capAntiga) * tamanho);
+    return novo;
+}
+
+static void AdicionarPlataforma(FaseGerada *f, float x, float y, float w, float h) {
+    f->plataformas = (Plataforma *)Crescer(f->plataformas, &f->capPlataformas, f->dados.numPlataformas, sizeof(Plataforma));
+    f->plataformas[f->dados.numPlataformas++] = (Plataforma){ { x, y, w, h } };
+}
+
+static void AdicionarPerigo(FaseGerada *f, float x, float y, float w, float h, TipoPerigo tipo) {
+    f->perigos = (Perigo *)Crescer(f->perigos, &f->capPerigos, f->dados.numPerigos, sizeof(Perigo));
+    Color cor = (tipo == FOGO) ? RED : (tipo == AGUA) ? SKYBLUE : GREEN;
+    f->perigos[f->dados.numPerigos++] = (Perigo){ { x, y, w, h }, tipo, cor };
+}
+
+// Intervalo [inicio, fim] em x
+typedef struct {
+    int inicio;
+    int fim;
+} Faixa;
+
+static bool Cruza(Faixa a, int inicio, int fim) {
+    return inicio < a.fim && a.inicio < fim;
+}
+
+static bool CruzaAlguma(const Faixa faixas[], int n, int inicio, int fim) {
+    for (int i = 0; i < n; i++)
+        if (Cruza(faixas[i], inicio, fim)) return true;
+    return false;
+}
+
+// Se [inicio, fim] cruza alguma plataforma solta ou caminho de mvel j posto no andar
+static bool OcupadoNoAndar(const FaseGerada *f, int primeiraSolta, int primeiraMovel, int inicio, int fim) {
+    for (int i = primeiraSolta; i < f->dados.numPlataformas; i++) {
+        Rectangle r = f->plataformas[i].retangulo;
+        if (inicio < r.x + r.width && r.x < fim) return true;
+    }
+    for (int i = primeiraMovel; i < f->dados.numPlataformasMoveis; i++) {
+        const PlataformaMovel *m = &f->plataformasMoveis[i];
+        if (inicio < m->posFinal.x + m->retangulo.width && m->posInicial.x < fim) return true;
+    }
+    return false;
+}
+
+// Topo do andar k (0 = cho)
+static float TopoAndar(const FaseGerada *f, int k) {
+    return f->altura - 50 - k * ALTURA_ANDAR;
+}
+
+bool GerarFase(FaseGerada *f, unsigned int semente, int largura, int andares) {
+    if (largura < LARGURA_MIN_GERADA || andares < 1) return false;
+    if (semente == 0) semente = 0x9E3779B9u; // xorshift no sai do zero
+
+    f->largura = (float)largura;
+    f->altura = 50 + (andares - 1) * ALTURA_ANDAR + 100; // Espao em cima do ltimo andar pras portas
+    f->dados.numPlataformas = 0;
+    f->dados.numPerigos = 0;
+    f->dados.numBotoes = 0;
+    f->dados.numPlataformasMoveis = 0;
+    f->dados.temDiamante = false;
+
+    // Aberturas de cada andar (o andar 0  o cho inteiro) e a do caminho
+    int maxAberturas = 1 + largura / 800;
+    if (maxAberturas > MAX_ABERTURAS_ANDAR) maxAberturas = MAX_ABERTURAS_ANDAR;
+    Faixa atual[MAX_ABERTURAS_ANDAR], acima[MAX_ABERTURAS_ANDAR];
+    int numAtual = 0, numAcima = 0;
+
+    // O caminho comea no ponto de partida e termina nas portas, passando pelas aberturas do caminho
+    int partida = Sortear(&semente, 60, largura - 160);
+    int chegada = partida; // x onde o jogador entra no andar atual
+    int andarDiamante = Sortear(&semente, 0, andares - 1);
+
+    // As aberturas de um andar so sorteadas quando se gera o andar de baixo, pra saber onde fica a subida
+    for (int k = 0; k < andares; k++) {
+        float topo = TopoAndar(f, k);
+
+        // Aberturas do andar de cima: nenhuma em cima de abertura deste andar (precisa de cho pra pular)
+        numAcima = 0;
+        int caminhoAcima = 0;
+        if (k + 1 < andares) {
+            int quantas = Sortear(&semente, 1, maxAberturas);
+            for (int a = 0; a < quantas; a++) {
+                for (int t = 0; t < TENTATIVAS_SORTEIO; t++) {
+                    int w = Sortear(&semente, ABERTURA_MIN, ABERTURA_MAX);
+                    int x = Sortear(&semente, 40, largura - 40 - w);
+                    if (CruzaAlguma(atual, numAtual, x - MARGEM_ABERTURA, x + w + MARGEM_ABERTURA)) continue;
+                    if (CruzaAlguma(acima, numAcima, x - MARGEM_ABERTURA, x + w + MARGEM_ABERTURA)) continue;
+                    acima[numAcima++] = (Faixa){ x, x + w };
+                    break;
+                }
+            }
+            if (numAcima == 0) {
+                // No coube nenhuma sorteada: usa o ponto mais longe das aberturas deste andar
+                int melhorX = 40, melhorDistancia = -1;
+                for (int x = 40; x + ABERTURA_MAX < largura - 40; x += 20) {
+                    int distancia = 1 << 30;
+                    for (int i = 0; i < numAtual; i++) {
+                        int d = (x + ABERTURA_MIN / 2) - (atual[i].inicio + atual[i].fim) / 2;
+                        if (d < 0) d = -d;
+                        if (d < distancia) distancia = d;
+                    }
+                    if (distancia > melhorDistancia) {
+                        melhorDistancia = distancia;
+                        melhorX = x;
+                    }
+                }
+                acima[numAcima++] = (Faixa){ melhorX, melhorX + ABERTURA_MIN };
+            }
+            caminhoAcima = Sortear(&semente, 0, numAcima - 1);
+        }
+
+        // Onde o caminho sai deste andar: embaixo da abertura do caminho de cima, ou nas portas no ltimo
+        int saida;
+        if (k + 1 < andares) {
+            saida = (acima[caminhoAcima].inicio + acima[caminhoAcima].fim) / 2;
+        } else {
+            int x = 0;
+            for (int t = 0; t < TENTATIVAS_SORTEIO; t++) {
+                x = Sortear(&semente, 40, largura - 140);
+                if (!CruzaAlguma(atual, numAtual, x - 40, x + 130)) break;
+            }
+            saida = x;
+            f->portas[0] = (Porta){ { (float)x, topo - 40, 40, 40 }, JOGADOR_FOGO, (Color){255,100,100,255} };
+            f->portas[1] = (Porta){ { (float)x + 50, topo - 40, 40, 40 }, JOGADOR_AGUA, (Color){100,100,255,255} };
+        }
+        Faixa protegida = { (chegada < saida ? chegada : saida) - MARGEM_CAMINHO, (chegada > saida ? chegada : saida) + MARGEM_CAMINHO + 90 };
+
+        // Cho do andar: segmentos entre as aberturas deste andar (ordenadas)
+        for (int i = 1; i < numAtual; i++)
+            for (int j = i; j > 0 && atual[j].inicio < atual[j - 1].inicio; j--) {
+                Faixa t = atual[j];
+                atual[j] = atual[j - 1];
+                atual[j - 1] = t;
+            }
+        float altura = (k == 0) ? 50 : ESPESSURA_ANDAR;
+        int x0 = 0;
+        for (int i = 0; i <= numAtual; i++) {
+            int x1 = (i < numAtual) ? atual[i].inicio : largura;
+            if (x1 > x0) AdicionarPlataforma(f, (float)x0, topo, (float)(x1 - x0), altura);
+
+            // Perigos em cima do segmento, fora do caminho
+            int perigos = Sortear(&semente, 0, (x1 - x0) / 250);
+            for (int p = 0; p < perigos; p++) {
+                int w = Sortear(&semente, 40, 120);
+                int x = Sortear(&semente, x0 + 10, x1 - 10 - w);
+                if (x < x0 + 10 || Cruza(protegida, x, x + w)) continue;
+                AdicionarPerigo(f, (float)x, topo - 20, (float)w, 20, (TipoPerigo)Sortear(&semente, 0, 2));
+            }
+            if (i < numAtual) x0 = atual[i].fim;
+        }
+
+        // No meio do andar: plataformas soltas (s vezes com perigo em cima) e mveis com boto no cho.
+        // Nada embaixo das aberturas de cima, seno tampa a subida.
+        if (k + 1 < andares) {
+            float y = topo - ALTURA_SOLTA;
+            int primeiraSolta = f->dados.numPlataformas, primeiraMovel = f->dados.numPlataformasMoveis;
+            int soltas = Sortear(&semente, 0, largura / 300);
+            for (int s = 0; s < soltas; s++) {
+                int w = Sortear(&semente, 60, 140);
+                int x = Sortear(&semente, 10, largura - 10 - w);
+                bool movel = Sortear(&semente, 0, 9) == 0;
+                int fimX = movel ? x + w + Sortear(&semente, 100, 300) : x + w;
+                if (fimX > largura - 10) continue;
+                if (CruzaAlguma(acima, numAcima, x - 40, fimX + 40)) continue;
+                if (CruzaAlguma(atual, numAtual, x - 60, fimX + 60)) continue; // Bateria a cabea de quem sobe
+                if (OcupadoNoAndar(f, primeiraSolta, primeiraMovel, x - 20, fimX + 20)) continue;
+                if (!movel) {
+                    AdicionarPlataforma(f, (float)x, y, (float)w, ESPESSURA_ANDAR);
+                    if (Sortear(&semente, 0, 2) == 0) AdicionarPerigo(f, (float)x + 10, y - 10, (float)w - 20, 10, (TipoPerigo)Sortear(&semente, 0, 2));
+                    continue;
+                }
+                int id = f->dados.numPlataformasMoveis;
+                f->plataformasMoveis = (PlataformaMovel *)Crescer(f->plataformasMoveis, &f->capPlataformasMoveis, id, sizeof(PlataformaMovel));
+                // Campo a campo (e no com literal) pra no copiar lixo nos bytes de alinhamento
+                PlataformaMovel *m = &f->plataformasMoveis[id];
+                m->retangulo = (Rectangle){ (float)x, y, (float)w, ESPESSURA_ANDAR };
+                m->posInicial = (Vector2){ (float)x, y };
+                m->posFinal = (Vector2){ (float)(fimX - w), y };
+                m->ativa = false;
+                m->velocidade = (float)Sortear(&semente, 1, 3);
+                f->dados.numPlataformasMoveis++;
+                // Boto no cho embaixo do comeo da plataforma
+                int b = f->dados.numBotoes;
+                f->botoes = (Botao *)Crescer(f->botoes, &f->capBotoes, b, sizeof(Botao));
+                f->botoes[b].retangulo = (Rectangle){ (float)x, topo - 10, 50, 10 };
+                f->botoes[b].idAlvo = id;
+                f->botoes[b].pressionado = false;
+                f->botoes[b].cor = ORANGE;
+                f->dados.numBotoes++;
+            }
+        }
+
+        // Diamante num andar sorteado, no ponto de sada (todo mundo passa por ali)
+        if (k == andarDiamante) {
+            f->dados.temDiamante = true;
+            f->dados.diamante = (Rectangle){ (float)saida - 8, topo - 30, 16, 16 };
+        }
+
+        chegada = saida;
+        numAtual = numAcima;
+        for (int i = 0; i < numAcima; i++) atual[i] = acima[i];
+    }
+
+    DadosFase *d = &f->dados;
+    d->plataformas = f->plataformas;
+    d->perigos = f->perigos;
+    d->portas = f->portas;
+    d->botoes = f->botoes;
+    d->plataformasMoveis = f->plataformasMoveis;
+    d->nosLogicos = NULL;
+    d->ligacoes = NULL;
+    d->numNosLogicos = 0;
+    d->numLigacoes = 0;
+    d->caminhos = NULL;
+    d->pontosCaminho = NULL;
+    d->numCaminhos = 0;
+    d->numPontosCaminho = 0;
+    d->numPortas = 2;
+    d->posInicialFogo = (Vector2){ (float)partida, TopoAndar(f, 0) - 10 };
+    d->posInicialAgua = (Vector2){ (float)partida + 40, TopoAndar(f, 0) - 10 };
+    d->tempoPar = 0;
+    d->pronta = NULL;
+    return true;
+}
+
+void LiberarFaseGerada(FaseGerada *f) {
+    free(f->plataformas);
+    free(f->perigos);
+    free(f->botoes);
+    free(f->plataformasMoveis);
+    *f = (FaseGerada){0};
+}
@@ -0,0 +1,39 @@
+/*
+Gerador de fases procedural (pra testar o motor com fases grandes).
+A fase  feita de andares de plataformas, um a cada ALTURA_ANDAR px, com aberturas por onde se pula pro
+andar de cima. Cada andar tem uma abertura "do caminho" e embaixo dela sempre tem cho; o trecho do andar
+entre onde se chega e onde se sobe (e o comeo e as portas) fica sem perigo e sem nada na frente, ento
+os dois jogadores sempre conseguem sair do comeo e chegar nas portas, passando pelo diamante.
+Fora do caminho vo perigos dos trs tipos, plataformas soltas e plataformas mveis com boto.
+A mesma semente e o mesmo tamanho do sempre a mesma fase (s conta com inteiros e o xorshift32).
+*/
+#ifndef GERADOR_H
+#define GERADOR_H
+
+#include "simulacao.h"
+
+#define ALTURA_ANDAR 130.0f  // Distncia entre andares (o pulo sobe ~168 px)
+#define LARGURA_MIN_GERADA 400
+
+// Fase gerada: os vetores so da fase (malloc) e dados aponta pra eles
+typedef struct {
+    Plataforma *plataformas;
+    Perigo *perigos;
+    Porta portas[2];
+    Botao *botoes;
+    PlataformaMovel *plataformasMoveis;
+    int capPlataformas;
+    int capPerigos;
+    int capBotoes;
+    int capPlataformasMoveis;
+    float largura;   // Tamanho do mundo da fase
+    float altura;
+    DadosFase dados;
+} FaseGerada;
+
+// largura em px (>= LARGURA_MIN_GERADA) e andares (>= 1). Na primeira vez a FaseGerada tem que estar zerada;
+// gerar de novo reaproveita a memria.
+bool GerarFase(FaseGerada *fase, unsigned int semente, int largura, int andares);
+void LiberarFaseGerada(FaseGerada *fase);
+
+#endif
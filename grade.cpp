@@ -0,0 +1,209 @@
+// Grade uniforme de coliso (ver grade.h)
+#include "grade.h"
+#include <stdlib.h>
+#include <math.h>
+
+// Limite de clulas por item, pra uma fase enorme e vazia no gastar memria  toa
+#define MIN_CELULAS_GRADE 1024
+#define CELULAS_POR_ITEM 4
+
+static const Rectangle *PegarRetangulo(const Rectangle *recs, size_t passo, int i) {
+    return (const Rectangle *)((const char *)recs + passo * (size_t)i);
+}
+
+static int Limitar(int v, int minimo, int maximo) {
+    if (v < minimo) return minimo;
+    if (v > maximo) return maximo;
+    return v;
+}
+
+// Clulas (coluna/linha mnima e mxima) que um retngulo ocupa. Fora da grade vai pra borda.
+static void CelulasDoRetangulo(const GradeColisao *g, Rectangle r, int *c0, int *l0, int *c1, int *l1) {
+    *c0 = Limitar((int)floorf((r.x - g->origemX) / g->tamCelula), 0, g->colunas - 1);
+    *l0 = Limitar((int)floorf((r.y - g->origemY) / g->tamCelula), 0, g->linhas - 1);
+    *c1 = Limitar((int)floorf((r.x + r.width - g->origemX) / g->tamCelula), 0, g->colunas - 1);
+    *l1 = Limitar((int)floorf((r.y + r.height - g->origemY) / g->tamCelula), 0, g->linhas - 1);
+}
+
+// Garante espao num vetor de int sem realocar quando j cabe
+static int *Reservar(int *vetor, int *capacidade, int necessario) {
+    if (necessario <= *capacidade) return vetor;
+    int *novo = (int *)realloc(vetor, sizeof(int) * (size_t)necessario);
+    if (novo == NULL) {
+        free(vetor);
+        *capacidade = 0;
+        return NULL;
+    }
+    *capacidade = necessario;
+    return novo;
+}
+
+// Distribui os itens nas clulas usando as faixas j calculadas em celulasItem
+static void PreencherCelulas(GradeColisao *g) {
+    int numCelulas = g->colunas * g->linhas;
+    for (int c = 0; c <= numCelulas; c++) g->inicioCelula[c] = 0;
+
+    // Conta quantos itens caem em cada clula
+    int total = 0;
+    for (int i = 0; i < g->numItens; i++) {
+        const int *ci = &g->celulasItem[i * 4];
+        for (int l = ci[1]; l <= ci[3]; l++)
+            for (int c = ci[0]; c <= ci[2]; c++) {
+                g->inicioCelula[l * g->colunas + c + 1]++;
+                total++;
+            }
+    }
+    for (int c = 0; c < numCelulas; c++) g->inicioCelula[c + 1] += g->inicioCelula[c];
+
+    g->ids = Reservar(g->ids, &g->capIds, total > 0 ? total : 1);
+
+    // Segunda passada coloca os ids; inicioCelula[c] anda e depois  desfeito
+    for (int i = 0; i < g->numItens; i++) {
+        const int *ci = &g->celulasItem[i * 4];
+        for (int l = ci[1]; l <= ci[3]; l++)
+            for (int c = ci[0]; c <= ci[2]; c++)
+                g->ids[g->inicioCelula[l * g->colunas + c]++] = i;
+    }
+    for (int c = numCelulas; c > 0; c--) g->inicioCelula[c] = g->inicioCelula[c - 1];
+    g->inicioCelula[0] = 0;
+}
+
+void ConstruirGrade(GradeColisao *g, const Rectangle *recs, size_t passo, int n, float tamCelula) {
+    // rea ocupada pelos itens
+    float minX = 0, minY = 0, maxX = 0, maxY = 0;
+    for (int i = 0; i < n; i++) {
+        Rectangle r = *PegarRetangulo(recs, passo, i);
+        if (i == 0) {
+            minX = r.x;
+            minY = r.y;
+            maxX = r.x + r.width;
+            maxY = r.y + r.height;
+        }
+        if (r.x < minX) minX = r.x;
+        if (r.y < minY) minY = r.y;
+        if (r.x + r.width > maxX) maxX = r.x + r.width;
+        if (r.y + r.height > maxY) maxY = r.y + r.height;
+    }
+
+    // Aumenta a clula at caber no limite de memria
+    int limiteCelulas = n * CELULAS_POR_ITEM;
+    if (limiteCelulas < MIN_CELULAS_GRADE) limiteCelulas = MIN_CELULAS_GRADE;
+    int colunas, linhas;
+    for (;;) {
+        colunas = (int)ceilf((maxX - minX) / tamCelula) + 1;
+        linhas = (int)ceilf((maxY - minY) / tamCelula) + 1;
+        if ((long long)colunas * linhas <= limiteCelulas) break;
+        tamCelula *= 2.0f;
+    }
+
+    g->origemX = minX;
+    g->origemY = minY;
+    g->tamCelula = tamCelula;
+    g->colunas = colunas;
+    g->linhas = linhas;
+    g->numItens = n;
+
+    g->inicioCelula = Reservar(g->inicioCelula, &g->capCelulas, colunas * linhas + 1);
+    g->celulasItem = Reservar(g->celulasItem, &g->capItens, (n > 0 ? n : 1) * 4);
+
+    for (int i = 0; i < n; i++) {
+        int *ci = &g->celulasItem[i * 4];
+        CelulasDoRetangulo(g, *PegarRetangulo(recs, passo, i), &ci[0], &ci[1], &ci[2], &ci[3]);
+    }
+    PreencherCelulas(g);
+}
+
+bool AtualizarGrade(GradeColisao *g, const Rectangle *recs, size_t passo, int n) {
+    bool mudou = false;
+    for (int i = 0; i < n; i++) {
+        int c0, l0, c1, l1;
+        int *ci = &g->celulasItem[i * 4];
+        CelulasDoRetangulo(g, *PegarRetangulo(recs, passo, i), &c0, &l0, &c1, &l1);
+        if (c0 != ci[0] || l0 != ci[1] || c1 != ci[2] || l1 != ci[3]) {
+            ci[0] = c0; ci[1] = l0; ci[2] = c1; ci[3] = l1;
+            mudou = true;
+        }
+    }
+    if (mudou) PreencherCelulas(g);
+    return mudou;
+}
+
+bool AtualizarItensGrade(GradeColisao *g, const Rectangle *recs, size_t passo, const int itens[], int num) {
+    bool mudou = false;
+    for (int k = 0; k < num; k++) {
+        int i = itens[k];
+        int c0, l0, c1, l1;
+        int *ci = &g->celulasItem[i * 4];
+        CelulasDoRetangulo(g, *PegarRetangulo(recs, passo, i), &c0, &l0, &c1, &l1);
+        if (c0 != ci[0] || l0 != ci[1] || c1 != ci[2] || l1 != ci[3]) {
+            ci[0] = c0; ci[1] = l0; ci[2] = c1; ci[3] = l1;
+            mudou = true;
+        }
+    }
+    if (mudou) PreencherCelulas(g);
+    return mudou;
+}
+
+static int CompararIds(const void *a, const void *b) {
+    return *(const int *)a - *(const int *)b;
+}
+
+// Ids dos itens nas clulas de area, cada um uma vez. emOrdem insere j ordenado (bom pra listas pequenas),
+// seno s junta e ordena no fim.
+static int ColetarIds(const GradeColisao *g, Rectangle area, int saida[], int maxSaida, bool emOrdem) {
+    if (g->numItens == 0) return 0;
+
+    int c0, l0, c1, l1;
+    CelulasDoRetangulo(g, area, &c0, &l0, &c1, &l1);
+
+    int total = 0;
+    for (int l = l0; l <= l1; l++) {
+        for (int c = c0; c <= c1; c++) {
+            int celula = l * g->colunas + c;
+            for (int k = g->inicioCelula[celula]; k < g->inicioCelula[celula + 1]; k++) {
+                int id = g->ids[k];
+                const int *ci = &g->celulasItem[id * 4];
+                // Item que ocupa vrias clulas s  contado na primeira clula em comum com a rea
+                int primeiraC = ci[0] > c0 ? ci[0] : c0;
+                int primeiraL = ci[1] > l0 ? ci[1] : l0;
+                if (c != primeiraC || l != primeiraL) continue;
+
+                if (total < maxSaida) {
+                    int j = total;
+                    if (emOrdem) {
+                        // Insero ordenada (as listas so pequenas)
+                        while (j > 0 && saida[j - 1] > id) {
+                            saida[j] = saida[j - 1];
+                            j--;
+                        }
+                    }
+                    saida[j] = id;
+                }
+                total++;
+            }
+        }
+    }
+    if (!emOrdem && total <= maxSaida) qsort(saida, (size_t)total, sizeof(int), CompararIds);
+    return total;
+}
+
+int ConsultarGrade(const GradeColisao *g, Rectangle area, int saida[], int maxSaida) {
+    return ColetarIds(g, area, saida, maxSaida, true);
+}
+
+int ConsultarGradeArea(const GradeColisao *g, Rectangle area, int saida[], int maxSaida) {
+    return ColetarIds(g, area, saida, maxSaida, false);
+}
+
+void LiberarGrade(GradeColisao *g) {
+    free(g->inicioCelula);
+    free(g->ids);
+    free(g->celulasItem);
+    g->inicioCelula = NULL;
+    g->ids = NULL;
+    g->celulasItem = NULL;
+    g->capCelulas = 0;
+    g->capIds = 0;
+    g->capItens = 0;
+    g->numItens = 0;
+}
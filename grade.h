@@ -0,0 +1,50 @@
+/*
+Grade uniforme para achar rpido quais retngulos esto perto de uma rea (broadphase).
+Cada clula guarda os ids dos retngulos que encostam nela, tudo num vetor s (formato CSR).
+A consulta no altera a grade, ento vrios jogadores/threads podem consultar ao mesmo tempo.
+*/
+#ifndef GRADE_H
+#define GRADE_H
+
+#include <stddef.h>
+#include "tipos.h"
+
+#define TAM_CELULA_GRADE 64.0f
+
+typedef struct {
+    float origemX;
+    float origemY;
+    float tamCelula;
+    int colunas;
+    int linhas;
+    int numItens;
+
+    int *inicioCelula; // colunas*linhas + 1 posies; ids da clula c ficam em [inicioCelula[c], inicioCelula[c+1])
+    int *ids;
+    int *celulasItem;  // 4 por item: coluna/linha mnima e mxima que o item ocupa
+
+    int capCelulas;    // Capacidades j alocadas, pra recarregar fase sem malloc
+    int capIds;
+    int capItens;
+} GradeColisao;
+
+// Monta a grade. recs aponta pro primeiro Rectangle e passo  a distncia em bytes entre dois itens
+// (assim serve direto pra Plataforma, Perigo, Botao e PlataformaMovel, que comeam com o retngulo).
+void ConstruirGrade(GradeColisao *g, const Rectangle *recs, size_t passo, int n, float tamCelula);
+
+// Reconstri s se algum item mudou de clula (usado pelas plataformas mveis). Devolve true se reconstruiu.
+bool AtualizarGrade(GradeColisao *g, const Rectangle *recs, size_t passo, int n);
+// Igual ao AtualizarGrade, mas s olha os itens listados em itens (os que podem ter andado)
+bool AtualizarItensGrade(GradeColisao *g, const Rectangle *recs, size_t passo, const int itens[], int num);
+
+// Coloca em saida os ids (em ordem crescente e sem repetir) dos itens cujas clulas encostam em area.
+// Devolve quantos existem; se for maior que maxSaida, a lista ficou incompleta e quem chamou deve varrer tudo.
+int ConsultarGrade(const GradeColisao *g, Rectangle area, int saida[], int maxSaida);
+
+// Igual ao ConsultarGrade, pra reas grandes com muitos itens (ordena no fim em vez de inserir em ordem).
+// Se devolver mais que maxSaida a lista no foi ordenada.
+int ConsultarGradeArea(const GradeColisao *g, Rectangle area, int saida[], int maxSaida);
+
+void LiberarGrade(GradeColisao *g);
+
+#endif
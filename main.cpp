@@ -9,689 +9,538 @@ TO DO
 #include "raylib.h"
 #include <stdbool.h>
 #include <stddef.h>
-#include <math.h>
 #include <stdio.h>
-
-// Constantes do cdigo
-#define LARGURA_TELA 800
-#define ALTURA_TELA 600
-#define MAX_PLATAFORMAS 20
-#define MAX_PERIGOS 10
-#define MAX_PORTAS 2
-#define MAX_FASES 3
-#define MAX_BOTOES 5
-#define MAX_PLATAFORMAS_MOVEIS 5
-
-// Constantes para os estados do jogo.
-typedef enum {
-    JOGANDO,
-    FIM_DE_JOGO,
-    VITORIA
-} EstadoJogo;
-
-// Constantes para os tipos de dano/morte.
-typedef enum {
-    FOGO, // Mata somente o cubo azul
-    AGUA, // Mata somente o cubo vermelho
-    TERRA // Mata os 2 cubos
-} TipoPerigo;
-
-// Constantes do jogadores
-typedef enum {
-    JOGADOR_FOGO, // Cubo vermelho
-    JOGADOR_AGUA // Cubo azul
-} TipoJogador;
-
-// Estrutura que representa o jogador
-typedef struct {
-    TipoJogador tipo;
-    Vector2 posicao;
-    Vector2 velocidade;
-    Color cor;
-    bool podePular;
-} Jogador;
-
-// Estrutura para criar uma plataforma
+#include <string.h>
+#include "simulacao.h"
+#include "fases.h"
+#include "pacote.h"
+#include "render.h"
+#include "replay.h"
+#include "rebobinar.h"
+#include "retrato.h"
+#include <stdlib.h>
+#ifdef FASES_COMPILADAS
+#include "fases_compiladas.h" // Gerado pelo compilar_fases (make jogo FASES_JOGO=...)
+#endif
+
+// Nas telas paradas (FIM_DE_JOGO/VITORIA) o teclado  lido s essa quantidade de vezes por segundo
+#define TAXA_TELA_PARADA 15
+// Estrelas pelo tempo par da fase: 3 abaixo de 2x o par, 2 abaixo de 4x
+#define ESTRELAS_VEZES_PAR_3 2.0
+#define ESTRELAS_VEZES_PAR_2 4.0
+// Segurar TECLA_VOLTAR volta no tempo, um passo guardado por passo da fsica, at SEGUNDOS_VOLTAR atrs
+// (o anel usa no mximo MEMORIA_VOLTAR bytes, ver rebobinar.h)
+#define TECLA_VOLTAR KEY_BACKSPACE
+#define SEGUNDOS_VOLTAR 10
+#define MEMORIA_VOLTAR (8 * 1024 * 1024)
+// Jogadores no mesmo teclado (segundo argumento); cada um tem sua linha em TECLAS_JOGADORES
+#define MAX_JOGADORES_LOCAIS 4
+
+// Esquerda, direita e pular de cada jogador local (os pares so Fogo e os mpares gua)
+static const int TECLAS_JOGADORES[MAX_JOGADORES_LOCAIS][3] = {
+    { KEY_A, KEY_D, KEY_W },
+    { KEY_LEFT, KEY_RIGHT, KEY_UP },
+    { KEY_J, KEY_L, KEY_I },
+    { KEY_KP_4, KEY_KP_6, KEY_KP_8 }
+};
+
+// Teclas do jogo num inteiro ( o que passa de uma thread pra outra): 3 bits por jogador local e depois as outras
+#define BIT_TECLA_JOGADOR(k, t) (1u << (3 * (k) + (t)))
+#define BIT_VOLTAR (1u << (3 * MAX_JOGADORES_LOCAIS))
+#define BIT_ENTER  (BIT_VOLTAR << 1)
+#define BIT_F1     (BIT_VOLTAR << 2)
+#define BIT_F5     (BIT_VOLTAR << 3)
+
+
+// Posies do ltimo passo, para o desenho interpolar entre dois passos da fsica
 typedef struct {
-    Rectangle retangulo;
-} Plataforma;
+    Vector2 jogadores[MAX_JOGADORES_LOCAIS];
+    Vector2 *plataformasMoveis;
+    int capacidade;
+} PosicoesAnteriores;
+
+// Guarda s as posies das mveis carregadas
+static void GuardarMoveis(PosicoesAnteriores *anteriores, const Mundo *mundo) {
+    if (mundo->numPlataformasMoveisAtuais > anteriores->capacidade) {
+        free(anteriores->plataformasMoveis);
+        anteriores->plataformasMoveis = (Vector2 *)malloc(sizeof(Vector2) * mundo->numPlataformasMoveisAtuais);
+        anteriores->capacidade = mundo->numPlataformasMoveisAtuais;
+    }
+    for (int i = 0; i < mundo->numPlataformasMoveisAtuais; i++) {
+        anteriores->plataformasMoveis[i] = (Vector2){ mundo->plataformasMoveisAtuais[i].retangulo.x, mundo->plataformasMoveisAtuais[i].retangulo.y };
+    }
+}
 
-// Estrutura para criar algo que mate algum/todos os jogadores
-typedef struct {
-    Rectangle retangulo;
-    TipoPerigo tipo;
-    Color cor;
-} Perigo;
+// Guarda as posies atuais do mundo (chamar antes de cada passo e depois de carregar fase)
+static void GuardarPosicoes(PosicoesAnteriores *anteriores, const Mundo *mundo) {
+    for (int k = 0; k < mundo->numJogadores; k++) anteriores->jogadores[k] = mundo->jogadores[k].posicao;
+    GuardarMoveis(anteriores, mundo);
+}
 
-// Estrutura para criar o fim da fase
-typedef struct {
-    Rectangle retangulo;
-    TipoJogador tipoJogador; // Cor do jogador que deve entrar
-    Color cor; // Cor da porta (Visual)
-} Porta;
+static Vector2 Interpolar(Vector2 a, Vector2 b, float t) {
+    return (Vector2){ a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t };
+}
 
-// Estrutura para criar um boto para ativar objetos mveis das fases
+// Tudo da partida que anda com a fsica: roda na thread principal ou, no modo separado, na da simulao
 typedef struct {
-    Rectangle retangulo;
-    int idAlvo; // Id do objeto mvel
-    bool pressionado;
-    Color cor;
-} Botao;
+    Mundo mundo;
+    int numJogadores;
+    int numFases;
+
+    // A tentativa da fase atual  gravada desde que a fase foi carregada; F5 salva em replay_faseN.rep.
+    // Voltar no tempo invalida a gravao at a prxima fase (o replay s sabe andar pra frente).
+    Replay gravacao;
+    bool gravacaoValida;
+
+    Rebobinador rebobinar;
+    bool voltando;
+
+    double tempoFase;
+    bool progressoCalculado;
+    int estrelasObtidas;
+    bool terminou; // ENTER depois da ltima fase
+
+    bool pular[MAX_JOGADORES_LOCAIS]; // Pulo fica guardado at algum passo da fsica usar
+    PosicoesAnteriores anteriores;
+    Perfilador *perfil;               // NULL no modo separado (o perfil  dos quadros da thread do desenho)
+} Partida;
+
+// Teclas do jogo agora (apertadas) e as que acabaram de ser apertadas (novas); s na thread do raylib
+static unsigned int LerTeclas(int numJogadores, unsigned int *novas) {
+    unsigned int apertadas = 0;
+    *novas = 0;
+    for (int k = 0; k < numJogadores; k++) {
+        for (int t = 0; t < 3; t++) {
+            if (IsKeyDown(TECLAS_JOGADORES[k][t])) apertadas |= BIT_TECLA_JOGADOR(k, t);
+            if (IsKeyPressed(TECLAS_JOGADORES[k][t])) *novas |= BIT_TECLA_JOGADOR(k, t);
+        }
+    }
+    if (IsKeyDown(TECLA_VOLTAR)) apertadas |= BIT_VOLTAR;
+    if (IsKeyPressed(KEY_ENTER)) *novas |= BIT_ENTER;
+    if (IsKeyPressed(KEY_F1)) *novas |= BIT_F1;
+    if (IsKeyPressed(KEY_F5)) *novas |= BIT_F5;
+    return apertadas;
+}
 
-// Estrutura para criar um objeto mvel do cenario
-typedef struct {
-    Rectangle retangulo;
-    Vector2 posInicial;
-    Vector2 posFinal;
-    bool ativa;
-    float velocidade;
-} PlataformaMovel;
-
-// Estrutura para criar uma fase no jogo
-typedef struct {
-    Plataforma plataformas[MAX_PLATAFORMAS];
-    Perigo perigos[MAX_PERIGOS];
-    Porta portas[MAX_PORTAS];
-    Botao botoes[MAX_BOTOES];
-    PlataformaMovel plataformasMoveis[MAX_PLATAFORMAS_MOVEIS];
-    int numPlataformas;
-    int numPerigos;
-    int numPortas;
-    int numBotoes;
-    int numPlataformasMoveis;
-    Vector2 posInicialFogo;
-    Vector2 posInicialAgua;
-    bool temDiamante;
-    Rectangle diamante;
-} Fase;
-
-// Prototipo da funo para carregar uma fase CUIDADO! (SE TU QUEBRAR ESSA FUNO DNV TAREK EU TE MATO -Raphael)
-void CarregarFase(Fase fase, Jogador *fogo, Jogador *agua,
-                  Plataforma plat[], int *nPlat,
-                  Perigo perigos[], int *nPerigos,
-                  Porta portas[], int *nPortas,
-                  Botao botoes[], int *nBotoes,
-                  PlataformaMovel platMoveis[], int *nPlatMoveis,
-                  bool *temDiamante, Rectangle *diamanteRect);
-
-void ResolverColisaoJogadores(Jogador *fogo, Jogador *agua);
-void AtualizarJogador(Jogador *j, Plataforma plat[], int nPlat, PlataformaMovel platMoveis[], int nPlatMoveis, float gravidade);
-void VerificarLimitesEReiniciar(Jogador *fogo, Jogador *agua,Fase fases[], int *faseAtualIndex,Plataforma plat[], int *nPlat,
-                                Perigo perigos[], int *nPerigos, Porta portas[], int *nPortas, Botao botoes[], int *nBotoes,
-                                PlataformaMovel platMoveis[], int *nPlatMoveis,bool *temDiamante, Rectangle *diamanteRect,
-                                bool *diamanteColetado, int *diamantesColetados, double *tempoInicio, bool *progressoCalculado,
-                                int *estrelasObtidas, EstadoJogo *estadoJogo);
-
-
-// Parte principal do cdigo
-int main() {
-    InitWindow(LARGURA_TELA, ALTURA_TELA, "Fogo e Agua - O Templo Invertido");
+// Comeo de fase (carregada ou a prxima): gravao e rebobinador do zero
+static void ComecarFasePartida(Partida *p) {
+    IniciarGravacao(&p->gravacao, &p->mundo, true);
+    p->gravacaoValida = true;
+    ComecarRebobinador(&p->rebobinar, &p->mundo);
+    p->progressoCalculado = false;
+    p->estrelasObtidas = 0;
+    GuardarPosicoes(&p->anteriores, &p->mundo);
+}
 
-    Fase fases[MAX_FASES] = {
-        // Fase 1
-        {
-            .plataformas = {
-                {{ 0, 550, LARGURA_TELA, 50 }}, {{ 0, 400, LARGURA_TELA - 100, 20 }},
-                {{ 100, 250, LARGURA_TELA - 100, 20 }}, {{ 200, 320, 100, 20 }},
-                {{ 600, 300, 100, 20 }}
-            },
-            .perigos = {
-                {{ 300, 530, 150, 20 }, AGUA, SKYBLUE}, {{ 300, 380, 150, 20 }, FOGO, RED},
-                {{ 220, 300, 80, 20 }, AGUA, SKYBLUE}, {{ 420, 450, 100, 20 }, FOGO, RED},
-                {{ 350, 490, 80, 20 }, TERRA, GREEN}
-            },
-            .portas = {
-                {{ LARGURA_TELA - 120, 210, 40, 40 }, JOGADOR_FOGO, (Color){255,100,100,255}},
-                {{ LARGURA_TELA - 70, 210, 40, 40 }, JOGADOR_AGUA, (Color){100,100,255,255}}
-            },
-            .numPlataformas = 5, .numPerigos = 5, .numPortas = 2, .numBotoes = 0, .numPlataformasMoveis = 0,
-            .posInicialFogo = { 60, 540 }, .posInicialAgua = { 100, 540 },
-            .temDiamante = true, .diamante = { 642, 284, 16, 16 }
-        },
-        // Fase 2
-        {
-            .plataformas = {
-                {{ 0, 580, LARGURA_TELA, 20 }}, {{ 0, 450, 250, 20 }},
-                {{ 350, 450, 450, 20 }}, {{ 450, 300, 150, 20 }},
-                {{ 600, 200, 200, 20 }}
-            },
-            .perigos = {
-                {{ 260, 560, 150, 20 }, AGUA, SKYBLUE},
-                {{ 450, 280, 150, 20 }, TERRA, GREEN }
-            },
-            .portas = {
-                {{ LARGURA_TELA - 140, 160, 40, 40 }, JOGADOR_FOGO, (Color){255,100,100,255}},
-                {{ LARGURA_TELA - 90, 160, 40, 40 }, JOGADOR_AGUA, (Color){100,100,255,255}}
-            },
-            .botoes = {
-                {{ 100, 430, 50, 10 }, .idAlvo = 0, .pressionado = false, .cor = DARKBLUE },
-                {{ 750, 430, 50, 10 }, .idAlvo = 1, .pressionado = false, .cor = ORANGE },
-                {{ 695, 190, 50, 10 }, .idAlvo = 1, .pressionado = false, .cor = PURPLE }
-            },
-            .plataformasMoveis = {
-                {{ 300, 370, 20, 100 }, {300, 370}, {300, 270}, false, 1.0f},
-                {{ 500, 430, 50, 20 }, {500, 430}, {500, 220}, false, 1.5f}
-            },
-            .numPlataformas = 5, .numPerigos = 2, .numPortas = 2, .numBotoes = 3, .numPlataformasMoveis = 2,
-            .posInicialFogo = { 60, 570 }, .posInicialAgua = { 100, 570 },
-            .temDiamante = true, .diamante = { 758, 414, 16, 16 }
-        },
-        // FASE 3
-        {
-            .plataformas = {
-                // Seo da gua (Superior Esquerda)
-                { { 0, 120, 150, 20 } },    // 1. Incio gua
-                { { 200, 180, 150, 20 } },  // 2. Aps a primeira ponte
-                // Seo do Fogo (Inferior Direita)
-                { { LARGURA_TELA - 150, 500, 150, 20 } }, // 3. Incio Fogo
-                { { LARGURA_TELA - 350, 420, 150, 20 } }, // 4. Aps a primeira ponte
-                // Seo Central (Encontro)
-                { { 300, 320, 150, 20 } },  // 5. Plataforma central das portas
-                { { 0, 280, 100, 20 } },     // 6. Plataforma do boto do diamante
-                { { 350, 520, 50, 20 } },
-                { { 140, 180, 20, 140} } //8. Plataforma que impede que o player azul pegue um caminho alternativo para o boto do diamante
-            },
-            .perigos = {
-                // Perigos da gua
-                { { 150, 120, 50, 20 }, FOGO, RED },
-                // Perigos do Fogo
-                { { LARGURA_TELA - 200, 500, 50, 20 }, AGUA, SKYBLUE},
-                // Perigo Central
-                { { 150, 580, LARGURA_TELA - 300, 20 }, TERRA, GREEN}
-            },
-            .portas = {
-                { { 335, 280, 40, 40 }, JOGADOR_FOGO, (Color){255,100,100,255} },
-                { { 395, 280, 40, 40 }, JOGADOR_AGUA, (Color){100,100,255,255} }
-            },
-            .botoes = {
-                // Botes de progresso cruzada
-                { { 700, 480, 50, 10 }, .idAlvo = 0, .pressionado = false, .cor = ORANGE },   // Fogo ajuda gua
-                // Boto do diamante (cooperativo)
-                { { 40, 260, 50, 10 }, .idAlvo = 1, .pressionado = false, .cor = PURPLE }
-            },
-            .plataformasMoveis = {
-                // Plataformas de progresso
-                { .retangulo = {150, 160, 100, 20}, .posInicial = {100, 160}, .posFinal = {200, 160}, .ativa = false, .velocidade = 1.0f}, // Ponte para gua
-                // Plataforma do diamante
-                { .retangulo = { 370, 200, 20, 200}, .posInicial = {370, 340}, .posFinal = {370, 280}, .ativa = false, .velocidade = 2.0f} // Porta do diamante
-            },
-            .numPlataformas = 8,.numPerigos = 3,.numPortas = 2,.numBotoes = 3,.numPlataformasMoveis = 3,
-            .posInicialFogo = { LARGURA_TELA - 50, 490 },.posInicialAgua = { 50, 110 },
-            .temDiamante = true,.diamante = { 346, 484, 16, 16 }
+static void CalcularProgresso(Partida *p) {
+    // Tempo contado em passos da fsica, ento no depende do FPS
+    p->tempoFase = p->mundo.passosFase * DT_PASSO;
+    double duracao = p->tempoFase;
+
+    if (p->mundo.temDiamanteAtual && !p->mundo.diamanteColetado) {
+        p->estrelasObtidas = 0;
+    } else {
+        // Sistema para calcular a quantidade de estrelas que um jogador para por passar de fase.
+        // Fase com tempo par (resolver_fases) usa o dobro e o qudruplo dele; sem par, 20 s e 40 s.
+        double limite3 = 20.0, limite2 = 40.0;
+        if (p->mundo.faseAtual->tempoPar > 0) {
+            limite3 = ESTRELAS_VEZES_PAR_3 * p->mundo.faseAtual->tempoPar;
+            limite2 = ESTRELAS_VEZES_PAR_2 * p->mundo.faseAtual->tempoPar;
         }
-    };
-
-    const int numFasesDefinidas = 3; // Define a quantidade de fases que o nosso jogo tem
-    int faseAtualIndex = 0;
-    EstadoJogo estadoJogo = JOGANDO;
-
-    Jogador meninoFogo = { JOGADOR_FOGO, {0,0}, {0,0}, MAROON, false };
-    Jogador meninaAgua = { JOGADOR_AGUA, {0,0}, {0,0}, BLUE, false };
-
-    Plataforma plataformasAtuais[MAX_PLATAFORMAS];
-    Perigo perigosAtuais[MAX_PERIGOS];
-    Porta portasAtuais[MAX_PORTAS];
-    Botao botoesAtuais[MAX_BOTOES];
-    PlataformaMovel plataformasMoveisAtuais[MAX_PLATAFORMAS_MOVEIS];
-
-    int numPlataformasAtuais = 0;
-    int numPerigosAtuais = 0;
-    int numPortasAtuais = 0;
-    int numBotoesAtuais = 0;
-    int numPlataformasMoveisAtuais = 0;
-
-    Rectangle diamante;
-    bool temDiamanteAtual = false;
-    bool diamanteColetado = false;
-    int diamantesColetados = 0;
-    double tempoInicio = 0.0;
-    double tempoFim = 0.0;
-    bool progressoCalculado = false;
-    int estrelasObtidas = 0;
-
-    // Chamada da funo para carregar a fase CUIDADO!
-    CarregarFase(fases[faseAtualIndex], &meninoFogo, &meninaAgua,
-               plataformasAtuais, &numPlataformasAtuais,
-               perigosAtuais, &numPerigosAtuais,
-               portasAtuais, &numPortasAtuais,
-               botoesAtuais, &numBotoesAtuais,
-               plataformasMoveisAtuais, &numPlataformasMoveisAtuais,
-               &temDiamanteAtual, &diamante);
-
-    diamanteColetado = false;
-    diamantesColetados = 0;
-    estrelasObtidas = 0;
-    tempoInicio = GetTime();
-
-    const float gravidade = 0.10f;
-    const float velocidadeMovimento = 4.0f;
-    const float forcaPulo = -5.8f;
-
-    SetTargetFPS(60);
-
-    while (!WindowShouldClose()) {
-        switch (estadoJogo) {
-            case JOGANDO: {
-
-                // Controles dos jogadores
-                 if (IsKeyDown(KEY_A)) meninoFogo.posicao.x -= velocidadeMovimento;
-                 if (IsKeyDown(KEY_D)) meninoFogo.posicao.x += velocidadeMovimento;
-                 if (IsKeyPressed(KEY_W) && meninoFogo.podePular) {
-                     meninoFogo.velocidade.y = forcaPulo;
-                     meninoFogo.podePular = false;
-                 }
-                 if (IsKeyDown(KEY_LEFT)) meninaAgua.posicao.x -= velocidadeMovimento;
-                 if (IsKeyDown(KEY_RIGHT)) meninaAgua.posicao.x += velocidadeMovimento;
-                 if (IsKeyPressed(KEY_UP) && meninaAgua.podePular) {
-                     meninaAgua.velocidade.y = forcaPulo;
-                     meninaAgua.podePular = false;
-                 }
-                // Tecla de DEBUG para passar uma fase
-                if (IsKeyPressed(KEY_F1)) {
-                    faseAtualIndex = (faseAtualIndex + 1) % numFasesDefinidas;
-                    CarregarFase(fases[faseAtualIndex], &meninoFogo, &meninaAgua, plataformasAtuais, &numPlataformasAtuais, perigosAtuais,
-                                 &numPerigosAtuais, portasAtuais, &numPortasAtuais, botoesAtuais, &numBotoesAtuais,
-                                 plataformasMoveisAtuais, &numPlataformasMoveisAtuais, &temDiamanteAtual, &diamante);
-                    diamanteColetado = false;
-                    diamantesColetados = 0;
-                    tempoInicio = GetTime();
-                    progressoCalculado = false;
-                    estrelasObtidas = 0;
-                    printf("[DEBUG] Carregando a proxima fase...\n");
-                    estadoJogo = JOGANDO;
-                }
+        if (duracao < limite3)      p->estrelasObtidas = 3;
+        else if (duracao < limite2) p->estrelasObtidas = 2;
+        else                        p->estrelasObtidas = 1;
+    }
+    p->progressoCalculado = true;
+}
 
-                for (int i = 0; i < numBotoesAtuais; i++) {
-                    botoesAtuais[i].pressionado = false;
-                }
+// Teclas que no so de andar (F1, F5, ENTER e voltar nas telas paradas). Devolve true se o tempo da fsica
+// deve recomear do zero (fase carregada ou reiniciada).
+static bool ComandosPartida(Partida *p, unsigned int apertadas, unsigned int novas) {
+    Mundo *mundo = &p->mundo;
+    if ((novas & BIT_F5) && p->numJogadores == 2) {
+        char caminho[64];
+        snprintf(caminho, sizeof(caminho), "replay_fase%d.rep", p->gravacao.fase + 1);
+        if (!p->gravacaoValida) printf("[DEBUG] Replay nao salvo: a fase voltou no tempo\n");
+        else if (SalvarReplay(&p->gravacao, caminho)) printf("[DEBUG] Replay salvo em %s (%lld passos)\n", caminho, p->gravacao.numPassos);
+    }
 
-                Rectangle recF = { meninoFogo.posicao.x - 10, meninoFogo.posicao.y - 20, 20, 20 };
-                Rectangle recA = { meninaAgua.posicao.x - 10, meninaAgua.posicao.y - 20, 20, 20 };
+    switch (mundo->estado) {
+        case JOGANDO: {
+            for (int k = 0; k < p->numJogadores; k++)
+                if (novas & BIT_TECLA_JOGADOR(k, 2)) p->pular[k] = true;
+
+            // Tecla de DEBUG para passar uma fase
+            bool recomecou = false;
+            if (novas & BIT_F1) {
+                CarregarFaseMundo(mundo, (mundo->faseAtualIndex + 1) % p->numFases);
+                ComecarFasePartida(p);
+                recomecou = true;
+                printf("[DEBUG] Carregando a proxima fase...\n");
+            }
+            p->voltando = (apertadas & BIT_VOLTAR) != 0;
+            return recomecou;
+        }
 
-                for (int i = 0; i < numBotoesAtuais; i++) {
-                    if (CheckCollisionRecs(recF, botoesAtuais[i].retangulo) || CheckCollisionRecs(recA, botoesAtuais[i].retangulo)) {
-                        botoesAtuais[i].pressionado = true;
-                    }
-                }
+        case FIM_DE_JOGO: {
+            bool recarregou;
+            if (novas & BIT_ENTER) {
+                ReiniciarFase(mundo);
+                GuardarPasso(&p->rebobinar, mundo); // D pra voltar pra antes do reincio tambm
+                p->progressoCalculado = false;
+                p->estrelasObtidas = 0;
+                GuardarPosicoes(&p->anteriores, mundo);
+                return true;
+            }
+            if ((apertadas & BIT_VOLTAR) && VoltarPasso(&p->rebobinar, mundo, &recarregou)) {
+                // Volta pra antes da morte e continua voltando no JOGANDO enquanto a tecla estiver apertada
+                p->gravacaoValida = false;
+                GuardarPosicoes(&p->anteriores, mundo);
+                return true;
+            }
+            return false;
+        }
 
-                for (int i = 0; i < numPlataformasMoveisAtuais; i++) {
-                    plataformasMoveisAtuais[i].ativa = false;
-                }
-                for (int i = 0; i < numBotoesAtuais; i++) {
-                    if (botoesAtuais[i].pressionado) {
-                        int idAlvo = botoesAtuais[i].idAlvo;
-                        if (idAlvo >= 0 && idAlvo < numPlataformasMoveisAtuais) {
-                            plataformasMoveisAtuais[idAlvo].ativa = true;
-                        }
-                    }
+        case VITORIA: {
+            if (!p->progressoCalculado) CalcularProgresso(p);
+            if (novas & BIT_ENTER) {
+                if (mundo->faseAtualIndex + 1 < p->numFases) {
+                    printf("[DEBUG] Carregando a fase %d...\n", mundo->faseAtualIndex + 2);
+                    CarregarFaseMundo(mundo, mundo->faseAtualIndex + 1);
+                    ComecarFasePartida(p);
+                    return true;
                 }
+                p->terminou = true;
+            }
+            return false;
+        }
+    }
+    return false;
+}
 
-                for (int i = 0; i < numPlataformasMoveisAtuais; i++) {
-                    PlataformaMovel *p = &plataformasMoveisAtuais[i];
-                    if (p->ativa) {
-                        if (p->retangulo.x < p->posFinal.x) p->retangulo.x = fmin(p->retangulo.x + p->velocidade, p->posFinal.x);
-                        if (p->retangulo.x > p->posFinal.x) p->retangulo.x = fmax(p->retangulo.x - p->velocidade, p->posFinal.x);
-                        if (p->retangulo.y < p->posFinal.y) p->retangulo.y = fmin(p->retangulo.y + p->velocidade, p->posFinal.y);
-                        if (p->retangulo.y > p->posFinal.y) p->retangulo.y = fmax(p->retangulo.y - p->velocidade, p->posFinal.y);
-                    } else {
-                        if (p->retangulo.x < p->posInicial.x) p->retangulo.x = fmin(p->retangulo.x + p->velocidade, p->posInicial.x);
-                        if (p->retangulo.x > p->posInicial.x) p->retangulo.x = fmax(p->retangulo.x - p->velocidade, p->posInicial.x);
-                        if (p->retangulo.y < p->posInicial.y) p->retangulo.y = fmin(p->retangulo.y + p->velocidade, p->posInicial.y);
-                        if (p->retangulo.y > p->posInicial.y) p->retangulo.y = fmax(p->retangulo.y - p->velocidade, p->posInicial.y);
-                    }
-                }
+// Um passo da fsica no JOGANDO: anda (ou volta um passo, com a tecla de voltar)
+static void PassoPartida(Partida *p, unsigned int apertadas) {
+    Mundo *mundo = &p->mundo;
+    if (p->voltando) {
+        // No lugar do passo, volta um (o desenho interpola de trs pra frente)
+        for (int k = 0; k < p->numJogadores; k++) p->pular[k] = false;
+        GuardarPosicoes(&p->anteriores, mundo);
+        bool recarregou;
+        if (VoltarPasso(&p->rebobinar, mundo, &recarregou)) {
+            p->gravacaoValida = false;
+            if (recarregou) GuardarMoveis(&p->anteriores, mundo);
+        }
+        MarcarEtapa(p->perfil, ETAPA_OUTROS);
+        return;
+    }
 
-                AtualizarJogador(&meninoFogo, plataformasAtuais, numPlataformasAtuais, plataformasMoveisAtuais, numPlataformasMoveisAtuais, gravidade);
-                AtualizarJogador(&meninaAgua, plataformasAtuais, numPlataformasAtuais, plataformasMoveisAtuais, numPlataformasMoveisAtuais, gravidade);
-                ResolverColisaoJogadores(&meninoFogo, &meninaAgua);
-
-                VerificarLimitesEReiniciar(
-                    &meninoFogo, &meninaAgua,
-                    fases, &faseAtualIndex,
-                    plataformasAtuais, &numPlataformasAtuais,
-                    perigosAtuais,   &numPerigosAtuais,
-                    portasAtuais,    &numPortasAtuais,
-                    botoesAtuais,    &numBotoesAtuais,
-                    plataformasMoveisAtuais, &numPlataformasMoveisAtuais,
-                    &temDiamanteAtual, &diamante,
-                    &diamanteColetado, &diamantesColetados,
-                    &tempoInicio, &progressoCalculado, &estrelasObtidas,
-                    &estadoJogo
-                );
-
-                if (temDiamanteAtual && !diamanteColetado) {
-                    if (CheckCollisionRecs(recF, diamante) || CheckCollisionRecs(recA, diamante)) {
-                        diamanteColetado = true;
-                        diamantesColetados++;
-                    }
-                }
+    // Controles dos jogadores
+    EntradaJogador entradas[MAX_JOGADORES_LOCAIS];
+    for (int k = 0; k < p->numJogadores; k++) {
+        entradas[k] = (EntradaJogador){ (apertadas & BIT_TECLA_JOGADOR(k, 0)) != 0, (apertadas & BIT_TECLA_JOGADOR(k, 1)) != 0, p->pular[k] };
+        p->pular[k] = false;
+    }
+    MarcarEtapa(p->perfil, ETAPA_ENTRADA);
+
+    GuardarPosicoes(&p->anteriores, mundo);
+    MarcarEtapa(p->perfil, ETAPA_OUTROS);
+    int resultado = PassoMundoJogadores(mundo, entradas, p->numJogadores);
+    if (p->numJogadores == 2 && p->gravacaoValida) GravarPasso(&p->gravacao, (Entradas){ entradas[0], entradas[1] }, mundo);
+    GuardarPasso(&p->rebobinar, mundo);
+    if (resultado & PASSO_PEDACOS) {
+        // As mveis carregadas mudaram de ndice: neste passo elas no interpolam (os jogadores sim)
+        GuardarMoveis(&p->anteriores, mundo);
+    }
+    if (resultado & PASSO_REINICIOU) {
+        GuardarPosicoes(&p->anteriores, mundo); // No interpola o teleporte pro incio
+        p->progressoCalculado = false;
+        p->estrelasObtidas = 0;
+    }
+    // J com as estrelas: a tela da vitria pode ser desenhada direto deste retrato
+    if (mundo->estado == VITORIA) CalcularProgresso(p);
+    MarcarEtapa(p->perfil, ETAPA_OUTROS);
+}
 
-                for (int i = 0; i < numPerigosAtuais; i++) {
-                    if (perigosAtuais[i].tipo == AGUA && CheckCollisionRecs(recF, perigosAtuais[i].retangulo))
-                        estadoJogo = FIM_DE_JOGO;
-                    if (perigosAtuais[i].tipo == FOGO && CheckCollisionRecs(recA, perigosAtuais[i].retangulo))
-                        estadoJogo = FIM_DE_JOGO;
-                    if (perigosAtuais[i].tipo == TERRA && (CheckCollisionRecs(recF, perigosAtuais[i].retangulo) || CheckCollisionRecs(recA, perigosAtuais[i].retangulo)))
-                        estadoJogo = FIM_DE_JOGO;
-                }
+// Retrato do passo atual pro desenho, com os nmeros da tela
+static void RetratarPartida(const Partida *p, RetratoMundo *r) {
+    PreencherRetrato(r, &p->mundo, p->anteriores.jogadores, p->anteriores.plataformasMoveis);
+    r->voltando = p->voltando;
+    r->segundosGuardados = (float)(p->rebobinar.numPassos * DT_PASSO);
+    r->tempoFase = p->tempoFase;
+    r->estrelas = p->estrelasObtidas;
+    r->terminou = p->terminou;
+}
 
-                bool fogoNaPorta = CheckCollisionRecs((Rectangle){meninoFogo.posicao.x-10, meninoFogo.posicao.y-20,20,20}, portasAtuais[0].retangulo);
-                bool aguaNaPorta = CheckCollisionRecs((Rectangle){meninaAgua.posicao.x-10, meninaAgua.posicao.y-20,20,20}, portasAtuais[1].retangulo);
-                if (fogoNaPorta && aguaNaPorta) estadoJogo = VITORIA;
-
-            } break;
-
-            case FIM_DE_JOGO: {
-                 if (IsKeyPressed(KEY_ENTER)) {
-                     CarregarFase(fases[faseAtualIndex], &meninoFogo, &meninaAgua, plataformasAtuais, &numPlataformasAtuais, perigosAtuais,
-                                  &numPerigosAtuais, portasAtuais, &numPortasAtuais, botoesAtuais, &numBotoesAtuais,
-                                  plataformasMoveisAtuais, &numPlataformasMoveisAtuais, &temDiamanteAtual, &diamante);
-                     diamanteColetado = false;
-                     diamantesColetados = 0;
-                     tempoInicio = GetTime();
-                     progressoCalculado = false;
-                     estrelasObtidas = 0;
-                     estadoJogo = JOGANDO;
-                 }
-            } break;
-
-            case VITORIA: {
-                if (!progressoCalculado) {
-                    tempoFim = GetTime();
-                    double duracao = tempoFim - tempoInicio;
-
-                    if (temDiamanteAtual && !diamanteColetado) {
-                        estrelasObtidas = 0;
-                    } else {
-                        // Sistema para calcular a quantidade de estrelas que um jogador para por passar de fase
-                        if (duracao < 20.0)      estrelasObtidas = 3;
-                        else if (duracao < 40.0) estrelasObtidas = 2;
-                        else                     estrelasObtidas = 1;
-                    }
-                    progressoCalculado = true;
-                }
+// Modo separado: a thread da simulao recebe as teclas, anda um passo e publica o retrato
+typedef struct {
+    Partida *partida;
+    CaixaTeclas *teclas;
+    TrocaRetratos *retratos;
+} ContextoSimulacao;
+
+static void PassoThreadSimulacao(void *contexto) {
+    ContextoSimulacao *t = (ContextoSimulacao *)contexto;
+    Partida *p = t->partida;
+    if (p->terminou) return;
+    unsigned int novas;
+    unsigned int apertadas = ReceberTeclas(t->teclas, &novas);
+    EstadoJogo estado = p->mundo.estado;
+    ComandosPartida(p, apertadas, novas);
+    if (estado == JOGANDO && p->mundo.estado == JOGANDO) PassoPartida(p, apertadas);
+    RetratarPartida(p, RetratoParaEscrever(t->retratos));
+    PublicarRetrato(t->retratos);
+}
 
-                if (IsKeyPressed(KEY_ENTER)) {
-                    faseAtualIndex++;
-                    if (faseAtualIndex < numFasesDefinidas) {
-                        printf("[DEBUG] Carregando a fase %d...\n", faseAtualIndex+1);
-                        CarregarFase(fases[faseAtualIndex], &meninoFogo, &meninaAgua, plataformasAtuais, &numPlataformasAtuais, perigosAtuais,
-                                     &numPerigosAtuais, portasAtuais, &numPortasAtuais, botoesAtuais, &numBotoesAtuais,
-                                     plataformasMoveisAtuais, &numPlataformasMoveisAtuais, &temDiamanteAtual, &diamante);
-                        diamanteColetado = false;
-                        diamantesColetados = 0;
-                        tempoInicio = GetTime();
-                        progressoCalculado = false;
-                        estrelasObtidas = 0;
-                        estadoJogo = JOGANDO;
-                    } else {
-                        CloseWindow();
-                    }
-                }
-            } break;
+// Cena e textos de um retrato; alfa  a frao do caminho entre a posio de antes e a de depois do passo
+static void DesenharQuadro(Renderizador *render, const RetratoMundo *retrato, float alfa, bool mostrarContador) {
+    int numJogadores = retrato->numJogadores;
+    Vector2 posJogadores[MAX_JOGADORES_LOCAIS];
+    for (int k = 0; k < numJogadores; k++)
+        posJogadores[k] = Interpolar(retrato->jogadores[k].anterior, retrato->jogadores[k].posicao, alfa);
+
+    // Cmera no meio dos jogadores (parada se a fase  do tamanho da tela)
+    Camera2D camera = CameraDosJogadores(retrato, posJogadores, numJogadores);
+    Rectangle visivel = AreaDaCamera(camera);
+
+    BeginMode2D(camera);
+        DesenharCenarioEstatico(render, retrato, visivel);
+        DesenharMoveisDescarregados(render, retrato, visivel);
+
+        for (int i = 0; i < retrato->numMoveis; i++) {
+            Rectangle r = retrato->moveis[i].retangulo;
+            Vector2 pos = Interpolar(retrato->moveis[i].anterior, (Vector2){ r.x, r.y }, alfa);
+            DesenharRetangulo(render, (Rectangle){ pos.x, pos.y, r.width, r.height }, (Color){100, 100, 100, 255});
         }
+        for (int i = 0; i < retrato->numBotoes; i++)
+            DesenharRetangulo(render, retrato->botoes[i].retangulo, retrato->botoes[i].pressionado ? LIME : retrato->botoes[i].cor);
 
-        BeginDrawing();
-            ClearBackground((Color){240,240,240,255});
-
-            for (int i = 0; i < numPlataformasAtuais; i++)
-                DrawRectangleRec(plataformasAtuais[i].retangulo, DARKGRAY);
-            for (int i = 0; i < numPlataformasMoveisAtuais; i++)
-                DrawRectangleRec(plataformasMoveisAtuais[i].retangulo, (Color){100, 100, 100, 255});
-            for (int i = 0; i < numBotoesAtuais; i++)
-                DrawRectangleRec(botoesAtuais[i].retangulo, botoesAtuais[i].pressionado ? LIME : botoesAtuais[i].cor);
-
-            for (int i = 0; i < numPerigosAtuais; i++)
-                DrawRectangleRec(perigosAtuais[i].retangulo, perigosAtuais[i].cor);
-            for (int i = 0; i < numPortasAtuais; i++)
-                DrawRectangleRec(portasAtuais[i].retangulo, portasAtuais[i].cor);
+        for (int k = 0; k < numJogadores; k++)
+            DesenharRetangulo(render, (Rectangle){ posJogadores[k].x - 10, posJogadores[k].y - 20, 20, 20 }, retrato->jogadores[k].cor);
 
-            DrawRectangle(meninoFogo.posicao.x - 10, meninoFogo.posicao.y - 20, 20, 20, meninoFogo.cor);
-            DrawRectangle(meninaAgua.posicao.x - 10, meninaAgua.posicao.y - 20, 20, 20, meninaAgua.cor);
-
-            if (estadoJogo == JOGANDO && temDiamanteAtual && !diamanteColetado) {
-                DrawRectangleRec(diamante, GOLD);
-            }
+        if (retrato->estado == JOGANDO && retrato->mostrarDiamante) {
+            DesenharRetangulo(render, retrato->diamante, GOLD);
+        }
+    EndMode2D();
 
-            DrawText(TextFormat("Fase %d", faseAtualIndex + 1), LARGURA_TELA - 100, 10, 20, LIGHTGRAY);
-            if (estadoJogo == JOGANDO) {
-                DrawText("Fogo: WASD | Agua: Setas", 10, 10, 20, DARKGRAY);
-            } else if (estadoJogo == FIM_DE_JOGO) {
-                DrawText("FIM DE JOGO", LARGURA_TELA/2 - MeasureText("FIM DE JOGO",40)/2, ALTURA_TELA/2 - 40, 40, GRAY);
-                DrawText("Pressione ENTER para reiniciar a fase", LARGURA_TELA/2 - MeasureText("Pressione ENTER para reiniciar a fase",20)/2, ALTURA_TELA/2 + 10, 20, GRAY);
-            } else if (estadoJogo == VITORIA) {
-                int boxW = 400, boxH = 220;
-                int boxX = LARGURA_TELA/2 - boxW/2;
-                int boxY = ALTURA_TELA/2 - 80;
-                DrawRectangle(boxX, boxY, boxW, boxH, Fade(BLACK, 0.5f));
-                const char *titulo = "VITORIA!";
-                int fsTitle = 40;
-                int wTitle = MeasureText(titulo, fsTitle);
-                DrawText(titulo, LARGURA_TELA/2 - wTitle/2 + 2, ALTURA_TELA/2 - 50 + 2, fsTitle, BLACK);
-                DrawText(titulo, LARGURA_TELA/2 - wTitle/2, ALTURA_TELA/2 - 50, fsTitle, GOLD);
-                const char *instr = (faseAtualIndex + 1 < numFasesDefinidas) ? "Pressione ENTER para a proxima fase" : "Parabens! Voce completou o jogo!";
-                int fsInstr = 20;
-                int wInstr = MeasureText(instr, fsInstr);
-                DrawText(instr, LARGURA_TELA/2 - wInstr/2, ALTURA_TELA/2 - 10, fsInstr, GOLD);
-                int fsStat = 28;
-                char buf[64];
-                int y0 = ALTURA_TELA/2 + 30;
-                sprintf(buf, "Tempo: %.2f s", tempoFim - tempoInicio);
-                int wx = MeasureText(buf, fsStat);
-                DrawText(buf, LARGURA_TELA/2 - wx/2, y0 + 0, fsStat, WHITE);
-                sprintf(buf, "Diamantes: %d", diamantesColetados);
-                wx = MeasureText(buf, fsStat);
-                DrawText(buf, LARGURA_TELA/2 - wx/2, y0 + 40, fsStat, WHITE);
-                sprintf(buf, "Estrelas: %d", estrelasObtidas);
-                wx = MeasureText(buf, fsStat);
-                DrawText(buf, LARGURA_TELA/2 - wx/2, y0 + 80, fsStat, WHITE);
-            }
-        EndDrawing();
+    if (mostrarContador) {
+        DrawText(TextFormat("Desenhos: %d (sem camada: %d)%s", render->chamadas, render->chamadasSemCamada,
+                            render->usarCamada ? "" : " [camada desligada]"), 10, ALTURA_TELA - 30, 20, DARKGRAY);
     }
 
-    CloseWindow();
-    return 0;
+    DrawText(TextFormat("Fase %d", retrato->faseIndex + 1), LARGURA_TELA - 100, 10, 20, LIGHTGRAY);
+    if (retrato->estado == JOGANDO) {
+        DrawText((numJogadores > 2) ? "Fogo: WAD, JLI | Agua: Setas, 468 (numerico)" : "Fogo: WASD | Agua: Setas", 10, 10, 20, DARKGRAY);
+        if (retrato->voltando) DrawText(TextFormat("<< Voltando (%.1f s guardados)", retrato->segundosGuardados), 10, 35, 20, DARKGRAY);
+    } else if (retrato->estado == FIM_DE_JOGO) {
+        DrawText("FIM DE JOGO", LARGURA_TELA/2 - MeasureText("FIM DE JOGO",40)/2, ALTURA_TELA/2 - 40, 40, GRAY);
+        DrawText("Pressione ENTER para reiniciar a fase", LARGURA_TELA/2 - MeasureText("Pressione ENTER para reiniciar a fase",20)/2, ALTURA_TELA/2 + 10, 20, GRAY);
+        DrawText("ou segure BACKSPACE para voltar no tempo", LARGURA_TELA/2 - MeasureText("ou segure BACKSPACE para voltar no tempo",20)/2, ALTURA_TELA/2 + 35, 20, GRAY);
+    } else if (retrato->estado == VITORIA) {
+        int boxW = 400, boxH = 220;
+        int boxX = LARGURA_TELA/2 - boxW/2;
+        int boxY = ALTURA_TELA/2 - 80;
+        DrawRectangle(boxX, boxY, boxW, boxH, Fade(BLACK, 0.5f));
+        const char *titulo = "VITORIA!";
+        int fsTitle = 40;
+        int wTitle = MeasureText(titulo, fsTitle);
+        DrawText(titulo, LARGURA_TELA/2 - wTitle/2 + 2, ALTURA_TELA/2 - 50 + 2, fsTitle, BLACK);
+        DrawText(titulo, LARGURA_TELA/2 - wTitle/2, ALTURA_TELA/2 - 50, fsTitle, GOLD);
+        const char *instr = (retrato->faseIndex + 1 < retrato->numFases) ? "Pressione ENTER para a proxima fase" : "Parabens! Voce completou o jogo!";
+        int fsInstr = 20;
+        int wInstr = MeasureText(instr, fsInstr);
+        DrawText(instr, LARGURA_TELA/2 - wInstr/2, ALTURA_TELA/2 - 10, fsInstr, GOLD);
+        int fsStat = 28;
+        char buf[64];
+        int y0 = ALTURA_TELA/2 + 30;
+        sprintf(buf, "Tempo: %.2f s", retrato->tempoFase);
+        int wx = MeasureText(buf, fsStat);
+        DrawText(buf, LARGURA_TELA/2 - wx/2, y0 + 0, fsStat, WHITE);
+        sprintf(buf, "Diamantes: %d", retrato->diamantesColetados);
+        wx = MeasureText(buf, fsStat);
+        DrawText(buf, LARGURA_TELA/2 - wx/2, y0 + 40, fsStat, WHITE);
+        sprintf(buf, "Estrelas: %d", retrato->estrelas);
+        wx = MeasureText(buf, fsStat);
+        DrawText(buf, LARGURA_TELA/2 - wx/2, y0 + 80, fsStat, WHITE);
+    }
 }
 
-// Parte do cdigo que cria a funo mais importante do jogo CUIDADO! (Especialmente vc Tarek)
-void CarregarFase(Fase fase, Jogador *fogo, Jogador *agua,
-                  Plataforma plat[], int *nPlat,
-                  Perigo perigos[], int *nPerigos,
-                  Porta portas[], int *nPortas,
-                  Botao botoes[], int *nBotoes,
-                  PlataformaMovel platMoveis[], int *nPlatMoveis,
-                  bool *temDiamante, Rectangle *diamanteRect) {
-    fogo->posicao = fase.posInicialFogo;
-    agua->posicao = fase.posInicialAgua;
-    fogo->velocidade = (Vector2){0};
-    agua->velocidade = (Vector2){0};
-    *nPlat = fase.numPlataformas;
-    *nPerigos = fase.numPerigos;
-    *nPortas = fase.numPortas;
-    *nBotoes = fase.numBotoes;
-    *nPlatMoveis = fase.numPlataformasMoveis;
-
-    for (int i = 0; i < *nPlat; i++) plat[i] = fase.plataformas[i];
-    for (int i = 0; i < *nPerigos; i++) perigos[i] = fase.perigos[i];
-    for (int i = 0; i < *nPortas; i++) portas[i] = fase.portas[i];
-    for (int i = 0; i < *nBotoes; i++) botoes[i] = fase.botoes[i];
-    for (int i = 0; i < *nPlatMoveis; i++) platMoveis[i] = fase.plataformasMoveis[i];
-
-    *temDiamante = fase.temDiamante;
-    *diamanteRect = fase.diamante;
-}
+// Parte principal do cdigo (jogo [pacote de fases|-] [jogadores] [separado])
+int main(int argc, char **argv) {
+    // Sem limite de FPS: o desenho acompanha o monitor e a fsica roda sempre a TAXA_PASSOS
+    SetConfigFlags(FLAG_VSYNC_HINT);
+    InitWindow(LARGURA_TELA, ALTURA_TELA, "Fogo e Agua - O Templo Invertido");
 
-// Parte do cdigo que cria a funo de calcular a coliso dos jogadores com o cenario
-void ResolverColisaoJogadores(Jogador *fogo, Jogador *agua) {
-    Rectangle recF = { fogo->posicao.x - 10, fogo->posicao.y - 20, 20, 20 };
-    Rectangle recA = { agua->posicao.x - 10, agua->posicao.y - 20, 20, 20 };
-    if (CheckCollisionRecs(recF, recA)) {
-        Rectangle overlap = GetCollisionRec(recF, recA);
-        if (overlap.width < overlap.height) {
-            float shift = overlap.width / 2.0f;
-            if (recF.x < recA.x) {
-                fogo->posicao.x -= shift;
-                agua->posicao.x += shift;
-            } else {
-                fogo->posicao.x += shift;
-                agua->posicao.x -= shift;
-            }
+    // Fases do pacote passado na linha de comando (ou '-'), ou as que vm no cdigo (compiladas, se tiver)
+#ifdef FASES_COMPILADAS
+    const DadosFase *fases = fasesCompiladas;
+    int numFasesDefinidas = NUM_FASES_COMPILADAS;
+#else
+    DadosFase dadosPadrao[MAX_FASES];
+    const DadosFase *fases = dadosPadrao;
+    int numFasesDefinidas = MontarDadosFasesPadrao(dadosPadrao);
+#endif
+    PacoteFases pacote = {0};
+    if (argc > 1) {
+        if (AbrirPacote(&pacote, argv[1]) && pacote.numFases > 0) {
+            fases = pacote.fases;
+            numFasesDefinidas = pacote.numFases;
+            printf("[DEBUG] %d fases carregadas de %s\n", numFasesDefinidas, argv[1]);
         } else {
-            if (fogo->velocidade.y > 0 && recF.y < recA.y) {
-                fogo->posicao.y = recA.y;
-                fogo->velocidade.y = 0;
-                fogo->podePular = true;
-            } else if (agua->velocidade.y > 0 && recA.y < recF.y) {
-                agua->posicao.y = recF.y;
-                agua->velocidade.y = 0;
-                agua->podePular = true;
-            }
+            printf("[DEBUG] Usando as fases padrao\n");
         }
     }
-}
 
-// Parte do cdigo que cria a funo para movimentar os cubos/jogadores
-void AtualizarJogador(Jogador *j, Plataforma plat[], int nPlat,
-                      PlataformaMovel platMoveis[], int nPlatMoveis,
-                      float gravidade) {
-    // Movimento horizontal e gravidade
-    j->posicao.x += j->velocidade.x;
-    j->velocidade.y += gravidade;
-    j->posicao.y += j->velocidade.y;
-
-    // Define retngulo de coliso do jogador
-    float h = 20.0f, w = 20.0f;
-    Rectangle rec = { j->posicao.x - w/2, j->posicao.y - h, w, h };
-    j->podePular = false;
-
-    // Coliso vertical com plataformas estticas
-    for (int i = 0; i < nPlat; i++) {
-        Rectangle p = plat[i].retangulo;
-        if (CheckCollisionRecs(rec, p)) {
-            // Descendo sobre a plataforma
-            if (j->velocidade.y > 0 && (rec.y + h - j->velocidade.y) <= p.y) {
-                j->posicao.y = p.y;
-                j->velocidade.y = 0;
-                j->podePular = true;
-            }
-            // Batendo de baixo na plataforma
-            else if (j->velocidade.y < 0 && rec.y > (p.y + p.height - 5)) {
-                j->posicao.y = p.y + p.height + h;
-                j->velocidade.y = 0; //  Zera velocidade pra no grudar no teto
-            }
-        }
+    // Todo o estado da fase fica no mundo (ver simulacao.h)
+    Partida partida = {0};
+    Mundo *mundo = &partida.mundo;
+    IniciarMundo(mundo, fases, numFasesDefinidas, 0);
+    partida.numFases = numFasesDefinidas;
+
+    // Quantos jogadores no teclado (o padro  o Fogo e a gua); o replay s grava com dois
+    int numJogadores = (argc > 2) ? atoi(argv[2]) : 2;
+    if (numJogadores < 1) numJogadores = 1;
+    if (numJogadores > MAX_JOGADORES_LOCAIS) numJogadores = MAX_JOGADORES_LOCAIS;
+    if (numJogadores != 2) DefinirJogadores(mundo, numJogadores);
+    partida.numJogadores = numJogadores;
+
+    // "separado": a simulao roda numa thread prpria em passo fixo e o desenho s pega o retrato mais novo
+    bool separado = argc > 3 && strcmp(argv[3], "separado") == 0;
+
+    IniciarRebobinador(&partida.rebobinar, SEGUNDOS_VOLTAR * TAXA_PASSOS, MEMORIA_VOLTAR);
+    ComecarFasePartida(&partida);
+
+    // Partes fixas da fase ficam numa textura (ver render.h); F2 mostra o contador de desenhos, F3 liga/desliga a textura
+    Renderizador render;
+    IniciarRenderizador(&render);
+    bool mostrarContador = false;
+
+    // Tempo de cada etapa do quadro (ver perfil.h); F4 mostra o resumo e ao sair os quadros vo pra perfil_quadros.csv.
+    // No modo separado s a thread do desenho  medida.
+    Perfilador *perfil = (Perfilador *)malloc(sizeof(Perfilador));
+    IniciarPerfilador(perfil);
+    if (!separado) {
+        mundo->perfil = perfil;
+        partida.perfil = perfil;
     }
-
-    // Coliso vertical com plataformas mveis
-    for (int i = 0; i < nPlatMoveis; i++) {
-        Rectangle p = platMoveis[i].retangulo;
-        if (CheckCollisionRecs(rec, p)) {
-            if (j->velocidade.y > 0 && (rec.y + h - j->velocidade.y) <= p.y) {
-                j->posicao.y = p.y;
-                j->velocidade.y = 0;
-                j->podePular = true;
-                // Empurra junto com a plataforma se ela estiver ativa
-                if (platMoveis[i].ativa) {
-                    if (platMoveis[i].posInicial.x != platMoveis[i].posFinal.x) {
-                        int dir = (platMoveis[i].posFinal.x > platMoveis[i].posInicial.x) ? 1 : -1;
-                        j->posicao.x += platMoveis[i].velocidade * dir;
-                    }
-                }
-            } else if (j->velocidade.y < 0 && rec.y > (p.y + p.height - 5)) {
-                j->posicao.y = p.y + p.height + h;
-                j->velocidade.y = 0;
-            }
-        }
+    bool mostrarPerfil = false;
+
+    // Passo fixo: o tempo de cada quadro entra no acumulador e a fsica roda em passos de DT_PASSO
+    double acumulador = 0.0;
+
+    // Telas paradas s so desenhadas quando algo muda; no resto do tempo o jogo s espera o ENTER
+    bool redesenhar = true;
+    EstadoJogo estadoDesenhado = mundo->estado;
+    int faseDesenhada = mundo->faseAtualIndex;
+    bool descartarTempoQuadro = false; // O primeiro quadro depois da espera mediria a espera inteira
+
+    // Modo separado: os retratos vm da thread da simulao. No outro o retrato  preenchido aqui a cada quadro.
+    TrocaRetratos *retratos = NULL;
+    CaixaTeclas *caixaTeclas = NULL;
+    ThreadPassos *threadSimulacao = NULL;
+    ContextoSimulacao contextoThread;
+    RetratoMundo retratoLocal = {0};
+    if (separado) {
+        retratos = CriarTrocaRetratos();
+        caixaTeclas = CriarCaixaTeclas();
+        RetratarPartida(&partida, RetratoParaEscrever(retratos)); // O primeiro j existe antes do primeiro quadro
+        PublicarRetrato(retratos);
+        contextoThread = (ContextoSimulacao){ &partida, caixaTeclas, retratos };
+        threadSimulacao = IniciarThreadPassos(PassoThreadSimulacao, &contextoThread, DT_PASSO, MAX_PASSOS_POR_QUADRO);
+        printf("[DEBUG] Simulacao numa thread separada\n");
     }
 
-    // Coliso horizontal com plataformas estticas
-    {
-        // Usa o mesmo rec de coliso
-        Rectangle rec2 = rec;
-        for (int i = 0; i < nPlat; i++) {
-            Rectangle p = plat[i].retangulo;
-            if (CheckCollisionRecs(rec2, p)) {
-                Rectangle overlap = GetCollisionRec(rec2, p);
-                // Se a penetrao horizontal for menor que a vertical,
-                // corrige apenas no eixo X
-                if (overlap.width < overlap.height) {
-                    if (rec2.x < p.x)
-                        j->posicao.x -= overlap.width;
-                    else
-                        j->posicao.x += overlap.width;
-                }
-            }
-        }
-    }
 
-    // Coliso horizontal com plataformas mveis (Semi quebrado, tem bugs nessa parte aqui)
-    {
-        float w2 = 20.0f, h2 = 20.0f;
-        Rectangle rec2 = { j->posicao.x - w2/2, j->posicao.y - h2, w2, h2 };
-        for (int i = 0; i < nPlatMoveis; i++) {
-            Rectangle p = platMoveis[i].retangulo;
-            if (CheckCollisionRecs(rec2, p)) {
-                Rectangle overlap = GetCollisionRec(rec2, p);
-                if (overlap.width < overlap.height) {
-                    if (rec2.x < p.x) {
-                        j->posicao.x -= overlap.width;
-                    } else {
-                        j->posicao.x += overlap.width;
-                    }
+    while (!WindowShouldClose()) {
+        ComecarQuadroPerfil(perfil);
+        if (IsKeyPressed(KEY_F2)) {
+            mostrarContador = !mostrarContador;
+            redesenhar = true;
+        }
+        if (IsKeyPressed(KEY_F3)) {
+            render.usarCamada = !render.usarCamada && IsRenderTextureReady(render.camada);
+            redesenhar = true;
+        }
+        if (IsKeyPressed(KEY_F4)) {
+            mostrarPerfil = !mostrarPerfil;
+            redesenhar = true;
+        }
+        unsigned int novas;
+        unsigned int apertadas = LerTeclas(numJogadores, &novas);
+        MarcarEtapa(perfil, ETAPA_ENTRADA);
+
+        const RetratoMundo *retrato;
+        float alfa;
+        if (separado) {
+            EnviarTeclas(caixaTeclas, apertadas, novas);
+            retrato = RetratoMaisNovo(retratos);
+            // O desenho fica at um passo atrs da fsica e anda entre o penltimo e o ltimo passo publicado
+            alfa = (float)((TempoMonotonico() - retrato->instante) / DT_PASSO);
+            if (alfa > 1.0f) alfa = 1.0f;
+            if (alfa < 0.0f) alfa = 0.0f;
+        } else {
+            EstadoJogo estado = mundo->estado;
+            if (ComandosPartida(&partida, apertadas, novas)) acumulador = 0.0;
+            if (estado == JOGANDO) {
+                // Quadro muito lento recupera no mximo MAX_PASSOS_POR_QUADRO passos
+                if (descartarTempoQuadro) descartarTempoQuadro = false;
+                else acumulador += GetFrameTime();
+                if (acumulador > MAX_PASSOS_POR_QUADRO * DT_PASSO) acumulador = MAX_PASSOS_POR_QUADRO * DT_PASSO;
+                MarcarEtapa(perfil, ETAPA_ENTRADA);
+
+                while (acumulador >= DT_PASSO && mundo->estado == JOGANDO) {
+                    PassoPartida(&partida, apertadas);
+                    acumulador -= DT_PASSO;
                 }
             }
+            RetratarPartida(&partida, &retratoLocal);
+            retrato = &retratoLocal;
+            // Frao do prximo passo que j passou (fora do JOGANDO desenha a posio final)
+            alfa = (retrato->estado == JOGANDO) ? (float)(acumulador / DT_PASSO) : 1.0f;
         }
-    }
-}
+        if (retrato->terminou) break;
+
+        // Tela parada e nada mudou: no desenha, espera um pouco e s l o teclado
+        if (retrato->estado != estadoDesenhado || retrato->faseIndex != faseDesenhada || retrato->estado == JOGANDO || IsWindowResized())
+            redesenhar = true;
+        if (!redesenhar) {
+            WaitTime(1.0 / TAXA_TELA_PARADA);
+            PollInputEvents();
+            descartarTempoQuadro = true;
+            continue;
+        }
+        redesenhar = false;
+        estadoDesenhado = retrato->estado;
+        faseDesenhada = retrato->faseIndex;
+        MarcarEtapa(perfil, ETAPA_OUTROS);
 
-// Funo para impedir do jogador de sair do limite da tela
-void VerificarLimitesEReiniciar(
-    Jogador *fogo, Jogador *agua,
-    Fase fases[], int *faseAtualIndex,
-    Plataforma plat[], int *nPlat,
-    Perigo perigos[], int *nPerigos,
-    Porta portas[], int *nPortas,
-    Botao botoes[], int *nBotoes,
-    PlataformaMovel platMoveis[], int *nPlatMoveis,
-    bool *temDiamante, Rectangle *diamanteRect,
-    bool *diamanteColetado, int *diamantesColetados,
-    double *tempoInicio, bool *progressoCalculado, int *estrelasObtidas,
-    EstadoJogo *estadoJogo)
-{
-    const float halfW = 10.0f;
-    const float halfH = 20.0f;
-
-    // paredes invisveis (laterais e teto) para Fogo
-    if (fogo->posicao.x < halfW)                   fogo->posicao.x = halfW;
-    if (fogo->posicao.x > LARGURA_TELA - halfW)    fogo->posicao.x = LARGURA_TELA - halfW;
-    if (fogo->posicao.y < halfH) {
-        fogo->posicao.y = halfH;
-        fogo->velocidade.y = 0;
-    }
-    // paredes invisveis para gua
-    if (agua->posicao.x < halfW)                   agua->posicao.x = halfW;
-    if (agua->posicao.x > LARGURA_TELA - halfW)    agua->posicao.x = LARGURA_TELA - halfW;
-    if (agua->posicao.y < halfH) {
-        agua->posicao.y = halfH;
-        agua->velocidade.y = 0;
+        ComecarQuadro(&render);
+        BeginDrawing();
+            DesenharQuadro(&render, retrato, alfa, mostrarContador);
+            if (mostrarPerfil) DesenharPerfil(perfil, 10, 40);
+            MarcarEtapa(perfil, ETAPA_DESENHO);
+        EndDrawing();
+        MarcarEtapa(perfil, ETAPA_APRESENTAR);
+        FecharQuadroPerfil(perfil);
     }
 
-    // se qualquer jogador cair reinicia a fase
-    if (fogo->posicao.y > ALTURA_TELA || agua->posicao.y > ALTURA_TELA) {
-        CarregarFase(
-            fases[*faseAtualIndex], fogo, agua,
-            plat, nPlat,
-            perigos, nPerigos,
-            portas, nPortas,
-            botoes, nBotoes,
-            platMoveis, nPlatMoveis,
-            temDiamante, diamanteRect
-        );
-        *diamanteColetado   = false;
-        *diamantesColetados = 0;
-        *tempoInicio        = GetTime();
-        *progressoCalculado = false;
-        *estrelasObtidas    = 0;
-        *estadoJogo         = JOGANDO;
-    }
+    // A thread para antes de qualquer coisa da partida ser liberada
+    PararThreadPassos(threadSimulacao);
+    DestruirCaixaTeclas(caixaTeclas);
+    DestruirTrocaRetratos(retratos);
+    LiberarRetrato(&retratoLocal);
+
+    if (perfil->numQuadros > 0 && SalvarPerfilCSV(perfil, "perfil_quadros.csv"))
+        printf("[DEBUG] Tempos de %lld quadros salvos em perfil_quadros.csv\n",
+               perfil->numQuadros < QUADROS_PERFIL ? perfil->numQuadros : (long long)QUADROS_PERFIL);
+    mundo->perfil = NULL;
+    free(perfil);
+
+    LiberarReplay(&partida.gravacao);
+    LiberarRebobinador(&partida.rebobinar);
+    LiberarRenderizador(&render);
+    LiberarMundo(mundo);
+    free(partida.anteriores.plataformasMoveis);
+    FecharPacote(&pacote);
+    CloseWindow();
+    return 0;
 }
@@ -0,0 +1,17 @@
+/*
+Vetores que crescem sob demanda, usados pelos mdulos do ncleo. S pra uso interno dos .cpp.
+*/
+#ifndef MEMORIA_H
+#define MEMORIA_H
+
+#include <stdlib.h>
+
+// Garante espao pra n itens num vetor (com capacidade em *cap). O contedo antigo no  mantido.
+static inline void *Reservar(void *vetor, int *cap, int n, size_t tamanho) {
+    if (n <= *cap && vetor != NULL) return vetor;
+    free(vetor);
+    *cap = n > 0 ? n : 1;
+    return malloc(tamanho * (size_t)*cap);
+}
+
+#endif
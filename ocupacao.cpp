@@ -0,0 +1,114 @@
+// Grade de ocupao por tipo (ver ocupacao.h)
+#include "ocupacao.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// Borda esquerda (ou de cima) da clula c. As duas bordas de uma clula sempre saem daqui, pra marcao e
+// consulta fazerem exatamente a mesma conta em float.
+static inline float BordaCelula(float origem, float tam, int c) {
+    return origem + (float)c * tam;
+}
+
+// Clula de uma coordenada (j relativa  origem). Marcao e consulta usam a mesma conta, com o inverso do
+// tamanho (multiplicar em vez de dividir) e sem floorf, que sem SSE4.1 vira chamada de biblioteca.
+static inline int Celula(const GradeOcupacao *g, float v) {
+    float x = v * g->inversoCelula;
+    int i = (int)x;
+    return (x < (float)i) ? i - 1 : i;
+}
+
+static int Limitar(int v, int minimo, int maximo) {
+    if (v < minimo) return minimo;
+    if (v > maximo) return maximo;
+    return v;
+}
+
+void PrepararOcupacao(GradeOcupacao *g, Rectangle area, float tamCelula) {
+    int colunas, linhas;
+    for (;;) {
+        colunas = (int)ceilf(area.width / tamCelula) + 1;
+        linhas = (int)ceilf(area.height / tamCelula) + 1;
+        if ((long long)colunas * linhas <= MAX_CELULAS_OCUPACAO) break;
+        tamCelula *= 2.0f;
+    }
+    g->origemX = area.x;
+    g->origemY = area.y;
+    g->tamCelula = tamCelula;
+    g->inversoCelula = 1.0f / tamCelula;
+    g->colunas = colunas;
+    g->linhas = linhas;
+
+    int numCelulas = colunas * linhas;
+    if (numCelulas > g->capCelulas) {
+        free(g->celulas);
+        g->celulas = (unsigned char *)malloc((size_t)numCelulas);
+        g->capCelulas = (g->celulas != NULL) ? numCelulas : 0;
+    }
+    if (g->celulas == NULL) {
+        g->colunas = g->linhas = 0;
+        return;
+    }
+    memset(g->celulas, 0, (size_t)numCelulas);
+}
+
+void MarcarOcupacao(GradeOcupacao *g, Rectangle r, int tipo) {
+    // Tipo fora da faixa marcaria os bits de "cobre" (ou nada, e o deslocamento nem  definido)
+    if (g->colunas == 0 || tipo < 0 || tipo >= MAX_TIPOS_OCUPACAO) return;
+    float o = g->tamCelula;
+    int c0 = Limitar(Celula(g, r.x - g->origemX), 0, g->colunas - 1);
+    int l0 = Limitar(Celula(g, r.y - g->origemY), 0, g->linhas - 1);
+    int c1 = Limitar(Celula(g, r.x + r.width - g->origemX), 0, g->colunas - 1);
+    int l1 = Limitar(Celula(g, r.y + r.height - g->origemY), 0, g->linhas - 1);
+    unsigned char encosta = (unsigned char)(1u << tipo);
+    unsigned char cobre = (unsigned char)(1u << (tipo + MAX_TIPOS_OCUPACAO));
+
+    for (int l = l0; l <= l1; l++) {
+        float topo = BordaCelula(g->origemY, o, l), baixo = BordaCelula(g->origemY, o, l + 1);
+        bool cobreLinha = r.y <= topo && r.y + r.height >= baixo;
+        for (int c = c0; c <= c1; c++) {
+            float esquerda = BordaCelula(g->origemX, o, c), direita = BordaCelula(g->origemX, o, c + 1);
+            unsigned char *celula = &g->celulas[l * g->colunas + c];
+            *celula |= encosta;
+            if (cobreLinha && r.x <= esquerda && r.x + r.width >= direita) *celula |= cobre;
+        }
+    }
+}
+
+ResultadoOcupacao ConsultarOcupacao(const GradeOcupacao *g, Rectangle rec, unsigned int tipos) {
+    if (g->colunas == 0 || tipos == 0) return OCUPACAO_LIVRE;
+    float o = g->tamCelula;
+    int c0 = Celula(g, rec.x - g->origemX);
+    int l0 = Celula(g, rec.y - g->origemY);
+    int c1 = Celula(g, rec.x + rec.width - g->origemX);
+    int l1 = Celula(g, rec.y + rec.height - g->origemY);
+    // Fora da rea no tem item nenhum
+    if (c1 < 0 || l1 < 0 || c0 >= g->colunas || l0 >= g->linhas) return OCUPACAO_LIVRE;
+    c0 = Limitar(c0, 0, g->colunas - 1);
+    l0 = Limitar(l0, 0, g->linhas - 1);
+    c1 = Limitar(c1, 0, g->colunas - 1);
+    l1 = Limitar(l1, 0, g->linhas - 1);
+
+    bool duvida = false;
+    for (int l = l0; l <= l1; l++) {
+        const unsigned char *linha = &g->celulas[l * g->colunas];
+        for (int c = c0; c <= c1; c++) {
+            unsigned int bits = linha[c];
+            if ((bits & tipos) == 0) continue;
+            // Clula coberta por um item dos tipos: se rec entra nela (no s encosta na borda), encosta no item
+            if (((bits >> MAX_TIPOS_OCUPACAO) & tipos) != 0 &&
+                rec.x < BordaCelula(g->origemX, o, c + 1) && rec.x + rec.width > BordaCelula(g->origemX, o, c) &&
+                rec.y < BordaCelula(g->origemY, o, l + 1) && rec.y + rec.height > BordaCelula(g->origemY, o, l))
+                return OCUPACAO_TOCA;
+            duvida = true;
+        }
+    }
+    return duvida ? OCUPACAO_DUVIDA : OCUPACAO_LIVRE;
+}
+
+void LiberarOcupacao(GradeOcupacao *g) {
+    free(g->celulas);
+    g->celulas = NULL;
+    g->capCelulas = 0;
+    g->colunas = g->linhas = 0;
+}
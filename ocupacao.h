@@ -0,0 +1,45 @@
+/*
+Grade de ocupao: a rea  rasterizada em clulas pequenas e cada clula guarda, em bits, os tipos de item
+que encostam nela e os que cobrem ela inteira (at 4 tipos). Serve pros perigos, que no mudam durante a fase:
+a pergunta "rec encosta em algum item destes tipos?" olha s as poucas clulas embaixo de rec, no importa
+quantos itens a fase tenha.
+S as clulas da borda de um item (encostadas mas no cobertas) ficam em dvida; a quem chamou confere pelos
+retngulos. A consulta no altera a grade, ento vrios jogadores/threads podem consultar ao mesmo tempo.
+*/
+#ifndef OCUPACAO_H
+#define OCUPACAO_H
+
+#include "tipos.h"
+
+#define TAM_CELULA_OCUPACAO 10.0f     // As fases do jogo so desenhadas de 10 em 10 px
+#define MAX_CELULAS_OCUPACAO (1 << 22) // Acima disso a clula dobra de tamanho (fases gigantes)
+#define MAX_TIPOS_OCUPACAO 4
+
+// Resposta da ConsultarOcupacao
+typedef enum {
+    OCUPACAO_LIVRE,  // Nenhum item dos tipos pedidos encosta em rec
+    OCUPACAO_TOCA,   // Com certeza algum encosta (rec entra numa clula coberta por ele)
+    OCUPACAO_DUVIDA  // S clulas de borda: conferir pelos retngulos
+} ResultadoOcupacao;
+
+typedef struct {
+    float origemX;
+    float origemY;
+    float tamCelula;
+    float inversoCelula;
+    int colunas;
+    int linhas;
+    unsigned char *celulas; // Bits 0-3: tipos que encostam na clula; bits 4-7: tipos que cobrem ela inteira
+    int capCelulas;         // Capacidade j alocada, pra recarregar fase sem malloc
+} GradeOcupacao;
+
+// Prepara uma grade vazia cobrindo area (normalmente a caixa de todos os itens que vo ser marcados)
+void PrepararOcupacao(GradeOcupacao *g, Rectangle area, float tamCelula);
+// Marca as clulas de r com o tipo (0 a MAX_TIPOS_OCUPACAO-1)
+void MarcarOcupacao(GradeOcupacao *g, Rectangle r, int tipo);
+// tipos  a mscara (bit t = tipo t) dos que interessam. "Encostar"  igual ao CheckCollisionRecs.
+ResultadoOcupacao ConsultarOcupacao(const GradeOcupacao *g, Rectangle rec, unsigned int tipos);
+
+void LiberarOcupacao(GradeOcupacao *g);
+
+#endif
@@ -0,0 +1,262 @@
+// Leitura (mmap) e gravao dos pacotes de fases (ver pacote.h)
+#include "pacote.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Mapeia o arquivo inteiro s pra leitura
+static bool MapearArquivo(PacoteFases *pacote, const char *caminho) {
+#ifdef _WIN32
+    HANDLE arquivo = CreateFileA(caminho, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (arquivo == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER tamanho;
+    if (!GetFileSizeEx(arquivo, &tamanho) || tamanho.QuadPart == 0) {
+        CloseHandle(arquivo);
+        return false;
+    }
+    HANDLE mapeamento = CreateFileMappingA(arquivo, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapeamento == NULL) {
+        CloseHandle(arquivo);
+        return false;
+    }
+    void *mapa = MapViewOfFile(mapeamento, FILE_MAP_READ, 0, 0, 0);
+    if (mapa == NULL) {
+        CloseHandle(mapeamento);
+        CloseHandle(arquivo);
+        return false;
+    }
+    pacote->arquivo = arquivo;
+    pacote->mapeamento = mapeamento;
+    pacote->mapa = mapa;
+    pacote->tamanho = (size_t)tamanho.QuadPart;
+    return true;
+#else
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void *mapa = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // O mapa continua valendo depois de fechar o arquivo
+    if (mapa == MAP_FAILED) return false;
+    pacote->mapa = mapa;
+    pacote->tamanho = (size_t)info.st_size;
+    return true;
+#endif
+}
+
+static void DesmapearArquivo(PacoteFases *pacote) {
+    if (pacote->mapa == NULL) return;
+#ifdef _WIN32
+    UnmapViewOfFile(pacote->mapa);
+    CloseHandle((HANDLE)pacote->mapeamento);
+    CloseHandle((HANDLE)pacote->arquivo);
+#else
+    munmap(pacote->mapa, pacote->tamanho);
+#endif
+    pacote->mapa = NULL;
+    pacote->tamanho = 0;
+}
+
+// Confere se a seo cabe no arquivo e est alinhada; devolve o ponteiro pra ela
+static const void *PegarSecao(const PacoteFases *pacote, SecaoPacote secao, size_t tamanhoItem) {
+    if (secao.num == 0) return NULL;
+    if (secao.offset % ALINHAMENTO_PACOTE != 0) return NULL;
+    if (secao.offset > pacote->tamanho) return NULL;
+    if ((uint64_t)secao.num > (pacote->tamanho - secao.offset) / tamanhoItem) return NULL;
+    return (const char *)pacote->mapa + secao.offset;
+}
+
+bool AbrirPacote(PacoteFases *pacote, const char *caminho) {
+    pacote->mapa = NULL;
+    pacote->tamanho = 0;
+    pacote->fases = NULL;
+    pacote->numFases = 0;
+
+    if (!MapearArquivo(pacote, caminho)) {
+        fprintf(stderr, "[PACOTE] Nao foi possivel abrir %s\n", caminho);
+        return false;
+    }
+
+    const CabecalhoPacote *cab = (const CabecalhoPacote *)pacote->mapa;
+    const char *erro = NULL;
+    // Cabealho e fases das verses antigas so os da atual sem os campos do fim
+    size_t tamanhoCabecalho = offsetof(CabecalhoPacote, tamanhoNoLogico);
+    size_t tamanhoFase = offsetof(FaseArquivo, nosLogicos);
+    if (pacote->tamanho >= tamanhoCabecalho && cab->versao == 2) {
+        tamanhoCabecalho = offsetof(CabecalhoPacote, tamanhoCaminho);
+        tamanhoFase = offsetof(FaseArquivo, caminhos);
+    } else if (pacote->tamanho >= tamanhoCabecalho && cab->versao == VERSAO_PACOTE) {
+        tamanhoCabecalho = sizeof(CabecalhoPacote);
+        tamanhoFase = sizeof(FaseArquivo);
+    }
+    if (pacote->tamanho < tamanhoCabecalho || memcmp(cab->magica, MAGICA_PACOTE, 8) != 0)
+        erro = "nao e um pacote de fases";
+    else if (cab->versao < 1 || cab->versao > VERSAO_PACOTE)
+        erro = "versao do pacote nao suportada";
+    else if (cab->marcaEndian != MARCA_ENDIAN_PACOTE)
+        erro = "pacote gravado em maquina com outra ordem de bytes";
+    else if (cab->tamanhoPlataforma != sizeof(Plataforma) || cab->tamanhoPerigo != sizeof(Perigo) ||
+             cab->tamanhoPorta != sizeof(Porta) || cab->tamanhoBotao != sizeof(Botao) ||
+             cab->tamanhoPlataformaMovel != sizeof(PlataformaMovel) ||
+             (cab->versao >= 2 && (cab->tamanhoNoLogico != sizeof(NoLogico) || cab->tamanhoLigacao != sizeof(Ligacao))) ||
+             (cab->versao >= 3 && cab->tamanhoCaminho != sizeof(CaminhoMovel)))
+        erro = "structs do pacote tem tamanho diferente das deste programa";
+    else if (cab->offsetFases % ALINHAMENTO_PACOTE != 0 || cab->offsetFases > pacote->tamanho ||
+             cab->numFases > (pacote->tamanho - cab->offsetFases) / tamanhoFase)
+        erro = "lista de fases fora do arquivo";
+
+    if (erro == NULL) {
+        const char *listaFases = (const char *)pacote->mapa + cab->offsetFases;
+        pacote->numFases = (int)cab->numFases;
+        pacote->fases = (DadosFase *)malloc(sizeof(DadosFase) * (cab->numFases > 0 ? cab->numFases : 1));
+        for (int i = 0; i < pacote->numFases && erro == NULL; i++) {
+            // Copia a fase pra uma FaseArquivo inteira (as sees que a verso do pacote no tem ficam vazias)
+            FaseArquivo f;
+            memset(&f, 0, sizeof(f));
+            memcpy(&f, listaFases + tamanhoFase * (size_t)i, tamanhoFase);
+            DadosFase *d = &pacote->fases[i];
+            d->plataformas = (const Plataforma *)PegarSecao(pacote, f.plataformas, sizeof(Plataforma));
+            d->perigos = (const Perigo *)PegarSecao(pacote, f.perigos, sizeof(Perigo));
+            d->portas = (const Porta *)PegarSecao(pacote, f.portas, sizeof(Porta));
+            d->botoes = (const Botao *)PegarSecao(pacote, f.botoes, sizeof(Botao));
+            d->plataformasMoveis = (const PlataformaMovel *)PegarSecao(pacote, f.plataformasMoveis, sizeof(PlataformaMovel));
+            d->nosLogicos = (const NoLogico *)PegarSecao(pacote, f.nosLogicos, sizeof(NoLogico));
+            d->ligacoes = (const Ligacao *)PegarSecao(pacote, f.ligacoes, sizeof(Ligacao));
+            d->caminhos = (const CaminhoMovel *)PegarSecao(pacote, f.caminhos, sizeof(CaminhoMovel));
+            d->pontosCaminho = (const Vector2 *)PegarSecao(pacote, f.pontosCaminho, sizeof(Vector2));
+            d->numPlataformas = (int)f.plataformas.num;
+            d->numPerigos = (int)f.perigos.num;
+            d->numPortas = (int)f.portas.num;
+            d->numBotoes = (int)f.botoes.num;
+            d->numPlataformasMoveis = (int)f.plataformasMoveis.num;
+            d->numNosLogicos = (int)f.nosLogicos.num;
+            d->numLigacoes = (int)f.ligacoes.num;
+            d->numCaminhos = (int)f.caminhos.num;
+            d->numPontosCaminho = (int)f.pontosCaminho.num;
+            d->posInicialFogo = f.posInicialFogo;
+            d->posInicialAgua = f.posInicialAgua;
+            d->temDiamante = f.temDiamante != 0;
+            d->diamante = f.diamante;
+            d->tempoPar = f.tempoPar;
+            d->pronta = NULL;
+
+            if ((d->numPlataformas > 0 && d->plataformas == NULL) || (d->numPerigos > 0 && d->perigos == NULL) ||
+                (d->numPortas > 0 && d->portas == NULL) || (d->numBotoes > 0 && d->botoes == NULL) ||
+                (d->numPlataformasMoveis > 0 && d->plataformasMoveis == NULL) ||
+                (d->numNosLogicos > 0 && d->nosLogicos == NULL) || (d->numLigacoes > 0 && d->ligacoes == NULL) ||
+                (d->numCaminhos > 0 && d->caminhos == NULL) || (d->numPontosCaminho > 0 && d->pontosCaminho == NULL) ||
+                f.plataformas.num > INT32_MAX || f.perigos.num > INT32_MAX || f.portas.num > INT32_MAX ||
+                f.botoes.num > INT32_MAX || f.plataformasMoveis.num > INT32_MAX ||
+                f.nosLogicos.num > INT32_MAX || f.ligacoes.num > INT32_MAX ||
+                f.caminhos.num > INT32_MAX || f.pontosCaminho.num > INT32_MAX)
+                erro = "secao de fase fora do arquivo";
+            for (int p = 0; p < d->numPerigos && erro == NULL; p++)
+                if (d->perigos[p].tipo < FOGO || d->perigos[p].tipo > TERRA)
+                    erro = "perigo com tipo desconhecido";
+        }
+    }
+
+    if (erro != NULL) {
+        fprintf(stderr, "[PACOTE] %s: %s\n", caminho, erro);
+        FecharPacote(pacote);
+        return false;
+    }
+    return true;
+}
+
+void FecharPacote(PacoteFases *pacote) {
+    free(pacote->fases);
+    pacote->fases = NULL;
+    pacote->numFases = 0;
+    DesmapearArquivo(pacote);
+}
+
+// Escreve zeros at a posio ficar alinhada
+static uint64_t Alinhar(FILE *arquivo, uint64_t posicao) {
+    while (posicao % ALINHAMENTO_PACOTE != 0) {
+        fputc(0, arquivo);
+        posicao++;
+    }
+    return posicao;
+}
+
+static uint64_t GravarSecao(FILE *arquivo, uint64_t posicao, SecaoPacote *secao, const void *dados, size_t tamanhoItem, int num) {
+    posicao = Alinhar(arquivo, posicao);
+    secao->offset = (num > 0) ? posicao : 0;
+    secao->num = (uint32_t)num;
+    secao->reservado = 0;
+    if (num > 0) {
+        fwrite(dados, tamanhoItem, (size_t)num, arquivo);
+        posicao += tamanhoItem * (uint64_t)num;
+    }
+    return posicao;
+}
+
+bool SalvarPacote(const char *caminho, const DadosFase fases[], int numFases) {
+    FILE *arquivo = fopen(caminho, "wb");
+    if (arquivo == NULL) {
+        fprintf(stderr, "[PACOTE] Nao foi possivel criar %s\n", caminho);
+        return false;
+    }
+
+    CabecalhoPacote cab;
+    memset(&cab, 0, sizeof(cab));
+    memcpy(cab.magica, MAGICA_PACOTE, 8);
+    cab.versao = VERSAO_PACOTE;
+    cab.marcaEndian = MARCA_ENDIAN_PACOTE;
+    cab.numFases = (uint32_t)numFases;
+    cab.tamanhoPlataforma = sizeof(Plataforma);
+    cab.tamanhoPerigo = sizeof(Perigo);
+    cab.tamanhoPorta = sizeof(Porta);
+    cab.tamanhoBotao = sizeof(Botao);
+    cab.tamanhoPlataformaMovel = sizeof(PlataformaMovel);
+    cab.tamanhoNoLogico = sizeof(NoLogico);
+    cab.tamanhoLigacao = sizeof(Ligacao);
+    cab.tamanhoCaminho = sizeof(CaminhoMovel);
+    cab.offsetFases = (sizeof(CabecalhoPacote) + ALINHAMENTO_PACOTE - 1) / ALINHAMENTO_PACOTE * ALINHAMENTO_PACOTE;
+
+    // Primeiro grava as sees depois da lista de fases; a lista  escrita no fim, com os offsets j conhecidos
+    FaseArquivo *fa = (FaseArquivo *)calloc((size_t)(numFases > 0 ? numFases : 1), sizeof(FaseArquivo));
+    uint64_t posicao = cab.offsetFases + sizeof(FaseArquivo) * (uint64_t)numFases;
+    fseek(arquivo, (long)posicao, SEEK_SET);
+    for (int i = 0; i < numFases; i++) {
+        const DadosFase *d = &fases[i];
+        posicao = GravarSecao(arquivo, posicao, &fa[i].plataformas, d->plataformas, sizeof(Plataforma), d->numPlataformas);
+        posicao = GravarSecao(arquivo, posicao, &fa[i].perigos, d->perigos, sizeof(Perigo), d->numPerigos);
+        posicao = GravarSecao(arquivo, posicao, &fa[i].portas, d->portas, sizeof(Porta), d->numPortas);
+        posicao = GravarSecao(arquivo, posicao, &fa[i].botoes, d->botoes, sizeof(Botao), d->numBotoes);
+        posicao = GravarSecao(arquivo, posicao, &fa[i].plataformasMoveis, d->plataformasMoveis, sizeof(PlataformaMovel), d->numPlataformasMoveis);
+        posicao = GravarSecao(arquivo, posicao, &fa[i].nosLogicos, d->nosLogicos, sizeof(NoLogico), d->numNosLogicos);
+        posicao = GravarSecao(arquivo, posicao, &fa[i].ligacoes, d->ligacoes, sizeof(Ligacao), d->numLigacoes);
+        posicao = GravarSecao(arquivo, posicao, &fa[i].caminhos, d->caminhos, sizeof(CaminhoMovel), d->numCaminhos);
+        posicao = GravarSecao(arquivo, posicao, &fa[i].pontosCaminho, d->pontosCaminho, sizeof(Vector2), d->numPontosCaminho);
+        fa[i].posInicialFogo = d->posInicialFogo;
+        fa[i].posInicialAgua = d->posInicialAgua;
+        fa[i].diamante = d->diamante;
+        fa[i].temDiamante = d->temDiamante ? 1 : 0;
+        fa[i].tempoPar = d->tempoPar;
+    }
+
+    fseek(arquivo, 0, SEEK_SET);
+    fwrite(&cab, sizeof(cab), 1, arquivo);
+    Alinhar(arquivo, sizeof(cab));
+    fwrite(fa, sizeof(FaseArquivo), (size_t)numFases, arquivo);
+    free(fa);
+
+    bool ok = !ferror(arquivo);
+    if (fclose(arquivo) != 0) ok = false;
+    if (!ok) fprintf(stderr, "[PACOTE] Erro gravando %s\n", caminho);
+    return ok;
+}
@@ -0,0 +1,88 @@
+/*
+Pacote de fases em arquivo binrio, lido com mmap (MapViewOfFile no Windows).
+Os vetores de colisores ficam no arquivo no mesmo formato das structs do jogo,
+ento as DadosFase apontam direto pra memria mapeada: nada  lido, convertido ou copiado,
+e vrios processos abrindo o mesmo pacote dividem as mesmas pginas.
+
+Formato (little-endian, verso 3):
+    CabecalhoPacote
+    FaseArquivo[numFases]
+    sees de cada fase (vetores de Plataforma, Perigo, Porta, Botao, PlataformaMovel, NoLogico, Ligacao,
+    CaminhoMovel, Vector2), alinhadas em 16 bytes
+Os offsets so contados a partir do comeo do arquivo. As verses antigas so lidas com as fases sem o que
+ainda no existia: a 1 no tem lgica nem caminhos (cabealho termina no offsetFases e FaseArquivo no tempoPar),
+a 2 no tem caminhos (cabealho termina no tamanhoLigacao e FaseArquivo nas ligacoes).
+*/
+#ifndef PACOTE_H
+#define PACOTE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "simulacao.h"
+
+#define MAGICA_PACOTE "FOGOAGUA"
+#define VERSAO_PACOTE 3
+#define MARCA_ENDIAN_PACOTE 0x01020304u
+#define ALINHAMENTO_PACOTE 16
+
+typedef struct {
+    char magica[8];
+    uint32_t versao;
+    uint32_t marcaEndian;
+    uint32_t numFases;
+    // Tamanho das structs de quem gravou: se no bater com o de quem l, o pacote no  usado
+    uint32_t tamanhoPlataforma;
+    uint32_t tamanhoPerigo;
+    uint32_t tamanhoPorta;
+    uint32_t tamanhoBotao;
+    uint32_t tamanhoPlataformaMovel;
+    uint64_t offsetFases;
+    uint32_t tamanhoNoLogico;    // Desde a verso 2
+    uint32_t tamanhoLigacao;
+    uint32_t tamanhoCaminho;     // Desde a verso 3
+    uint32_t reservado;
+} CabecalhoPacote;
+
+typedef struct {
+    uint64_t offset;
+    uint32_t num;
+    uint32_t reservado;
+} SecaoPacote;
+
+typedef struct {
+    SecaoPacote plataformas;
+    SecaoPacote perigos;
+    SecaoPacote portas;
+    SecaoPacote botoes;
+    SecaoPacote plataformasMoveis;
+    Vector2 posInicialFogo;
+    Vector2 posInicialAgua;
+    Rectangle diamante;
+    uint32_t temDiamante;
+    float tempoPar;       // 0 = desconhecido (pacotes antigos gravavam 0 aqui)
+    SecaoPacote nosLogicos; // Desde a verso 2
+    SecaoPacote ligacoes;
+    SecaoPacote caminhos;   // Desde a verso 3
+    SecaoPacote pontosCaminho;
+} FaseArquivo;
+
+// Pacote aberto: as fases apontam pra dentro do mapa
+typedef struct {
+    void *mapa;
+    size_t tamanho;
+#ifdef _WIN32
+    void *arquivo;
+    void *mapeamento;
+#endif
+    DadosFase *fases;
+    int numFases;
+} PacoteFases;
+
+// Mapeia o arquivo e confere tudo (offsets e tamanhos). Em erro escreve o motivo no stderr e devolve false.
+bool AbrirPacote(PacoteFases *pacote, const char *caminho);
+void FecharPacote(PacoteFases *pacote);
+
+// Grava as fases num pacote novo
+bool SalvarPacote(const char *caminho, const DadosFase fases[], int numFases);
+
+#endif
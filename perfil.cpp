@@ -0,0 +1,83 @@
+// Medio do tempo das etapas do quadro (ver perfil.h)
+#include "perfil.h"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+
+const char *nomesEtapas[NUM_ETAPAS] = {
+    "entrada", "pedacos", "botoes", "fogo", "agua", "colisao_jogadores", "limites", "perigos", "outros", "desenho", "apresentar"
+};
+
+static long long AgoraNs(void) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void IniciarPerfilador(Perfilador *p) {
+    memset(p, 0, sizeof(*p));
+    p->ultimaMarca = AgoraNs();
+    p->inicioQuadro = p->ultimaMarca;
+}
+
+void MarcarEtapaPerfil(Perfilador *p, EtapaPerfil etapa) {
+    long long agora = AgoraNs();
+    p->atual[etapa] += (float)(agora - p->ultimaMarca) * 0.001f;
+    p->ultimaMarca = agora;
+}
+
+void ComecarQuadroPerfil(Perfilador *p) {
+    for (int i = 0; i < NUM_ETAPAS; i++) p->atual[i] = 0;
+    p->ultimaMarca = AgoraNs();
+    p->inicioQuadro = p->ultimaMarca;
+}
+
+void FecharQuadroPerfil(Perfilador *p) {
+    float *linha = p->quadros[p->numQuadros % QUADROS_PERFIL];
+    for (int i = 0; i < NUM_ETAPAS; i++) linha[i] = p->atual[i];
+    linha[NUM_ETAPAS] = (float)(AgoraNs() - p->inicioQuadro) * 0.001f;
+    p->numQuadros++;
+}
+
+ResumoEtapa ResumirEtapa(const Perfilador *p, int etapa, int janela) {
+    ResumoEtapa r = { 0, 0, 0, 0 };
+    long long n = p->numQuadros < QUADROS_PERFIL ? p->numQuadros : QUADROS_PERFIL;
+    if (janela < n) n = janela;
+    if (n <= 0) return r;
+
+    float valores[QUADROS_PERFIL];
+    double soma = 0;
+    for (long long k = 0; k < n; k++) {
+        valores[k] = p->quadros[(p->numQuadros - 1 - k) % QUADROS_PERFIL][etapa];
+        soma += valores[k];
+    }
+    // p99 = valor abaixo do qual ficam 99% dos quadros
+    long long posicao = (n * 99) / 100;
+    if (posicao >= n) posicao = n - 1;
+    std::nth_element(valores, valores + posicao, valores + n);
+    r.p99 = valores[posicao];
+    r.minimo = *std::min_element(valores, valores + n);
+    r.maximo = *std::max_element(valores, valores + n);
+    r.media = (float)(soma / n);
+    return r;
+}
+
+bool SalvarPerfilCSV(const Perfilador *p, const char *caminho) {
+    FILE *arquivo = fopen(caminho, "w");
+    if (arquivo == NULL) {
+        perror(caminho);
+        return false;
+    }
+    fprintf(arquivo, "quadro");
+    for (int i = 0; i < NUM_ETAPAS; i++) fprintf(arquivo, ",%s_us", nomesEtapas[i]);
+    fprintf(arquivo, ",total_us\n");
+
+    long long primeiro = p->numQuadros > QUADROS_PERFIL ? p->numQuadros - QUADROS_PERFIL : 0;
+    for (long long q = primeiro; q < p->numQuadros; q++) {
+        const float *linha = p->quadros[q % QUADROS_PERFIL];
+        fprintf(arquivo, "%lld", q);
+        for (int i = 0; i <= NUM_ETAPAS; i++) fprintf(arquivo, ",%.2f", linha[i]);
+        fprintf(arquivo, "\n");
+    }
+    fclose(arquivo);
+    return true;
+}
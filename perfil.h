@@ -0,0 +1,67 @@
+/*
+Medio do tempo de cada etapa do quadro (perfil).
+O tempo  contado entre marcas: MarcarEtapa(p, ETAPA_X) soma em ETAPA_X o tempo desde a marca anterior,
+ento cada etapa custa uma leitura do relgio (steady_clock). Com p == NULL no mede nada.
+Cada quadro fechado vai pra um anel com os ltimos QUADROS_PERFIL quadros, de onde saem o resumo
+(mnimo, mdia e p99) e o CSV.
+*/
+#ifndef PERFIL_H
+#define PERFIL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define QUADROS_PERFIL 4096 // Quadros guardados no anel (uns 68 s a 60 FPS)
+#define JANELA_PERFIL 240   // Quadros usados no resumo da tela
+
+typedef enum {
+    ETAPA_ENTRADA = 0,       // Teclado, AplicarEntrada
+    ETAPA_PEDACOS,           // CarregarPedacos
+    ETAPA_BOTOES,            // Botes e plataformas mveis
+    ETAPA_FOGO,              // AtualizarJogador dos jogadores Fogo
+    ETAPA_AGUA,              // AtualizarJogador dos jogadores gua
+    ETAPA_COLISAO_JOGADORES, // ColidirJogadores
+    ETAPA_LIMITES,           // VerificarLimitesEReiniciar
+    ETAPA_PERIGOS,           // Diamante, perigos e portas
+    ETAPA_OUTROS,            // Resto do lao (replay, posies pra interpolar etc.)
+    ETAPA_DESENHO,           // Do BeginDrawing at antes do EndDrawing
+    ETAPA_APRESENTAR,        // EndDrawing (troca de buffers e espera do vsync)
+    NUM_ETAPAS
+} EtapaPerfil;
+
+typedef struct {
+    long long ultimaMarca;                     // ns
+    long long inicioQuadro;                    // ns
+    float atual[NUM_ETAPAS];                   // us do quadro que est sendo medido
+    float quadros[QUADROS_PERFIL][NUM_ETAPAS + 1]; // us por etapa, mais o total do quadro
+    long long numQuadros;                      // Quadros fechados desde o comeo
+} Perfilador;
+
+typedef struct {
+    float minimo;
+    float media;
+    float p99;
+    float maximo;
+} ResumoEtapa;
+
+extern const char *nomesEtapas[NUM_ETAPAS];
+
+void IniciarPerfilador(Perfilador *p);
+
+void MarcarEtapaPerfil(Perfilador *p, EtapaPerfil etapa);
+static inline void MarcarEtapa(Perfilador *p, EtapaPerfil etapa) {
+    if (p != NULL) MarcarEtapaPerfil(p, etapa);
+}
+
+// Comeo de um quadro (zera as etapas); um quadro no fechado  descartado no prximo comeo
+void ComecarQuadroPerfil(Perfilador *p);
+// Guarda o quadro no anel
+void FecharQuadroPerfil(Perfilador *p);
+
+// Resumo dos ltimos quadros (at janela) de uma etapa; etapa == NUM_ETAPAS  o quadro inteiro
+ResumoEtapa ResumirEtapa(const Perfilador *p, int etapa, int janela);
+
+// Grava os quadros do anel (do mais velho pro mais novo), um por linha, em microssegundos
+bool SalvarPerfilCSV(const Perfilador *p, const char *caminho);
+
+#endif
@@ -0,0 +1,154 @@
+// Pool de threads com roubo de trabalho (ver pool_tarefas.h)
+#include "pool_tarefas.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+
+// Faixa de tarefas [inicio, fim) de um trabalhador. O dono pega do comeo, o ladro leva a metade do fim.
+struct FaixaTarefas {
+    std::mutex trava;
+    int inicio;
+    int fim;
+};
+
+struct PoolTarefas {
+    int numTrabalhadores;
+    std::vector<std::thread> threads;
+    FaixaTarefas *faixas;
+
+    std::mutex trava;
+    std::condition_variable temLote;
+    std::condition_variable loteTerminou;
+    long long geracao;       // Aumenta a cada ExecutarTarefas (acorda as threads)
+    int ativos;              // Trabalhadores ainda rodando o lote atual
+    bool encerrar;
+
+    FuncaoTarefa funcao;
+    void *contexto;
+    std::atomic<long long> roubos;
+};
+
+static bool PegarTarefa(FaixaTarefas *faixa, int *tarefa) {
+    std::lock_guard<std::mutex> trava(faixa->trava);
+    if (faixa->inicio >= faixa->fim) return false;
+    *tarefa = faixa->inicio++;
+    return true;
+}
+
+// Rouba a metade de cima da faixa de algum e coloca na prpria
+static bool Roubar(PoolTarefas *pool, int trabalhador) {
+    for (int k = 1; k < pool->numTrabalhadores; k++) {
+        FaixaTarefas *vitima = &pool->faixas[(trabalhador + k) % pool->numTrabalhadores];
+        int inicio, fim;
+        {
+            std::lock_guard<std::mutex> trava(vitima->trava);
+            int sobra = vitima->fim - vitima->inicio;
+            if (sobra <= 0) continue;
+            int levar = (sobra + 1) / 2;
+            fim = vitima->fim;
+            inicio = fim - levar;
+            vitima->fim = inicio;
+        }
+        FaixaTarefas *minha = &pool->faixas[trabalhador];
+        std::lock_guard<std::mutex> trava(minha->trava);
+        minha->inicio = inicio;
+        minha->fim = fim;
+        pool->roubos += fim - inicio;
+        return true;
+    }
+    return false;
+}
+
+static void RodarLote(PoolTarefas *pool, int trabalhador) {
+    int tarefa;
+    for (;;) {
+        while (PegarTarefa(&pool->faixas[trabalhador], &tarefa)) pool->funcao(pool->contexto, tarefa, trabalhador);
+        if (!Roubar(pool, trabalhador)) break;
+    }
+}
+
+static void LacoTrabalhador(PoolTarefas *pool, int trabalhador) {
+    long long vista = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> trava(pool->trava);
+            pool->temLote.wait(trava, [&] { return pool->encerrar || pool->geracao != vista; });
+            if (pool->encerrar) return;
+            vista = pool->geracao;
+        }
+        RodarLote(pool, trabalhador);
+        {
+            std::lock_guard<std::mutex> trava(pool->trava);
+            if (--pool->ativos == 0) pool->loteTerminou.notify_one();
+        }
+    }
+}
+
+PoolTarefas *CriarPool(int numTrabalhadores) {
+    if (numTrabalhadores <= 0) numTrabalhadores = (int)std::thread::hardware_concurrency();
+    if (numTrabalhadores <= 0) numTrabalhadores = 1;
+
+    PoolTarefas *pool = new PoolTarefas;
+    pool->numTrabalhadores = numTrabalhadores;
+    pool->faixas = new FaixaTarefas[numTrabalhadores];
+    for (int i = 0; i < numTrabalhadores; i++) {
+        pool->faixas[i].inicio = 0;
+        pool->faixas[i].fim = 0;
+    }
+    pool->geracao = 0;
+    pool->ativos = 0;
+    pool->encerrar = false;
+    pool->funcao = NULL;
+    pool->contexto = NULL;
+    pool->roubos = 0;
+    // O trabalhador 0  quem chama ExecutarTarefas
+    for (int i = 1; i < numTrabalhadores; i++) pool->threads.emplace_back(LacoTrabalhador, pool, i);
+    return pool;
+}
+
+int TrabalhadoresPool(const PoolTarefas *pool) {
+    return pool->numTrabalhadores;
+}
+
+void ExecutarTarefas(PoolTarefas *pool, int numTarefas, FuncaoTarefa funcao, void *contexto) {
+    if (numTarefas <= 0) return;
+    pool->funcao = funcao;
+    pool->contexto = contexto;
+
+    // Faixas iguais pra comear; o roubo corrige quando umas tarefas demoram mais que outras
+    int n = pool->numTrabalhadores;
+    for (int i = 0; i < n; i++) {
+        std::lock_guard<std::mutex> trava(pool->faixas[i].trava);
+        pool->faixas[i].inicio = (int)((long long)numTarefas * i / n);
+        pool->faixas[i].fim = (int)((long long)numTarefas * (i + 1) / n);
+    }
+
+    {
+        std::lock_guard<std::mutex> trava(pool->trava);
+        pool->ativos = n - 1;
+        pool->geracao++;
+    }
+    pool->temLote.notify_all();
+
+    RodarLote(pool, 0);
+
+    std::unique_lock<std::mutex> trava(pool->trava);
+    pool->loteTerminou.wait(trava, [&] { return pool->ativos == 0; });
+}
+
+long long RoubosPool(const PoolTarefas *pool) {
+    return pool->roubos.load();
+}
+
+void DestruirPool(PoolTarefas *pool) {
+    {
+        std::lock_guard<std::mutex> trava(pool->trava);
+        pool->encerrar = true;
+    }
+    pool->temLote.notify_all();
+    for (size_t i = 0; i < pool->threads.size(); i++) pool->threads[i].join();
+    delete[] pool->faixas;
+    delete pool;
+}
@@ -0,0 +1,26 @@
+/*
+Pool de threads com roubo de trabalho, usado por quem roda muitas simulaes (ambientes.h e ferramentas).
+ExecutarTarefas divide as tarefas 0..n-1 em faixas, uma por trabalhador; quem termina a sua
+rouba a metade de cima da faixa de outro. A thread que chama tambm trabalha (trabalhador 0).
+*/
+#ifndef POOL_TAREFAS_H
+#define POOL_TAREFAS_H
+
+// tarefa vai de 0 a numTarefas-1; trabalhador de 0 a numTrabalhadores-1 (pra cada um ter seu prprio Mundo etc.)
+typedef void (*FuncaoTarefa)(void *contexto, int tarefa, int trabalhador);
+
+typedef struct PoolTarefas PoolTarefas;
+
+// numTrabalhadores <= 0 usa um por ncleo
+PoolTarefas *CriarPool(int numTrabalhadores);
+int TrabalhadoresPool(const PoolTarefas *pool);
+
+// Roda todas as tarefas e s volta quando terminarem
+void ExecutarTarefas(PoolTarefas *pool, int numTarefas, FuncaoTarefa funcao, void *contexto);
+
+// Quantas tarefas foram roubadas desde a criao (pra ver se a diviso est equilibrada)
+long long RoubosPool(const PoolTarefas *pool);
+
+void DestruirPool(PoolTarefas *pool);
+
+#endif
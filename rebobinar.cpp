@@ -0,0 +1,371 @@
+// Voltar no tempo com um anel de diferenas entre passos (ver rebobinar.h)
+#include "rebobinar.h"
+#include "cinematica.h"
+#include "memoria.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Posies fixas do comeo do estado; depois vm os jogadores, as mveis carregadas e o grafo de gatilhos
+enum {
+    EST_PALAVRAS,       // Palavras do estado inteiro
+    EST_PASSOS_BAIXO,
+    EST_PASSOS_ALTO,
+    EST_DIAMANTE,       // diamanteColetado
+    EST_DIAMANTES,      // diamantesColetados
+    EST_JOGADORES,
+    EST_CABECALHO
+};
+#define PALAVRAS_JOGADOR 9 // Posio, velocidade, podePular e a caixa de pedaos
+#define PALAVRAS_MOVEL   6 // Id, x, y, ativa/acordada, tempo e arrasto
+#define CAIXA_JOGADOR    5 // Onde a caixa de pedaos comea nas palavras do jogador
+
+// Na segunda palavra de uma diferena: ela  uma lista de pares posio/XOR em vez de mscara
+#define DIFERENCA_ESPARSA 0x80000000u
+
+static inline uint32_t Bits(float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+static inline float Real(uint32_t u) {
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+static int MaxPalavras(const Mundo *mundo) {
+    return EST_CABECALHO + mundo->numJogadores * PALAVRAS_JOGADOR + 1 + mundo->faseAtual->numPlataformasMoveis * PALAVRAS_MOVEL +
+           MaxPalavrasGatilhos(&mundo->gatilhos);
+}
+
+// Posio da palavra com o nmero de mveis (as mveis vm logo depois dela e o grafo depois delas)
+static inline int InicioMoveis(const Mundo *mundo) {
+    return EST_CABECALHO + mundo->numJogadores * PALAVRAS_JOGADOR;
+}
+
+static void SerializarCabecalho(const Mundo *mundo, uint32_t s[]) {
+    s[EST_PASSOS_BAIXO] = (uint32_t)(mundo->passosFase & 0xFFFFFFFFu);
+    s[EST_PASSOS_ALTO] = (uint32_t)((unsigned long long)mundo->passosFase >> 32);
+    s[EST_DIAMANTE] = mundo->diamanteColetado;
+    s[EST_DIAMANTES] = (uint32_t)mundo->diamantesColetados;
+    s[EST_JOGADORES] = (uint32_t)mundo->numJogadores;
+}
+
+static void SerializarJogador(const Mundo *mundo, int k, uint32_t s[]) {
+    const Jogador *j = &mundo->jogadores[k];
+    s[0] = Bits(j->posicao.x);
+    s[1] = Bits(j->posicao.y);
+    s[2] = Bits(j->velocidade.x);
+    s[3] = Bits(j->velocidade.y);
+    s[4] = j->podePular;
+    for (int c = 0; c < 4; c++) s[CAIXA_JOGADOR + c] = (uint32_t)mundo->caixaPedacos[k][c];
+}
+
+static void SerializarMovel(const Mundo *mundo, int i, uint32_t s[]) {
+    const PlataformaMovel *p = &mundo->plataformasMoveisAtuais[i];
+    const CorpoCinematico *c = &mundo->corpos[i];
+    s[0] = (uint32_t)mundo->carregadosMoveis.ids[i];
+    s[1] = Bits(p->retangulo.x);
+    s[2] = Bits(p->retangulo.y);
+    s[3] = (uint32_t)p->ativa | ((uint32_t)c->acordada << 1);
+    s[4] = Bits(c->tempo);
+    s[5] = Bits(c->arrastoX);
+}
+
+static int Serializar(const Mundo *mundo, uint32_t s[]) {
+    SerializarCabecalho(mundo, s);
+    int n = EST_CABECALHO;
+    for (int k = 0; k < mundo->numJogadores; k++, n += PALAVRAS_JOGADOR) SerializarJogador(mundo, k, &s[n]);
+    s[n++] = (uint32_t)mundo->numPlataformasMoveisAtuais;
+    for (int i = 0; i < mundo->numPlataformasMoveisAtuais; i++, n += PALAVRAS_MOVEL) SerializarMovel(mundo, i, &s[n]);
+    n += SalvarGatilhos(&mundo->gatilhos, &s[n]);
+    s[EST_PALAVRAS] = (uint32_t)n;
+    return n;
+}
+
+// Pe o estado s no mundo; devolve true se precisou recarregar os pedaos
+static bool Restaurar(const uint32_t s[], Mundo *mundo) {
+    mundo->passosFase = (long long)(((unsigned long long)s[EST_PASSOS_ALTO] << 32) | s[EST_PASSOS_BAIXO]);
+    mundo->diamanteColetado = s[EST_DIAMANTE] != 0;
+    mundo->diamantesColetados = (int)s[EST_DIAMANTES];
+    mundo->estado = JOGANDO;
+
+    // O grafo primeiro: os itens recarregados vm ligados ou no conforme ele
+    int n = InicioMoveis(mundo);
+    int numMoveis = (int)s[n];
+    RestaurarGatilhos(&mundo->gatilhos, &s[n + 1 + numMoveis * PALAVRAS_MOVEL]);
+
+    bool trocouCaixa = false;
+    n = EST_CABECALHO;
+    for (int k = 0; k < mundo->numJogadores; k++) {
+        Jogador *j = &mundo->jogadores[k];
+        j->posicao = (Vector2){ Real(s[n]), Real(s[n + 1]) };
+        j->velocidade = (Vector2){ Real(s[n + 2]), Real(s[n + 3]) };
+        j->podePular = s[n + 4] != 0;
+        n += 5;
+        for (int c = 0; c < 4; c++, n++) {
+            if (mundo->caixaPedacos[k][c] != (int)s[n]) trocouCaixa = true;
+            mundo->caixaPedacos[k][c] = (int)s[n];
+        }
+    }
+    // Mesmas caixas, mesmos itens carregados (a escolha s depende delas)
+    if (trocouCaixa) RecarregarPedacos(mundo);
+
+    const GrafoGatilhos *g = &mundo->gatilhos;
+    for (int i = 0; i < mundo->numBotoesAtuais; i++)
+        mundo->botoesAtuais[i].pressionado = BotaoLigado(g, mundo->carregadosBotoes.ids[i]);
+
+    n++;
+    for (int i = 0; i < numMoveis && i < mundo->numPlataformasMoveisAtuais; i++, n += PALAVRAS_MOVEL) {
+        PlataformaMovel *p = &mundo->plataformasMoveisAtuais[i];
+        CorpoCinematico *c = &mundo->corpos[i];
+        p->retangulo.x = Real(s[n + 1]);
+        p->retangulo.y = Real(s[n + 2]);
+        p->ativa = (s[n + 3] & 1) != 0;
+        c->acordada = (s[n + 3] & 2) != 0;
+        c->tempo = Real(s[n + 4]);
+        c->arrastoX = Real(s[n + 5]);
+    }
+    RestaurarMoveis(mundo);
+    return trocouCaixa;
+}
+
+void IniciarRebobinador(Rebobinador *r, int maxPassos, int maxBytes) {
+    memset(r, 0, sizeof(*r));
+    r->maxPassos = maxPassos;
+    r->capAnel = maxBytes / (int)sizeof(uint32_t);
+    r->anel = (uint32_t *)malloc(sizeof(uint32_t) * (size_t)(r->capAnel > 0 ? r->capAnel : 1));
+}
+
+void LiberarRebobinador(Rebobinador *r) {
+    free(r->anel);
+    free(r->atual);
+    free(r->novo);
+    free(r->mascara);
+    free(r->trocas);
+    free(r->acordadas);
+    memset(r, 0, sizeof(*r));
+}
+
+static void EsvaziarAnel(Rebobinador *r) {
+    r->inicio = 0;
+    r->usadas = 0;
+    r->numPassos = 0;
+}
+
+// Mveis acordadas no estado que acabou de ser guardado (ou voltado)
+static void LembrarAcordadas(Rebobinador *r, const Mundo *mundo) {
+    memcpy(r->acordadas, mundo->acordadas, sizeof(int) * (size_t)mundo->numAcordadas);
+    r->numAcordadas = mundo->numAcordadas;
+}
+
+void ComecarRebobinador(Rebobinador *r, const Mundo *mundo) {
+    int max = MaxPalavras(mundo);
+    if (max > r->capEstado) {
+        free(r->atual);
+        free(r->novo);
+        free(r->mascara);
+        free(r->trocas);
+        r->atual = (uint32_t *)malloc(sizeof(uint32_t) * (size_t)max);
+        r->novo = (uint32_t *)malloc(sizeof(uint32_t) * (size_t)max);
+        r->mascara = (uint32_t *)malloc(sizeof(uint32_t) * (size_t)((max + 31) / 32));
+        r->trocas = (uint32_t *)malloc(sizeof(uint32_t) * 2 * (size_t)max);
+        r->capEstado = max;
+    }
+    r->acordadas = (int *)Reservar(r->acordadas, &r->capAcordadas, mundo->faseAtual->numPlataformasMoveis, sizeof(int));
+    r->fase = mundo->faseAtual;
+    r->numJogadores = mundo->numJogadores;
+    EsvaziarAnel(r);
+    memset(r->atual, 0, sizeof(uint32_t) * (size_t)r->capEstado);
+    r->numAtual = Serializar(mundo, r->atual);
+    LembrarAcordadas(r, mundo);
+}
+
+// Palavra numa posio do anel (as posies passam do fim e do a volta)
+static inline uint32_t *NoAnel(Rebobinador *r, int posicao) {
+    return &r->anel[posicao % r->capAnel];
+}
+
+static void DescartarMaisAntiga(Rebobinador *r) {
+    int tamanho = (int)*NoAnel(r, r->inicio);
+    r->inicio = (r->inicio + tamanho) % r->capAnel;
+    r->usadas -= tamanho;
+    r->numPassos--;
+}
+
+// Pe o valor na palavra i do estado guardado e anota a troca, se mudou. Num mesmo passo a mesma palavra
+// s recebe o mesmo valor de novo, ento cada posio  anotada no mximo uma vez.
+static inline void Escrever(Rebobinador *r, int i, uint32_t valor) {
+    uint32_t x = r->atual[i] ^ valor;
+    if (x == 0) return;
+    r->atual[i] = valor;
+    r->trocas[2 * r->numTrocas] = (uint32_t)i;
+    r->trocas[2 * r->numTrocas + 1] = x;
+    r->numTrocas++;
+}
+
+static void EscreverVarias(Rebobinador *r, int inicio, const uint32_t s[], int n) {
+    for (int w = 0; w < n; w++) Escrever(r, inicio + w, s[w]);
+}
+
+static void EscreverMovel(Rebobinador *r, const Mundo *mundo, int i) {
+    uint32_t s[PALAVRAS_MOVEL];
+    SerializarMovel(mundo, i, s);
+    EscreverVarias(r, InicioMoveis(mundo) + 1 + i * PALAVRAS_MOVEL, s, PALAVRAS_MOVEL);
+}
+
+// Estado inteiro; devolve o nmero de palavras
+static int EscreverTudo(Rebobinador *r, const Mundo *mundo) {
+    int numNovo = Serializar(mundo, r->novo);
+    EscreverVarias(r, 0, r->novo, numNovo);
+    for (int i = numNovo; i < r->numAtual; i++) Escrever(r, i, 0);
+    return numNovo;
+}
+
+// S o que um passo pode ter mudado: cabealho, jogadores, mveis acordadas (agora ou no estado guardado) ou
+// que o grafo mudou, e os ns que o grafo tocou. Devolve o nmero de palavras, ou -1 sem escrever nada se o
+// passo no segue o guardado com os mesmos itens carregados (recomeo, troca de pedaos, passo no guardado).
+static int EscreverPasso(Rebobinador *r, const Mundo *mundo) {
+    const uint32_t *a = r->atual;
+    long long passos = (long long)(((unsigned long long)a[EST_PASSOS_ALTO] << 32) | a[EST_PASSOS_BAIXO]);
+    int inicioMoveis = InicioMoveis(mundo);
+    int numMoveis = mundo->numPlataformasMoveisAtuais;
+    if (mundo->passosFase != passos + 1 || (int)a[inicioMoveis] != numMoveis) return -1;
+    // Mesmas caixas, mesmos itens carregados
+    for (int k = 0; k < mundo->numJogadores; k++)
+        if (memcmp(&a[EST_CABECALHO + k * PALAVRAS_JOGADOR + CAIXA_JOGADOR], mundo->caixaPedacos[k], sizeof(mundo->caixaPedacos[k])) != 0)
+            return -1;
+
+    uint32_t s[EST_CABECALHO > PALAVRAS_JOGADOR ? EST_CABECALHO : PALAVRAS_JOGADOR];
+    SerializarCabecalho(mundo, s);
+    EscreverVarias(r, EST_PASSOS_BAIXO, &s[EST_PASSOS_BAIXO], EST_CABECALHO - EST_PASSOS_BAIXO);
+    for (int k = 0; k < mundo->numJogadores; k++) {
+        SerializarJogador(mundo, k, s);
+        EscreverVarias(r, EST_CABECALHO + k * PALAVRAS_JOGADOR, s, PALAVRAS_JOGADOR);
+    }
+
+    // A mvel que dormiu neste passo estava acordada no guardado; a que o grafo ligou ou desligou pode ter
+    // acordado e dormido no mesmo passo
+    for (int k = 0; k < r->numAcordadas; k++) EscreverMovel(r, mundo, r->acordadas[k]);
+    for (int k = 0; k < mundo->numAcordadas; k++) EscreverMovel(r, mundo, mundo->acordadas[k]);
+    const GrafoGatilhos *g = &mundo->gatilhos;
+    int primeiraMovel = g->numBotoes + g->numLogicos;
+    for (int m = 0; m < g->numMudados; m++) {
+        if (g->mudados[m] < primeiraMovel) continue;
+        int i = IndiceCarregado(&mundo->carregadosMoveis, g->mudados[m] - primeiraMovel);
+        if (i >= 0) EscreverMovel(r, mundo, i);
+    }
+
+    // Sem n tocado o grafo no mudou (nem o tamanho das listas); o rascunho recebe as partes dele nas
+    // posies do estado
+    int numNovo = r->numAtual;
+    if (g->numTocados > 0) {
+        int inicioGrafo = inicioMoveis + 1 + numMoveis * PALAVRAS_MOVEL;
+        uint32_t *grafo = &r->novo[inicioGrafo];
+        for (int t = 0; t < g->numTocados; t++) {
+            int k = g->tocados[t];
+            int posNo = CABECALHO_GATILHOS + PALAVRAS_NO_GATILHO * k;
+            SalvarNoGatilhos(g, k, grafo);
+            EscreverVarias(r, inicioGrafo + posNo, &grafo[posNo], PALAVRAS_NO_GATILHO);
+        }
+        int fimGrafo = SalvarListasGatilhos(g, grafo);
+        int inicioListas = CABECALHO_GATILHOS + PALAVRAS_NO_GATILHO * g->numNos;
+        EscreverVarias(r, inicioGrafo, grafo, CABECALHO_GATILHOS);
+        EscreverVarias(r, inicioGrafo + inicioListas, &grafo[inicioListas], fimGrafo - inicioListas);
+        numNovo = inicioGrafo + fimGrafo;
+        for (int i = numNovo; i < r->numAtual; i++) Escrever(r, i, 0);
+    }
+    Escrever(r, EST_PALAVRAS, (uint32_t)numNovo);
+    return numNovo;
+}
+
+// Pe as trocas anotadas no anel como uma diferena, esparsa ou com mscara (a menor)
+static void GuardarDiferenca(Rebobinador *r, int cobertas) {
+    int mudadas = r->numTrocas;
+    int palavrasMascara = (cobertas + 31) / 32;
+    bool esparsa = mudadas < palavrasMascara;
+    int tamanho = 3 + (esparsa ? 2 * mudadas : palavrasMascara + mudadas);
+
+    if (tamanho > r->capAnel || r->maxPassos <= 0) {
+        EsvaziarAnel(r); // No cabe nem sozinha: no d pra voltar deste passo
+        return;
+    }
+    while (r->numPassos > 0 && (r->usadas + tamanho > r->capAnel || r->numPassos >= r->maxPassos)) DescartarMaisAntiga(r);
+    int pos = r->inicio + r->usadas;
+    *NoAnel(r, pos) = (uint32_t)tamanho;
+    if (esparsa) {
+        *NoAnel(r, pos + 1) = DIFERENCA_ESPARSA | (uint32_t)mudadas;
+        for (int t = 0; t < 2 * mudadas; t++) *NoAnel(r, pos + 2 + t) = r->trocas[t];
+    } else {
+        // Os XOR vo na ordem das posies: o rascunho guarda o de cada posio anotada
+        *NoAnel(r, pos + 1) = (uint32_t)cobertas;
+        memset(r->mascara, 0, sizeof(uint32_t) * (size_t)palavrasMascara);
+        for (int t = 0; t < mudadas; t++) {
+            int i = (int)r->trocas[2 * t];
+            r->mascara[i / 32] |= 1u << (i % 32);
+            r->novo[i] = r->trocas[2 * t + 1];
+        }
+        int posMascara = pos + 2, posValor = pos + 2 + palavrasMascara;
+        for (int w = 0; w < palavrasMascara; w++) {
+            uint32_t mascara = r->mascara[w];
+            *NoAnel(r, posMascara + w) = mascara;
+            while (mascara != 0) {
+                int i = w * 32 + __builtin_ctz(mascara);
+                mascara &= mascara - 1;
+                *NoAnel(r, posValor++) = r->novo[i];
+            }
+        }
+    }
+    *NoAnel(r, pos + tamanho - 1) = (uint32_t)tamanho;
+    r->usadas += tamanho;
+    r->numPassos++;
+}
+
+void GuardarPasso(Rebobinador *r, const Mundo *mundo) {
+    if (mundo->faseAtual != r->fase || mundo->numJogadores != r->numJogadores || r->atual == NULL) {
+        ComecarRebobinador(r, mundo);
+        return;
+    }
+    int numAntigo = r->numAtual;
+    r->numTrocas = 0;
+    int numNovo = EscreverPasso(r, mundo);
+    if (numNovo < 0) numNovo = EscreverTudo(r, mundo);
+    r->numAtual = numNovo;
+    GuardarDiferenca(r, (numNovo > numAntigo) ? numNovo : numAntigo);
+    LembrarAcordadas(r, mundo);
+}
+
+bool VoltarPasso(Rebobinador *r, Mundo *mundo, bool *recarregou) {
+    *recarregou = false;
+    if (r->numPassos == 0 || mundo->faseAtual != r->fase || mundo->numJogadores != r->numJogadores) return false;
+
+    // Diferena mais nova: o tamanho est na ltima palavra dela. O estado guardado  zero depois do fim, ento
+    // o XOR d o estado anterior mesmo onde os tamanhos so diferentes.
+    int fim = r->inicio + r->usadas;
+    int tamanho = (int)*NoAnel(r, fim - 1);
+    int pos = fim - tamanho;
+    uint32_t cabeca = *NoAnel(r, pos + 1);
+    if (cabeca & DIFERENCA_ESPARSA) {
+        int mudadas = (int)(cabeca & ~DIFERENCA_ESPARSA);
+        for (int t = 0; t < mudadas; t++) r->atual[*NoAnel(r, pos + 2 + 2 * t)] ^= *NoAnel(r, pos + 3 + 2 * t);
+    } else {
+        int palavrasMascara = ((int)cabeca + 31) / 32;
+        int posValor = pos + 2 + palavrasMascara;
+        for (int w = 0; w < palavrasMascara; w++) {
+            uint32_t mascara = *NoAnel(r, pos + 2 + w);
+            while (mascara != 0) {
+                int i = w * 32 + __builtin_ctz(mascara);
+                mascara &= mascara - 1;
+                r->atual[i] ^= *NoAnel(r, posValor++);
+            }
+        }
+    }
+    r->numAtual = (int)r->atual[EST_PALAVRAS];
+    r->usadas -= tamanho;
+    r->numPassos--;
+
+    *recarregou = Restaurar(r->atual, mundo);
+    LembrarAcordadas(r, mundo);
+    return true;
+}
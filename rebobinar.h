@@ -0,0 +1,69 @@
+/*
+Voltar no tempo: depois de cada passo o estado que muda na fase (jogadores, caixas de pedaos, mveis
+carregadas com os corpos, diamante e o grafo de gatilhos) vira uma lista de palavras de 32 bits, e o anel
+guarda s a diferena (XOR) dela pro estado do passo anterior: as palavras que mudaram, como pares posio e
+XOR ou como uma mscara e os XOR (o que for menor). Como XOR desfaz ele mesmo, aplicar a diferena mais nova no
+estado atual d o estado do passo anterior, e assim por diante at a diferena mais antiga que ainda cabe no anel.
+
+Num passo comum s  escrito de novo o que pode ter mudado: os jogadores, as mveis acordadas (agora ou no
+passo anterior) ou ligadas e desligadas pelo grafo, e os ns que o grafo tocou. Fases com muitas mveis e
+botes paradas no pagam por elas. Recomeo da fase, troca de pedaos ou passo no guardado escrevem tudo.
+
+O anel tem limite de passos e de memria (o que passar de um dos dois descarta as diferenas mais antigas)
+e  reservado uma vez s; o estado inteiro tem o tamanho mximo da fase, reservado ao comear a fase.
+Durante o jogo nada  alocado. O estado voltado  exatamente o que o mundo tinha naquele passo.
+*/
+#ifndef REBOBINAR_H
+#define REBOBINAR_H
+
+#include <stdint.h>
+#include "simulacao.h"
+
+typedef struct {
+    // Anel de diferenas, em palavras. Cada diferena  [tamanho][palavras cobertas][mscara..][XOR..][tamanho]
+    // ou [tamanho][DIFERENCA_ESPARSA | mudadas][posio, XOR..][tamanho] (o tamanho nas duas pontas deixa tirar
+    // a mais nova pelo fim e descartar a mais antiga pelo comeo)
+    uint32_t *anel;
+    int capAnel;
+    int inicio;         // Primeira palavra da diferena mais antiga
+    int usadas;
+    int numPassos;      // Diferenas no anel (passos que d pra voltar)
+    int maxPassos;
+
+    // Estado inteiro do ltimo passo guardado (zerado depois de numAtual) e um rascunho (capEstado palavras cada)
+    uint32_t *atual;
+    uint32_t *novo;
+    uint32_t *mascara;  // Rascunho da mscara de uma diferena
+    uint32_t *trocas;   // Palavras que mudaram no passo: posio e XOR (2 * capEstado)
+    int numTrocas;
+    int numAtual;
+    int capEstado;
+    int *acordadas;     // Mveis acordadas no estado guardado (podem ter dormido no passo seguinte)
+    int numAcordadas;
+    int capAcordadas;
+    const DadosFase *fase; // Fase do estado guardado (outra fase recomea o anel)
+    int numJogadores;
+} Rebobinador;
+
+// maxPassos  quantos passos d pra voltar no mximo e maxBytes a memria do anel
+void IniciarRebobinador(Rebobinador *r, int maxPassos, int maxBytes);
+void LiberarRebobinador(Rebobinador *r);
+
+// Esquece tudo e guarda o estado atual do mundo como o primeiro (chamar depois de carregar a fase ou trocar
+// o nmero de jogadores;  a nica que pode alocar)
+void ComecarRebobinador(Rebobinador *r, const Mundo *mundo);
+
+// Guarda o estado do mundo depois de um passo (ou de um ReiniciarFase). Chamar depois de todo passo (o passo
+// seguinte a um que ficou sem guardar escreve o estado inteiro)
+void GuardarPasso(Rebobinador *r, const Mundo *mundo);
+
+// Volta o mundo um passo guardado (o estado fica JOGANDO). Devolve false se no tem mais pra onde voltar.
+// recarregou diz se os pedaos carregados mudaram (os ndices das mveis e botes Atuais mudam, como PASSO_PEDACOS).
+bool VoltarPasso(Rebobinador *r, Mundo *mundo, bool *recarregou);
+
+// Bytes que as diferenas guardadas ocupam agora
+static inline int BytesRebobinador(const Rebobinador *r) {
+    return r->usadas * (int)sizeof(uint32_t);
+}
+
+#endif
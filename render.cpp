@@ -0,0 +1,216 @@
+// Desenho com camada esttica e contador de chamadas (ver render.h)
+#include "render.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Desenha as partes fixas da fase, na ordem em que o jogo sempre desenhou (a fase que cabe na tela est
+// sempre inteira carregada)
+static int DesenharPartesFixas(const DadosFase *fase) {
+    for (int i = 0; i < fase->numPlataformas; i++)
+        DrawRectangleRec(fase->plataformas[i].retangulo, DARKGRAY);
+    for (int i = 0; i < fase->numPerigos; i++)
+        DrawRectangleRec(fase->perigos[i].retangulo, fase->perigos[i].cor);
+    for (int i = 0; i < fase->numPortas; i++)
+        DrawRectangleRec(fase->portas[i].retangulo, fase->portas[i].cor);
+    return fase->numPlataformas + fase->numPerigos + fase->numPortas;
+}
+
+// Fase que cabe inteira na tela: cmera parada e camada esttica
+static bool FaseNaTela(const RetratoMundo *retrato) {
+    return retrato->larguraFase <= LARGURA_TELA && retrato->alturaFase <= ALTURA_TELA;
+}
+
+// Monta a tabela de pedaos da fase se ela trocou (os mesmos TAM_PEDACO da simulao)
+static void PrepararPedacos(Renderizador *r, const DadosFase *fase) {
+    if (r->faseDosPedacos == fase) return;
+    // Fase de pacote sem itens de um tipo tem o ponteiro NULL
+    ConstruirGrade(&r->pedacosPlataformas, fase->numPlataformas > 0 ? &fase->plataformas[0].retangulo : NULL, sizeof(Plataforma), fase->numPlataformas, TAM_PEDACO);
+    ConstruirGrade(&r->pedacosPerigos, fase->numPerigos > 0 ? &fase->perigos[0].retangulo : NULL, sizeof(Perigo), fase->numPerigos, TAM_PEDACO);
+    ConstruirGrade(&r->pedacosBotoes, fase->numBotoes > 0 ? &fase->botoes[0].retangulo : NULL, sizeof(Botao), fase->numBotoes, TAM_PEDACO);
+    ConstruirGrade(&r->pedacosMoveis, fase->numPlataformasMoveis > 0 ? &fase->plataformasMoveis[0].retangulo : NULL, sizeof(PlataformaMovel),
+                   fase->numPlataformasMoveis, TAM_PEDACO);
+    int n = (fase->numBotoes > fase->numPlataformasMoveis) ? fase->numBotoes : fase->numPlataformasMoveis;
+    if (n > r->capCarregados) {
+        free(r->carregados);
+        r->carregados = (unsigned char *)calloc((size_t)n, 1);
+        r->capCarregados = n;
+    }
+    r->faseDosPedacos = fase;
+}
+
+// Ids (em r->ids) dos itens da tabela de pedaos que esto nas clulas de area
+static int ConsultarVisiveis(Renderizador *r, const GradeColisao *pedacos, Rectangle area) {
+    for (;;) {
+        int n = ConsultarGradeArea(pedacos, area, r->ids, r->capIds);
+        if (n <= r->capIds) return n;
+        free(r->ids);
+        r->capIds = n * 2;
+        r->ids = (int *)malloc(sizeof(int) * (size_t)r->capIds);
+    }
+}
+
+// Partes fixas que aparecem em area, direto dos dados da fase (no s as carregadas)
+static int DesenharPartesVisiveis(Renderizador *r, const DadosFase *fase, Rectangle area) {
+    PrepararPedacos(r, fase);
+    int n = ConsultarVisiveis(r, &r->pedacosPlataformas, area);
+    for (int i = 0; i < n; i++) DrawRectangleRec(fase->plataformas[r->ids[i]].retangulo, DARKGRAY);
+    int total = n;
+    n = ConsultarVisiveis(r, &r->pedacosPerigos, area);
+    for (int i = 0; i < n; i++) DrawRectangleRec(fase->perigos[r->ids[i]].retangulo, fase->perigos[r->ids[i]].cor);
+    total += n;
+    for (int i = 0; i < fase->numPortas; i++)
+        DrawRectangleRec(fase->portas[i].retangulo, fase->portas[i].cor);
+    return total + fase->numPortas;
+}
+
+Camera2D CameraDosJogadores(const RetratoMundo *retrato, const Vector2 pos[], int num) {
+    Camera2D camera = { 0 };
+    camera.offset = (Vector2){ LARGURA_TELA / 2.0f, ALTURA_TELA / 2.0f };
+
+    // Caixa em volta de todos os jogadores
+    float minX = pos[0].x, maxX = pos[0].x, minY = pos[0].y, maxY = pos[0].y;
+    for (int k = 1; k < num; k++) {
+        minX = fminf(minX, pos[k].x);
+        maxX = fmaxf(maxX, pos[k].x);
+        minY = fminf(minY, pos[k].y);
+        maxY = fmaxf(maxY, pos[k].y);
+    }
+
+    // Afasta pra caber todos, mas no mais que ZOOM_MINIMO nem a ponto de mostrar fora da fase
+    float largura = (maxX - minX) + 2 * MARGEM_CAMERA;
+    float altura = (maxY - minY) + 2 * MARGEM_CAMERA;
+    float zoom = fminf(1.0f, fminf(LARGURA_TELA / largura, ALTURA_TELA / altura));
+    float zoomFase = fmaxf(LARGURA_TELA / retrato->larguraFase, ALTURA_TELA / retrato->alturaFase);
+    camera.zoom = fmaxf(zoom, fmaxf(ZOOM_MINIMO, zoomFase));
+
+    // Meio da caixa dos jogadores (a posio  a base do cubo), preso nas bordas da fase
+    float meiaLargura = LARGURA_TELA / (2.0f * camera.zoom), meiaAltura = ALTURA_TELA / (2.0f * camera.zoom);
+    float x = (minX + maxX) / 2.0f, y = (minY + maxY) / 2.0f - 10.0f;
+    camera.target.x = fminf(fmaxf(x, meiaLargura), retrato->larguraFase - meiaLargura);
+    camera.target.y = fminf(fmaxf(y, meiaAltura), retrato->alturaFase - meiaAltura);
+    return camera;
+}
+
+Rectangle AreaDaCamera(Camera2D camera) {
+    return (Rectangle){ camera.target.x - camera.offset.x / camera.zoom, camera.target.y - camera.offset.y / camera.zoom,
+                        LARGURA_TELA / camera.zoom, ALTURA_TELA / camera.zoom };
+}
+
+void IniciarRenderizador(Renderizador *r) {
+    r->camada = LoadRenderTexture(LARGURA_TELA, ALTURA_TELA);
+    r->faseDaCamada = NULL;
+    r->usarCamada = IsRenderTextureReady(r->camada);
+    r->chamadas = 0;
+    r->chamadasSemCamada = 0;
+    r->ids = NULL;
+    r->capIds = 0;
+    r->faseDosPedacos = NULL;
+    r->pedacosPlataformas = r->pedacosPerigos = r->pedacosBotoes = r->pedacosMoveis = (GradeColisao){0};
+    r->carregados = NULL;
+    r->capCarregados = 0;
+    if (!r->usarCamada) printf("[DEBUG] Sem RenderTexture, desenhando a fase item por item\n");
+}
+
+void LiberarRenderizador(Renderizador *r) {
+    if (IsRenderTextureReady(r->camada)) UnloadRenderTexture(r->camada);
+    r->faseDaCamada = NULL;
+    free(r->ids);
+    r->ids = NULL;
+    r->capIds = 0;
+    LiberarGrade(&r->pedacosPlataformas);
+    LiberarGrade(&r->pedacosPerigos);
+    LiberarGrade(&r->pedacosBotoes);
+    LiberarGrade(&r->pedacosMoveis);
+    r->faseDosPedacos = NULL;
+    free(r->carregados);
+    r->carregados = NULL;
+    r->capCarregados = 0;
+}
+
+void ComecarQuadro(Renderizador *r) {
+    r->chamadas = 0;
+    r->chamadasSemCamada = 0;
+}
+
+void DesenharCenarioEstatico(Renderizador *r, const RetratoMundo *retrato, Rectangle area) {
+    const DadosFase *fase = retrato->fase;
+    if (!FaseNaTela(retrato)) {
+        ClearBackground(COR_FUNDO);
+        int desenhadas = 1 + DesenharPartesVisiveis(r, fase, area);
+        r->chamadas += desenhadas;
+        r->chamadasSemCamada += desenhadas;
+        return;
+    }
+
+    int numFixas = fase->numPlataformas + fase->numPerigos + fase->numPortas;
+    r->chamadasSemCamada += 1 + numFixas; // Fundo + um retngulo por parte fixa
+
+    if (!r->usarCamada) {
+        ClearBackground(COR_FUNDO);
+        r->chamadas += 1 + DesenharPartesFixas(fase);
+        return;
+    }
+
+    // A camada s  redesenhada quando a fase troca (reiniciar no mexe nas partes fixas)
+    if (r->faseDaCamada != fase) {
+        BeginTextureMode(r->camada);
+            ClearBackground(COR_FUNDO);
+            DesenharPartesFixas(fase);
+        EndTextureMode();
+        r->faseDaCamada = fase;
+    }
+
+    // Textura do OpenGL fica de cabea pra baixo, por isso a altura negativa
+    Rectangle origem = { 0, 0, (float)r->camada.texture.width, -(float)r->camada.texture.height };
+    DrawTextureRec(r->camada.texture, origem, (Vector2){ 0, 0 }, WHITE);
+    r->chamadas++;
+}
+
+void DesenharMoveisDescarregados(Renderizador *r, const RetratoMundo *retrato, Rectangle area) {
+    const DadosFase *fase = retrato->fase;
+    if (retrato->numMoveis < fase->numPlataformasMoveis) {
+        PrepararPedacos(r, fase);
+        for (int i = 0; i < retrato->numMoveis; i++) r->carregados[retrato->moveis[i].id] = 1;
+        int n = ConsultarVisiveis(r, &r->pedacosMoveis, area);
+        for (int i = 0; i < n; i++)
+            if (!r->carregados[r->ids[i]])
+                DesenharRetangulo(r, fase->plataformasMoveis[r->ids[i]].retangulo, (Color){100, 100, 100, 255});
+        for (int i = 0; i < retrato->numMoveis; i++) r->carregados[retrato->moveis[i].id] = 0;
+    }
+    if (retrato->numBotoes < fase->numBotoes) {
+        PrepararPedacos(r, fase);
+        for (int i = 0; i < retrato->numBotoes; i++) r->carregados[retrato->botoes[i].id] = 1;
+        int n = ConsultarVisiveis(r, &r->pedacosBotoes, area);
+        for (int i = 0; i < n; i++)
+            if (!r->carregados[r->ids[i]])
+                DesenharRetangulo(r, fase->botoes[r->ids[i]].retangulo, fase->botoes[r->ids[i]].cor);
+        for (int i = 0; i < retrato->numBotoes; i++) r->carregados[retrato->botoes[i].id] = 0;
+    }
+}
+
+void DesenharRetangulo(Renderizador *r, Rectangle rec, Color cor) {
+    DrawRectangleRec(rec, cor);
+    r->chamadas++;
+    r->chamadasSemCamada++;
+}
+
+void DesenharPerfil(const Perfilador *p, int x, int y) {
+    const int linha = 14, fonte = 10;
+    const int colunas[4] = { x, x + 120, x + 180, x + 240 }; // A fonte padro no  monoespaada
+    DrawRectangle(x - 4, y - 4, 300, (NUM_ETAPAS + 2) * linha + 8, Fade(BLACK, 0.6f));
+    DrawText(TextFormat("us (%d quadros)", JANELA_PERFIL), colunas[0], y, fonte, LIGHTGRAY);
+    DrawText("min", colunas[1], y, fonte, LIGHTGRAY);
+    DrawText("media", colunas[2], y, fonte, LIGHTGRAY);
+    DrawText("p99", colunas[3], y, fonte, LIGHTGRAY);
+    for (int i = 0; i <= NUM_ETAPAS; i++) {
+        ResumoEtapa r = ResumirEtapa(p, i, JANELA_PERFIL);
+        int yLinha = y + (i + 1) * linha;
+        // Etapa que passa de 1 ms no p99 fica em destaque
+        Color cor = (i < NUM_ETAPAS && r.p99 > 1000.0f) ? ORANGE : WHITE;
+        DrawText((i < NUM_ETAPAS) ? nomesEtapas[i] : "quadro", colunas[0], yLinha, fonte, cor);
+        DrawText(TextFormat("%.1f", r.minimo), colunas[1], yLinha, fonte, cor);
+        DrawText(TextFormat("%.1f", r.media), colunas[2], yLinha, fonte, cor);
+        DrawText(TextFormat("%.1f", r.p99), colunas[3], yLinha, fonte, cor);
+    }
+}
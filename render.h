@@ -0,0 +1,69 @@
+/*
+Desenho do jogo com camada esttica: fundo, plataformas, perigos e portas no mudam durante a fase,
+ento so desenhados uma vez numa RenderTexture quando a fase troca e depois viram um quadro s por frame.
+S o que mexe (jogadores, plataformas mveis, botes e diamante)  desenhado item por item.
+Fase maior que a tela no usa a camada: a cmera segue os jogadores e s as partes fixas dos pedaos
+que aparecem na tela so desenhadas (ver TAM_PEDACO em simulacao.h).
+Tudo sai de um RetratoMundo (retrato.h), nunca do Mundo, ento o desenho pode rodar numa thread e a simulao
+em outra. A tabela de pedaos do desenho  dele, montada direto da fase quando ela troca.
+S funciona com janela aberta (usa o raylib de verdade).
+*/
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "raylib.h"
+#include "simulacao.h"
+#include "retrato.h"
+
+#define COR_FUNDO (Color){240,240,240,255}
+#define ZOOM_MINIMO 0.6f     // Quanto a cmera pode afastar pra mostrar os dois jogadores
+#define MARGEM_CAMERA 100.0f // Espao em volta dos jogadores que a cmera tenta mostrar
+
+typedef struct {
+    RenderTexture2D camada;
+    const DadosFase *faseDaCamada; // Fase que est desenhada na camada (NULL = ainda no desenhou)
+    bool usarCamada;               // false desenha tudo item por item, pra comparar
+
+    // Contador de chamadas de desenho do quadro atual (s as da cena, sem textos)
+    int chamadas;
+    int chamadasSemCamada;         // Quantas seriam sem a camada esttica
+
+    int *ids;                      // Itens que aparecem na tela (consulta na tabela de pedaos)
+    int capIds;
+
+    // Tabela de pedaos da fase (s nas maiores que a tela), igual  da simulao mas sem depender do Mundo
+    const DadosFase *faseDosPedacos;
+    GradeColisao pedacosPlataformas;
+    GradeColisao pedacosPerigos;
+    GradeColisao pedacosBotoes;
+    GradeColisao pedacosMoveis;
+    unsigned char *carregados;     // Marca (por id na fase) dos botes/mveis que esto no retrato
+    int capCarregados;
+} Renderizador;
+
+// Precisa ser chamado depois do InitWindow
+void IniciarRenderizador(Renderizador *r);
+void LiberarRenderizador(Renderizador *r);
+
+// Zera o contador; chamar no comeo de cada quadro, antes do BeginDrawing
+void ComecarQuadro(Renderizador *r);
+
+// Cmera que fica no meio dos num jogadores em pos (afastando at ZOOM_MINIMO pra caber todos) sem mostrar
+// fora da fase. Com a fase do tamanho da tela a cmera fica parada mostrando a fase toda.
+Camera2D CameraDosJogadores(const RetratoMundo *retrato, const Vector2 pos[], int num);
+// Parte do mundo que aparece na tela com a cmera
+Rectangle AreaDaCamera(Camera2D camera);
+
+// Fundo e partes fixas da fase que aparecem em area (redesenha a camada se a fase mudou). Chamar dentro do BeginMode2D.
+void DesenharCenarioEstatico(Renderizador *r, const RetratoMundo *retrato, Rectangle area);
+
+// Botes e mveis que aparecem em area mas esto fora dos pedaos carregados (parados, como esto na fase)
+void DesenharMoveisDescarregados(Renderizador *r, const RetratoMundo *retrato, Rectangle area);
+
+// DrawRectangleRec que conta a chamada
+void DesenharRetangulo(Renderizador *r, Rectangle rec, Color cor);
+
+// Tabela com mnimo, mdia e p99 de cada etapa nos ltimos JANELA_PERFIL quadros
+void DesenharPerfil(const Perfilador *p, int x, int y);
+
+#endif
@@ -0,0 +1,314 @@
+// Gravao e reproduo de partidas (ver replay.h)
+#include "replay.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FNV_INICIO 2166136261u
+#define FNV_PRIMO 16777619u
+
+static uint32_t HashBytes(uint32_t h, const void *dados, size_t n) {
+    const unsigned char *b = (const unsigned char *)dados;
+    for (size_t i = 0; i < n; i++) {
+        h ^= b[i];
+        h *= FNV_PRIMO;
+    }
+    return h;
+}
+
+// Campo por campo (nunca a struct inteira, pra no pegar lixo do preenchimento)
+static uint32_t HashFloat(uint32_t h, float f) { return HashBytes(h, &f, sizeof(f)); }
+static uint32_t HashInt(uint32_t h, int v) { return HashBytes(h, &v, sizeof(v)); }
+
+static uint32_t HashRetangulo(uint32_t h, Rectangle r) {
+    h = HashFloat(h, r.x);
+    h = HashFloat(h, r.y);
+    h = HashFloat(h, r.width);
+    return HashFloat(h, r.height);
+}
+
+static uint32_t HashJogador(uint32_t h, const Jogador *j) {
+    h = HashFloat(h, j->posicao.x);
+    h = HashFloat(h, j->posicao.y);
+    h = HashFloat(h, j->velocidade.x);
+    h = HashFloat(h, j->velocidade.y);
+    return HashInt(h, j->podePular);
+}
+
+uint8_t TeclasDeEntradas(Entradas e) {
+    uint8_t t = 0;
+    if (e.fogo.esquerda) t |= TECLA_FOGO_ESQUERDA;
+    if (e.fogo.direita)  t |= TECLA_FOGO_DIREITA;
+    if (e.fogo.pular)    t |= TECLA_FOGO_PULAR;
+    if (e.agua.esquerda) t |= TECLA_AGUA_ESQUERDA;
+    if (e.agua.direita)  t |= TECLA_AGUA_DIREITA;
+    if (e.agua.pular)    t |= TECLA_AGUA_PULAR;
+    return t;
+}
+
+Entradas EntradasDeTeclas(uint8_t t) {
+    Entradas e;
+    e.fogo = (EntradaJogador){ (t & TECLA_FOGO_ESQUERDA) != 0, (t & TECLA_FOGO_DIREITA) != 0, (t & TECLA_FOGO_PULAR) != 0 };
+    e.agua = (EntradaJogador){ (t & TECLA_AGUA_ESQUERDA) != 0, (t & TECLA_AGUA_DIREITA) != 0, (t & TECLA_AGUA_PULAR) != 0 };
+    return e;
+}
+
+uint32_t HashMundo(const Mundo *mundo) {
+    uint32_t h = FNV_INICIO;
+    for (int k = 0; k < mundo->numJogadores; k++)
+        h = HashJogador(h, &mundo->jogadores[k]);
+    for (int i = 0; i < mundo->numBotoesAtuais; i++)
+        h = HashInt(h, mundo->botoesAtuais[i].pressionado);
+    for (int i = 0; i < mundo->numPlataformasMoveisAtuais; i++) {
+        h = HashRetangulo(h, mundo->plataformasMoveisAtuais[i].retangulo);
+        h = HashInt(h, mundo->plataformasMoveisAtuais[i].ativa);
+    }
+    // Tempo andado nos caminhos (LACO parado no meio do caminho no d pra saber s pela posio).
+    // S em fase com caminho, pra no mudar o hash das outras.
+    if (mundo->faseAtual->numCaminhos > 0)
+        for (int i = 0; i < mundo->numPlataformasMoveisAtuais; i++) h = HashFloat(h, mundo->corpos[i].tempo);
+    // Estado dos ns lgicos (ALTERNA e TEMPO guardam coisa que os botes e mveis no mostram)
+    const GrafoGatilhos *g = &mundo->gatilhos;
+    for (int k = g->numBotoes; k < g->numBotoes + g->numLogicos; k++) {
+        h = HashInt(h, g->ligado[k]);
+        h = HashInt(h, g->estado[k]);
+    }
+    h = HashInt(h, mundo->diamanteColetado);
+    h = HashInt(h, mundo->diamantesColetados);
+    return HashInt(h, (int)mundo->estado);
+}
+
+uint32_t HashFase(const DadosFase *fase) {
+    uint32_t h = FNV_INICIO;
+    h = HashInt(h, fase->numPlataformas);
+    for (int i = 0; i < fase->numPlataformas; i++) h = HashRetangulo(h, fase->plataformas[i].retangulo);
+    h = HashInt(h, fase->numPerigos);
+    for (int i = 0; i < fase->numPerigos; i++) {
+        h = HashRetangulo(h, fase->perigos[i].retangulo);
+        h = HashInt(h, (int)fase->perigos[i].tipo);
+    }
+    h = HashInt(h, fase->numPortas);
+    for (int i = 0; i < fase->numPortas; i++) h = HashRetangulo(h, fase->portas[i].retangulo);
+    h = HashInt(h, fase->numBotoes);
+    for (int i = 0; i < fase->numBotoes; i++) {
+        h = HashRetangulo(h, fase->botoes[i].retangulo);
+        h = HashInt(h, fase->botoes[i].idAlvo);
+    }
+    h = HashInt(h, fase->numPlataformasMoveis);
+    for (int i = 0; i < fase->numPlataformasMoveis; i++) {
+        const PlataformaMovel *p = &fase->plataformasMoveis[i];
+        h = HashRetangulo(h, p->retangulo);
+        h = HashFloat(h, p->posInicial.x);
+        h = HashFloat(h, p->posInicial.y);
+        h = HashFloat(h, p->posFinal.x);
+        h = HashFloat(h, p->posFinal.y);
+        h = HashFloat(h, p->velocidade);
+    }
+    h = HashFloat(h, fase->posInicialFogo.x);
+    h = HashFloat(h, fase->posInicialFogo.y);
+    h = HashFloat(h, fase->posInicialAgua.x);
+    h = HashFloat(h, fase->posInicialAgua.y);
+    h = HashInt(h, fase->temDiamante);
+    h = HashRetangulo(h, fase->diamante);
+    // A lgica s entra quando a fase tem (os hashes das fases sem lgica continuam os mesmos)
+    if (fase->numNosLogicos > 0 || fase->numLigacoes > 0) {
+        h = HashInt(h, fase->numNosLogicos);
+        for (int i = 0; i < fase->numNosLogicos; i++) {
+            h = HashInt(h, (int)fase->nosLogicos[i].tipo);
+            h = HashInt(h, fase->nosLogicos[i].passos);
+        }
+        h = HashInt(h, fase->numLigacoes);
+        for (int i = 0; i < fase->numLigacoes; i++) {
+            const Ligacao *l = &fase->ligacoes[i];
+            h = HashInt(h, (int)l->tipoOrigem);
+            h = HashInt(h, l->origem);
+            h = HashInt(h, (int)l->tipoDestino);
+            h = HashInt(h, l->destino);
+        }
+    }
+    if (fase->numCaminhos > 0) {
+        h = HashInt(h, fase->numCaminhos);
+        for (int i = 0; i < fase->numCaminhos; i++) {
+            const CaminhoMovel *c = &fase->caminhos[i];
+            h = HashInt(h, c->movel);
+            h = HashInt(h, (int)c->tipo);
+            h = HashInt(h, c->primeiroPonto);
+            h = HashInt(h, c->numPontos);
+            h = HashInt(h, c->sempreAtiva);
+        }
+        h = HashInt(h, fase->numPontosCaminho);
+        for (int i = 0; i < fase->numPontosCaminho; i++) {
+            h = HashFloat(h, fase->pontosCaminho[i].x);
+            h = HashFloat(h, fase->pontosCaminho[i].y);
+        }
+    }
+    return h;
+}
+
+void IniciarGravacao(Replay *replay, const Mundo *mundo, bool comHashes) {
+    replay->fase = mundo->faseAtualIndex;
+    replay->hashFase = HashFase(mundo->faseAtual);
+    replay->numPassos = 0;
+    replay->numTrechos = 0;
+    // Reaproveita a memria de uma gravao anterior
+    if (comHashes && replay->hashes == NULL) {
+        replay->capHashes = 1024;
+        replay->hashes = (uint32_t *)malloc(sizeof(uint32_t) * (size_t)replay->capHashes);
+    } else if (!comHashes) {
+        free(replay->hashes);
+        replay->hashes = NULL;
+        replay->capHashes = 0;
+    }
+}
+
+void GravarPasso(Replay *replay, Entradas entradas, const Mundo *mundo) {
+    uint8_t teclas = TeclasDeEntradas(entradas);
+    TrechoReplay *ultimo = (replay->numTrechos > 0) ? &replay->trechos[replay->numTrechos - 1] : NULL;
+    if (ultimo != NULL && ultimo->teclas == teclas && ultimo->passos < UINT32_MAX) {
+        ultimo->passos++;
+    } else {
+        if (replay->numTrechos == replay->capTrechos) {
+            replay->capTrechos = (replay->capTrechos > 0) ? replay->capTrechos * 2 : 256;
+            replay->trechos = (TrechoReplay *)realloc(replay->trechos, sizeof(TrechoReplay) * (size_t)replay->capTrechos);
+        }
+        replay->trechos[replay->numTrechos++] = (TrechoReplay){ 1, teclas, {0, 0, 0} };
+    }
+
+    if (replay->hashes != NULL) {
+        if (replay->numPassos == replay->capHashes) {
+            replay->capHashes *= 2;
+            replay->hashes = (uint32_t *)realloc(replay->hashes, sizeof(uint32_t) * (size_t)replay->capHashes);
+        }
+        replay->hashes[replay->numPassos] = HashMundo(mundo);
+    }
+    replay->numPassos++;
+}
+
+bool SalvarReplay(const Replay *replay, const char *caminho) {
+    FILE *arquivo = fopen(caminho, "wb");
+    if (arquivo == NULL) {
+        fprintf(stderr, "[REPLAY] Nao foi possivel criar %s\n", caminho);
+        return false;
+    }
+
+    CabecalhoReplay cab;
+    memset(&cab, 0, sizeof(cab));
+    memcpy(cab.magica, MAGICA_REPLAY, 8);
+    cab.versao = VERSAO_REPLAY;
+    cab.taxaPassos = TAXA_PASSOS;
+    cab.fase = (uint32_t)replay->fase;
+    cab.hashFase = replay->hashFase;
+    cab.numPassos = (uint64_t)replay->numPassos;
+    cab.numTrechos = (uint32_t)replay->numTrechos;
+    cab.temHashes = (replay->hashes != NULL) ? 1 : 0;
+
+    fwrite(&cab, sizeof(cab), 1, arquivo);
+    fwrite(replay->trechos, sizeof(TrechoReplay), (size_t)replay->numTrechos, arquivo);
+    if (replay->hashes != NULL) fwrite(replay->hashes, sizeof(uint32_t), (size_t)replay->numPassos, arquivo);
+
+    bool ok = !ferror(arquivo);
+    if (fclose(arquivo) != 0) ok = false;
+    if (!ok) fprintf(stderr, "[REPLAY] Erro gravando %s\n", caminho);
+    return ok;
+}
+
+bool CarregarReplay(Replay *replay, const char *caminho) {
+    memset(replay, 0, sizeof(*replay));
+    FILE *arquivo = fopen(caminho, "rb");
+    if (arquivo == NULL) {
+        fprintf(stderr, "[REPLAY] Nao foi possivel abrir %s\n", caminho);
+        return false;
+    }
+
+    CabecalhoReplay cab;
+    const char *erro = NULL;
+    if (fread(&cab, sizeof(cab), 1, arquivo) != 1 || memcmp(cab.magica, MAGICA_REPLAY, 8) != 0)
+        erro = "nao e um replay";
+    else if (cab.versao != VERSAO_REPLAY)
+        erro = "versao do replay nao suportada";
+    else if (cab.taxaPassos != TAXA_PASSOS)
+        erro = "replay gravado com outra TAXA_PASSOS";
+
+    if (erro == NULL) {
+        replay->fase = (int)cab.fase;
+        replay->hashFase = cab.hashFase;
+        replay->numPassos = (long long)cab.numPassos;
+        replay->numTrechos = (int)cab.numTrechos;
+        replay->capTrechos = replay->numTrechos;
+        replay->trechos = (TrechoReplay *)malloc(sizeof(TrechoReplay) * (size_t)(replay->numTrechos > 0 ? replay->numTrechos : 1));
+        if (fread(replay->trechos, sizeof(TrechoReplay), (size_t)replay->numTrechos, arquivo) != (size_t)replay->numTrechos)
+            erro = "replay cortado";
+
+        // A soma dos trechos tem que dar o nmero de passos
+        long long soma = 0;
+        for (int i = 0; i < replay->numTrechos && erro == NULL; i++) soma += replay->trechos[i].passos;
+        if (erro == NULL && soma != replay->numPassos) erro = "trechos nao batem com o numero de passos";
+
+        if (erro == NULL && cab.temHashes) {
+            replay->capHashes = replay->numPassos;
+            replay->hashes = (uint32_t *)malloc(sizeof(uint32_t) * (size_t)(replay->numPassos > 0 ? replay->numPassos : 1));
+            if (fread(replay->hashes, sizeof(uint32_t), (size_t)replay->numPassos, arquivo) != (size_t)replay->numPassos)
+                erro = "replay cortado";
+        }
+    }
+    fclose(arquivo);
+
+    if (erro != NULL) {
+        fprintf(stderr, "[REPLAY] %s: %s\n", caminho, erro);
+        LiberarReplay(replay);
+        return false;
+    }
+    return true;
+}
+
+void LiberarReplay(Replay *replay) {
+    free(replay->trechos);
+    free(replay->hashes);
+    memset(replay, 0, sizeof(*replay));
+}
+
+bool ReproduzirReplay(const Replay *replay, Mundo *mundo, bool pararNaDivergencia, ResultadoReplay *resultado) {
+    resultado->passos = 0;
+    resultado->divergiu = -1;
+    resultado->mortes = 0;
+    resultado->quedas = 0;
+    resultado->venceu = false;
+    resultado->hashFinal = 0;
+
+    if (replay->fase < 0 || replay->fase >= mundo->numFases ||
+        HashFase(&mundo->fases[replay->fase]) != replay->hashFase) {
+        fprintf(stderr, "[REPLAY] A fase %d nao e a mesma do replay\n", replay->fase + 1);
+        return false;
+    }
+    CarregarFaseMundo(mundo, replay->fase);
+
+    long long passo = 0;
+    for (int t = 0; t < replay->numTrechos && !resultado->venceu; t++) {
+        Entradas entradas = EntradasDeTeclas(replay->trechos[t].teclas);
+        for (uint32_t k = 0; k < replay->trechos[t].passos; k++, passo++) {
+            // Morreu e ainda tem passo gravado: o jogador apertou ENTER
+            if (mundo->estado == FIM_DE_JOGO) ReiniciarFase(mundo);
+
+            int r = PassoMundo(mundo, entradas);
+            if (r & PASSO_MORTE) resultado->mortes++;
+            if (r & PASSO_REINICIOU) resultado->quedas++;
+
+            if (replay->hashes != NULL && resultado->divergiu < 0 && HashMundo(mundo) != replay->hashes[passo]) {
+                resultado->divergiu = passo;
+                if (pararNaDivergencia) {
+                    resultado->passos = passo + 1;
+                    resultado->hashFinal = HashMundo(mundo);
+                    return true;
+                }
+            }
+            if (r & PASSO_VITORIA) {
+                resultado->venceu = true;
+                passo++;
+                break;
+            }
+        }
+    }
+    resultado->passos = passo;
+    resultado->hashFinal = HashMundo(mundo);
+    return true;
+}
@@ -0,0 +1,95 @@
+/*
+Gravao e reproduo de partidas (replay).
+Cada passo da fsica vira uma mscara de 6 bits com as teclas dos dois jogadores, e passos seguidos
+com as mesmas teclas viram um trecho s (RLE). O replay guarda tambm a fase (ndice + hash das partes
+fixas, pra no reproduzir na fase errada) e, se pedido, um hash do mundo depois de cada passo, que acusa
+o primeiro passo em que a simulao deixou de ser determinstica.
+
+Regra da reproduo: morreu (FIM_DE_JOGO) e ainda tem passos gravados = o jogador apertou ENTER,
+ento a fase  reiniciada. O replay termina na vitria ou no ltimo passo.
+
+Formato do arquivo (little-endian, verso 1):
+    CabecalhoReplay
+    TrechoReplay[numTrechos]
+    uint32_t hashes[numPassos]   (s se temHashes)
+*/
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdint.h>
+#include "simulacao.h"
+
+#define MAGICA_REPLAY "FAREPLAY"
+#define VERSAO_REPLAY 1
+
+// Bits da mscara de teclas de um passo
+#define TECLA_FOGO_ESQUERDA 0x01
+#define TECLA_FOGO_DIREITA  0x02
+#define TECLA_FOGO_PULAR    0x04
+#define TECLA_AGUA_ESQUERDA 0x08
+#define TECLA_AGUA_DIREITA  0x10
+#define TECLA_AGUA_PULAR    0x20
+
+typedef struct {
+    char magica[8];
+    uint32_t versao;
+    uint32_t taxaPassos;  // TAXA_PASSOS de quem gravou (as constantes da fsica so por passo)
+    uint32_t fase;        // ndice da fase
+    uint32_t hashFase;    // Hash das partes fixas da fase (ver HashFase)
+    uint64_t numPassos;
+    uint32_t numTrechos;
+    uint32_t temHashes;
+} CabecalhoReplay;
+
+// Passos seguidos com as mesmas teclas
+typedef struct {
+    uint32_t passos;
+    uint8_t teclas;
+    uint8_t reservado[3];
+} TrechoReplay;
+
+typedef struct {
+    int fase;
+    uint32_t hashFase;
+    long long numPassos;
+    TrechoReplay *trechos;
+    int numTrechos;
+    int capTrechos;
+    uint32_t *hashes;    // Hash do mundo depois de cada passo (NULL = sem hashes)
+    long long capHashes;
+} Replay;
+
+uint8_t TeclasDeEntradas(Entradas entradas);
+Entradas EntradasDeTeclas(uint8_t teclas);
+
+// Hash (FNV-1a) do que muda durante a fase: jogadores, botes, ns lgicos, plataformas mveis, diamante e estado
+uint32_t HashMundo(const Mundo *mundo);
+// Hash das partes fixas de uma fase
+uint32_t HashFase(const DadosFase *fase);
+
+// Comea um replay vazio da fase atual do mundo (chamar logo depois de carregar a fase).
+// Na primeira vez o Replay tem que estar zerado; depois a memria  reaproveitada.
+void IniciarGravacao(Replay *replay, const Mundo *mundo, bool comHashes);
+// Guarda as teclas de um passo; mundo  o estado depois do PassoMundo (usado pro hash)
+void GravarPasso(Replay *replay, Entradas entradas, const Mundo *mundo);
+
+bool SalvarReplay(const Replay *replay, const char *caminho);
+// Em erro escreve o motivo no stderr e devolve false
+bool CarregarReplay(Replay *replay, const char *caminho);
+void LiberarReplay(Replay *replay);
+
+// Resultado de ReproduzirReplay
+typedef struct {
+    long long passos;      // Passos simulados
+    long long divergiu;    // Primeiro passo com hash diferente do gravado (-1 = nenhum)
+    int mortes;
+    int quedas;
+    bool venceu;
+    uint32_t hashFinal;    // Hash do mundo no fim (d pra comparar replays sem hashes)
+} ResultadoReplay;
+
+// Carrega a fase do replay no mundo e roda todos os passos. Devolve false se a fase no bate com a do replay.
+// Com pararNaDivergencia para no primeiro hash diferente.
+bool ReproduzirReplay(const Replay *replay, Mundo *mundo, bool pararNaDivergencia, ResultadoReplay *resultado);
+
+#endif
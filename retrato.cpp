@@ -0,0 +1,171 @@
+// Retrato do mundo, troca tripla e thread de passo fixo (ver retrato.h)
+#include "retrato.h"
+#include "memoria.h"
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+void PreencherRetrato(RetratoMundo *r, const Mundo *mundo, const Vector2 anterioresJogadores[], const Vector2 anterioresMoveis[]) {
+    r->fase = mundo->faseAtual;
+    r->faseIndex = mundo->faseAtualIndex;
+    r->numFases = mundo->numFases;
+    r->estado = mundo->estado;
+    r->larguraFase = mundo->larguraFase;
+    r->alturaFase = mundo->alturaFase;
+
+    r->numJogadores = mundo->numJogadores;
+    r->jogadores = (JogadorRetrato *)Reservar(r->jogadores, &r->capJogadores, r->numJogadores, sizeof(JogadorRetrato));
+    for (int k = 0; k < r->numJogadores; k++) {
+        const Jogador *j = &mundo->jogadores[k];
+        r->jogadores[k].posicao = j->posicao;
+        r->jogadores[k].anterior = (anterioresJogadores != NULL) ? anterioresJogadores[k] : j->posicao;
+        r->jogadores[k].cor = j->cor;
+    }
+
+    r->numMoveis = mundo->numPlataformasMoveisAtuais;
+    r->moveis = (MovelRetrato *)Reservar(r->moveis, &r->capMoveis, r->numMoveis, sizeof(MovelRetrato));
+    for (int i = 0; i < r->numMoveis; i++) {
+        Rectangle ret = mundo->plataformasMoveisAtuais[i].retangulo;
+        r->moveis[i].retangulo = ret;
+        r->moveis[i].anterior = (anterioresMoveis != NULL) ? anterioresMoveis[i] : (Vector2){ ret.x, ret.y };
+        r->moveis[i].id = mundo->carregadosMoveis.ids[i];
+    }
+
+    r->numBotoes = mundo->numBotoesAtuais;
+    r->botoes = (BotaoRetrato *)Reservar(r->botoes, &r->capBotoes, r->numBotoes, sizeof(BotaoRetrato));
+    for (int i = 0; i < r->numBotoes; i++) {
+        const Botao *b = &mundo->botoesAtuais[i];
+        r->botoes[i].retangulo = b->retangulo;
+        r->botoes[i].cor = b->cor;
+        r->botoes[i].pressionado = b->pressionado;
+        r->botoes[i].id = mundo->carregadosBotoes.ids[i];
+    }
+
+    r->mostrarDiamante = mundo->temDiamanteAtual && !mundo->diamanteColetado;
+    r->diamante = mundo->diamante;
+    r->diamantesColetados = mundo->diamantesColetados;
+}
+
+void LiberarRetrato(RetratoMundo *r) {
+    free(r->jogadores);
+    free(r->moveis);
+    free(r->botoes);
+    *r = (RetratoMundo){0};
+}
+
+// O ndice do retrato do meio vai junto com um bit que diz se ele  mais novo que o de quem l. Publicar e
+// pegar so uma troca atmica cada: quem publica troca o seu pelo do meio, quem l (se tem novo) tambm.
+#define BIT_NOVO 4
+#define INDICE_RETRATO 3
+
+struct TrocaRetratos {
+    RetratoMundo retratos[3];
+    std::atomic<int> meio;
+    int escrita;             // S quem publica usa
+    int leitura;             // S quem l usa
+    long long publicados;    // S quem publica usa
+};
+
+TrocaRetratos *CriarTrocaRetratos(void) {
+    TrocaRetratos *t = new TrocaRetratos();
+    for (int i = 0; i < 3; i++) t->retratos[i] = (RetratoMundo){0};
+    t->escrita = 0;
+    t->meio.store(1);
+    t->leitura = 2;
+    t->publicados = 0;
+    return t;
+}
+
+RetratoMundo *RetratoParaEscrever(TrocaRetratos *t) {
+    return &t->retratos[t->escrita];
+}
+
+void PublicarRetrato(TrocaRetratos *t) {
+    RetratoMundo *r = &t->retratos[t->escrita];
+    r->versao = ++t->publicados;
+    r->instante = TempoMonotonico();
+    // release: o contedo do retrato fica visvel antes do ndice; acquire: o retrato que volta j foi largado
+    t->escrita = t->meio.exchange(t->escrita | BIT_NOVO, std::memory_order_acq_rel) & INDICE_RETRATO;
+}
+
+const RetratoMundo *RetratoMaisNovo(TrocaRetratos *t) {
+    if (t->meio.load(std::memory_order_relaxed) & BIT_NOVO)
+        t->leitura = t->meio.exchange(t->leitura, std::memory_order_acq_rel) & INDICE_RETRATO;
+    return &t->retratos[t->leitura];
+}
+
+void DestruirTrocaRetratos(TrocaRetratos *t) {
+    if (t == NULL) return;
+    for (int i = 0; i < 3; i++) LiberarRetrato(&t->retratos[i]);
+    delete t;
+}
+
+struct CaixaTeclas {
+    std::atomic<unsigned int> apertadas;
+    std::atomic<unsigned int> novas;
+};
+
+CaixaTeclas *CriarCaixaTeclas(void) {
+    CaixaTeclas *c = new CaixaTeclas();
+    c->apertadas.store(0);
+    c->novas.store(0);
+    return c;
+}
+
+void EnviarTeclas(CaixaTeclas *c, unsigned int apertadas, unsigned int novas) {
+    c->apertadas.store(apertadas, std::memory_order_release);
+    if (novas != 0) c->novas.fetch_or(novas, std::memory_order_release);
+}
+
+unsigned int ReceberTeclas(CaixaTeclas *c, unsigned int *novas) {
+    *novas = c->novas.exchange(0, std::memory_order_acquire);
+    return c->apertadas.load(std::memory_order_acquire);
+}
+
+void DestruirCaixaTeclas(CaixaTeclas *c) {
+    delete c;
+}
+
+struct ThreadPassos {
+    std::thread thread;
+    std::atomic<bool> parar;
+};
+
+static void LacoPassos(ThreadPassos *t, FuncaoPassoFixo passo, void *contexto, double dt, int maxAtrasados) {
+    using Relogio = std::chrono::steady_clock;
+    using Segundos = std::chrono::duration<double>;
+    Relogio::time_point inicio = Relogio::now();
+    long long numPassos = 0;
+    while (!t->parar.load(std::memory_order_acquire)) {
+        passo(contexto);
+        numPassos++;
+        // Marca do prximo passo contada do incio (somar dt a cada passo acumularia o arredondamento)
+        Relogio::time_point proximo = inicio + std::chrono::duration_cast<Relogio::duration>(Segundos(numPassos * dt));
+        Relogio::time_point agora = Relogio::now();
+        if (agora - proximo > Segundos(maxAtrasados * dt)) {
+            inicio = agora;
+            numPassos = 0;
+            continue;
+        }
+        std::this_thread::sleep_until(proximo);
+    }
+}
+
+ThreadPassos *IniciarThreadPassos(FuncaoPassoFixo passo, void *contexto, double dt, int maxAtrasados) {
+    ThreadPassos *t = new ThreadPassos();
+    t->parar.store(false);
+    t->thread = std::thread(LacoPassos, t, passo, contexto, dt, maxAtrasados);
+    return t;
+}
+
+void PararThreadPassos(ThreadPassos *t) {
+    if (t == NULL) return;
+    t->parar.store(true, std::memory_order_release);
+    t->thread.join();
+    delete t;
+}
+
+double TempoMonotonico(void) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,106 @@
+/*
+Retrato do mundo pro desenho: s o que o desenho de um passo precisa (jogadores, plataformas mveis e botes
+carregados, diamante e os nmeros da tela), copiado pra fora do Mundo, com a posio de antes do passo pra
+interpolar. O desenho s l retratos, nunca o Mundo.
+Com a simulao numa thread prpria (jogo ... separado), ela anda em passo fixo e publica um retrato por passo
+numa troca tripla sem trava: quem publica sempre tem um retrato livre pra escrever, quem desenha pega sempre o
+mais novo, e nenhum dos dois espera o outro. Um quadro lento (vsync, driver) no atrasa a fsica e um passo
+lento no trava o desenho. As teclas vo no sentido contrrio, tambm sem trava (CaixaTeclas).
+*/
+#ifndef RETRATO_H
+#define RETRATO_H
+
+#include "simulacao.h"
+
+typedef struct {
+    Vector2 posicao;
+    Vector2 anterior; // Antes do passo
+    Color cor;
+} JogadorRetrato;
+
+typedef struct {
+    Rectangle retangulo;
+    Vector2 anterior; // Canto de cima antes do passo
+    int id;           // Id na fase
+} MovelRetrato;
+
+typedef struct {
+    Rectangle retangulo;
+    Color cor;
+    bool pressionado;
+    int id;           // Id na fase
+} BotaoRetrato;
+
+typedef struct {
+    long long versao;        // Retratos publicados at este (0 = nenhum ainda)
+    double instante;         // TempoMonotonico() da publicao (o desenho interpola a partir dele)
+
+    const DadosFase *fase;   // Fases no mudam durante o jogo: o desenho usa as partes fixas direto daqui
+    int faseIndex;
+    int numFases;
+    EstadoJogo estado;
+    float larguraFase;
+    float alturaFase;
+
+    JogadorRetrato *jogadores;
+    MovelRetrato *moveis;    // S as carregadas (as outras esto paradas como na fase)
+    BotaoRetrato *botoes;    // S os carregados
+    int numJogadores;
+    int numMoveis;
+    int numBotoes;
+    int capJogadores;
+    int capMoveis;
+    int capBotoes;
+
+    bool mostrarDiamante;
+    Rectangle diamante;
+    int diamantesColetados;
+
+    // Nmeros da tela que no esto no Mundo: quem publica preenche
+    bool voltando;
+    float segundosGuardados; // Quanto d pra voltar no tempo
+    double tempoFase;        // Tempo da fase vencida
+    int estrelas;
+    bool terminou;           // Venceu a ltima fase e apertou ENTER: o jogo fecha
+} RetratoMundo;
+
+// Copia o mundo pro retrato (reaproveitando a memria dele). anterioresJogadores/anterioresMoveis so as
+// posies de antes do passo, na ordem do mundo (NULL = sem interpolao). No mexe nos nmeros da tela.
+void PreencherRetrato(RetratoMundo *r, const Mundo *mundo, const Vector2 anterioresJogadores[], const Vector2 anterioresMoveis[]);
+void LiberarRetrato(RetratoMundo *r);
+
+// Troca tripla: uma thread publica e outra l
+typedef struct TrocaRetratos TrocaRetratos;
+
+TrocaRetratos *CriarTrocaRetratos(void);
+// Retrato livre pra preencher (s quem publica); tem o contedo de algum retrato antigo
+RetratoMundo *RetratoParaEscrever(TrocaRetratos *t);
+// O retrato preenchido vira o mais novo (ganha versao e instante) e RetratoParaEscrever passa a dar outro
+void PublicarRetrato(TrocaRetratos *t);
+// Retrato mais novo (s quem desenha). Continua valendo at a prxima chamada, mesmo com novas publicaes.
+const RetratoMundo *RetratoMaisNovo(TrocaRetratos *t);
+void DestruirTrocaRetratos(TrocaRetratos *t);
+
+// Teclas da thread do desenho (que l o teclado) pra thread da simulao: apertadas  o estado atual e novas
+// so as que foram apertadas, que se acumulam at a simulao receber
+typedef struct CaixaTeclas CaixaTeclas;
+
+CaixaTeclas *CriarCaixaTeclas(void);
+void EnviarTeclas(CaixaTeclas *c, unsigned int apertadas, unsigned int novas);
+unsigned int ReceberTeclas(CaixaTeclas *c, unsigned int *novas);
+void DestruirCaixaTeclas(CaixaTeclas *c);
+
+// Thread que chama passo(contexto) a cada dt segundos, com os passos marcados no relgio (no "dt depois do
+// anterior"), ento ficam espaados por igual mesmo com passos de durao diferente. Se atrasar mais que
+// maxAtrasados passos (mquina suspensa, depurador) recomea a contar de agora em vez de correr pra alcanar.
+typedef void (*FuncaoPassoFixo)(void *contexto);
+typedef struct ThreadPassos ThreadPassos;
+
+ThreadPassos *IniciarThreadPassos(FuncaoPassoFixo passo, void *contexto, double dt, int maxAtrasados);
+// Espera o passo que est rodando terminar e encerra a thread
+void PararThreadPassos(ThreadPassos *t);
+
+// Segundos de um relgio que s anda pra frente (o mesmo do instante dos retratos)
+double TempoMonotonico(void);
+
+#endif
@@ -0,0 +1,1225 @@
+// Ncleo da simulao. Tudo que antes ficava dentro do while do main e no desenha nada.
+#include "simulacao.h"
+#include "cinematica.h"
+#include "memoria.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Mximo de colisores perto do jogador vindos da grade; se passar disso varre tudo
+#define MAX_CANDIDATOS 64
+
+// Retngulo de coliso do jogador (posicao  o meio da base do cubo)
+Rectangle RetanguloJogador(const Jogador *j) {
+    return (Rectangle){ j->posicao.x - 10, j->posicao.y - 20, 20, 20 };
+}
+
+// Ids dos itens perto de area: com poucos itens so os que colidem (teste em lote),
+// seno os que a grade acha perto. Devolve -1 se no tem ndice ou se a lista estourou,
+// e a quem chamou varre todos os itens (IdCandidato cuida dos dois casos).
+static inline const GradeColisao *GradeDoIndice(const IndiceColisao *indice) {
+    return (indice->pronta != NULL) ? indice->pronta : &indice->grade;
+}
+
+static int Candidatos(const IndiceColisao *indice, Rectangle area, int ids[]) {
+    if (indice == NULL) return -1;
+    const GradeColisao *grade = GradeDoIndice(indice);
+    int n;
+    if (grade->numItens < MIN_ITENS_GRADE) n = ColisoesLote(&indice->soa, area, ids, MAX_CANDIDATOS);
+    else n = ConsultarGrade(grade, area, ids, MAX_CANDIDATOS);
+    return (n > MAX_CANDIDATOS) ? -1 : n;
+}
+
+static inline int IdCandidato(int k, int nCandidatos, const int ids[]) {
+    return (nCandidatos < 0) ? k : ids[k];
+}
+
+static inline bool DentroDe(Rectangle rec, Rectangle regiao) {
+    return rec.x >= regiao.x && rec.y >= regiao.y &&
+           rec.x + rec.width <= regiao.x + regiao.width && rec.y + rec.height <= regiao.y + regiao.height;
+}
+
+// Candidatos com o cache de um jogador: enquanto rec fica dentro da regio guardada em perto devolve os ids
+// dela; seno consulta o ndice numa regio com folga em volta de rec e guarda os que encostam nela. Os itens
+// que encostam em rec so os mesmos, na mesma ordem, que o Candidatos daria. *ids aponta pros ids usados
+// (os do cache ou os de saida); -1  como no Candidatos.
+static int CandidatosPerto(ItensPerto *perto, const IndiceColisao *indice, const Rectangle *recs, size_t passo,
+                           Rectangle rec, int saida[], const int **ids) {
+    *ids = perto->ids;
+    if (perto->num >= 0 && DentroDe(rec, perto->regiao)) return perto->num;
+
+    *ids = saida;
+    perto->num = -1;
+    // Com poucos itens o teste em lote j  mais barato que o cache
+    if (indice == NULL || GradeDoIndice(indice)->numItens < MIN_ITENS_GRADE) return Candidatos(indice, rec, saida);
+    Rectangle regiao = { rec.x - MARGEM_PERTO, rec.y - MARGEM_PERTO, rec.width + 2 * MARGEM_PERTO, rec.height + 2 * MARGEM_PERTO };
+    int n = Candidatos(indice, regiao, saida);
+    int num = 0;
+    for (int k = 0; k < n && num <= MAX_ITENS_PERTO; k++) {
+        const Rectangle *r = (const Rectangle *)((const char *)recs + (size_t)saida[k] * passo);
+        if (CheckCollisionRecs(regiao, *r)) {
+            if (num < MAX_ITENS_PERTO) perto->ids[num] = saida[k];
+            num++;
+        }
+    }
+    // Muita coisa perto (ou a regio estourou o ndice): consulta s rec, sem guardar
+    if (n < 0 || num > MAX_ITENS_PERTO) return Candidatos(indice, rec, saida);
+    perto->regiao = regiao;
+    perto->num = num;
+    *ids = perto->ids;
+    return num;
+}
+
+// Guarda um contato do passo; devolve a posio dele em c->contatos (-1 se no guardou)
+static int GuardarContato(ContatosJogador *c, TipoContato tipo, int id, Vector2 normal) {
+    if (c == NULL || c->numContatos >= MAX_CONTATOS) return -1;
+    c->contatos[c->numContatos] = (Contato){ tipo, id, normal };
+    return c->numContatos++;
+}
+
+// Guarda o cho onde o jogador ficou: ele sempre entra (com a lista cheia toma o lugar do ltimo contato)
+static void GuardarApoio(ContatosJogador *c, TipoContato tipo, int id) {
+    if (c->numContatos >= MAX_CONTATOS) c->numContatos = MAX_CONTATOS - 1;
+    c->apoio = GuardarContato(c, tipo, id, (Vector2){ 0, -1 });
+}
+
+// Esquece o cache de itens perto de todos os jogadores e o passo repetvel (os Atuais mudaram)
+static void EsquecerItensPerto(Mundo *mundo) {
+    for (int k = 0; k < mundo->capJogadores; k++) {
+        mundo->contatosJogadores[k].plataformasPerto.num = -1;
+        mundo->contatosJogadores[k].botoesPerto.num = -1;
+        mundo->contatosJogadores[k].repetivel = false;
+    }
+}
+
+// Cria os jogadores (tipos alternados) e os vetores por jogador; as posies vm do ReiniciarFase
+static void PrepararJogadores(Mundo *mundo, int num) {
+    if (num < 1) num = 1;
+    if (num > mundo->capJogadores) {
+        free(mundo->jogadores);
+        free(mundo->recsJogadores);
+        free(mundo->esquerdaJogadores);
+        free(mundo->ordemJogadores);
+        free(mundo->contatosJogadores);
+        free(mundo->caixaPedacos);
+        mundo->jogadores = (Jogador *)malloc(sizeof(Jogador) * (size_t)num);
+        mundo->recsJogadores = (Rectangle *)malloc(sizeof(Rectangle) * (size_t)num);
+        mundo->esquerdaJogadores = (float *)malloc(sizeof(float) * (size_t)num);
+        mundo->ordemJogadores = (int *)malloc(sizeof(int) * (size_t)num);
+        mundo->contatosJogadores = (ContatosJogador *)malloc(sizeof(ContatosJogador) * (size_t)num);
+        mundo->caixaPedacos = (int (*)[4])malloc(sizeof(int[4]) * (size_t)num);
+        mundo->capJogadores = num;
+    }
+    for (int k = 0; k < num; k++) {
+        TipoJogador tipo = (k % 2 == 0) ? JOGADOR_FOGO : JOGADOR_AGUA;
+        mundo->jogadores[k] = (Jogador){ tipo, {0,0}, {0,0}, (tipo == JOGADOR_FOGO) ? MAROON : BLUE, false };
+        mundo->ordemJogadores[k] = k;
+    }
+    for (int k = 0; k < mundo->capJogadores; k++) {
+        mundo->contatosJogadores[k].numContatos = 0;
+        mundo->contatosJogadores[k].apoio = -1;
+    }
+    EsquecerItensPerto(mundo);
+    mundo->numJogadores = num;
+}
+
+// Prepara o mundo e carrega a primeira fase
+void IniciarMundo(Mundo *mundo, const DadosFase fases[], int numFases, int faseInicial) {
+    mundo->fases = fases;
+    mundo->numFases = numFases;
+    mundo->jogadores = NULL;
+    mundo->numJogadores = 0;
+    mundo->capJogadores = 0;
+    mundo->recsJogadores = NULL;
+    mundo->esquerdaJogadores = NULL;
+    mundo->ordemJogadores = NULL;
+    mundo->contatosJogadores = NULL;
+    mundo->caixaPedacos = NULL;
+    mundo->botoesAtuais = NULL;
+    mundo->plataformasMoveisAtuais = NULL;
+    mundo->capBotoes = 0;
+    mundo->capPlataformasMoveis = 0;
+    mundo->indicePlataformas = (IndiceColisao){0};
+    mundo->indicePlataformasMoveis = (IndiceColisao){0};
+    mundo->indicePerigos = (IndiceColisao){0};
+    mundo->indiceBotoes = (IndiceColisao){0};
+    mundo->mapaPerigos = (GradeOcupacao){0};
+    mundo->mapaPerigosFase = &mundo->mapaPerigos;
+    mundo->usarMapaPerigos = true;
+    mundo->reiniciarNaQueda = true;
+    mundo->recursos = 0;
+    mundo->gatilhos = (GrafoGatilhos){0};
+    mundo->contatos = NULL;
+    mundo->capContatos = 0;
+    mundo->carregarFaseInteira = false;
+    mundo->carregadosPlataformas = (ItensCarregados){0};
+    mundo->carregadosPerigos = (ItensCarregados){0};
+    mundo->carregadosBotoes = (ItensCarregados){0};
+    mundo->carregadosMoveis = (ItensCarregados){0};
+    mundo->copiaPlataformas = NULL;
+    mundo->copiaPerigos = NULL;
+    mundo->capCopiaPlataformas = 0;
+    mundo->capCopiaPerigos = 0;
+    mundo->moveisTroca = NULL;
+    mundo->idsTroca = NULL;
+    mundo->capMoveisTroca = 0;
+    mundo->capIdsTroca = 0;
+    mundo->consulta = NULL;
+    mundo->capConsulta = 0;
+    mundo->tabelasCaminhos = NULL;
+    mundo->distanciasCaminhos = NULL;
+    mundo->caminhoDoMovel = NULL;
+    mundo->capTabelasCaminhos = 0;
+    mundo->capDistanciasCaminhos = 0;
+    mundo->capCaminhoDoMovel = 0;
+    mundo->corpos = NULL;
+    mundo->corposTroca = NULL;
+    mundo->capCorpos = 0;
+    mundo->capCorposTroca = 0;
+    mundo->acordadas = NULL;
+    mundo->numAcordadas = 0;
+    mundo->capAcordadas = 0;
+    mundo->perfil = NULL;
+    PrepararJogadores(mundo, 2);
+    CarregarFaseMundo(mundo, faseInicial);
+}
+
+void DefinirJogadores(Mundo *mundo, int numJogadores) {
+    PrepararJogadores(mundo, numJogadores);
+    CarregarFase(mundo, mundo->faseAtual);
+}
+
+// Libera a memria dos ndices de coliso e das cpias de botes/mveis
+void LiberarMundo(Mundo *mundo) {
+    free(mundo->botoesAtuais);
+    free(mundo->plataformasMoveisAtuais);
+    mundo->botoesAtuais = NULL;
+    mundo->plataformasMoveisAtuais = NULL;
+    mundo->capBotoes = 0;
+    mundo->capPlataformasMoveis = 0;
+    LiberarIndice(&mundo->indicePlataformas);
+    LiberarIndice(&mundo->indicePlataformasMoveis);
+    LiberarIndice(&mundo->indicePerigos);
+    LiberarIndice(&mundo->indiceBotoes);
+    LiberarOcupacao(&mundo->mapaPerigos);
+    LiberarGatilhos(&mundo->gatilhos);
+    free(mundo->contatos);
+    mundo->contatos = NULL;
+    mundo->capContatos = 0;
+    ItensCarregados *tipos[4] = { &mundo->carregadosPlataformas, &mundo->carregadosPerigos, &mundo->carregadosBotoes, &mundo->carregadosMoveis };
+    for (int t = 0; t < 4; t++) {
+        LiberarGrade(&tipos[t]->pedacos);
+        free(tipos[t]->ids);
+        *tipos[t] = (ItensCarregados){0};
+    }
+    free(mundo->copiaPlataformas);
+    free(mundo->copiaPerigos);
+    free(mundo->moveisTroca);
+    free(mundo->idsTroca);
+    free(mundo->consulta);
+    mundo->copiaPlataformas = NULL;
+    mundo->copiaPerigos = NULL;
+    mundo->moveisTroca = NULL;
+    mundo->idsTroca = NULL;
+    mundo->consulta = NULL;
+    mundo->capCopiaPlataformas = 0;
+    mundo->capCopiaPerigos = 0;
+    mundo->capMoveisTroca = 0;
+    mundo->capIdsTroca = 0;
+    mundo->capConsulta = 0;
+    LiberarCaminhos(mundo);
+    free(mundo->jogadores);
+    free(mundo->recsJogadores);
+    free(mundo->esquerdaJogadores);
+    free(mundo->ordemJogadores);
+    free(mundo->contatosJogadores);
+    free(mundo->caixaPedacos);
+    mundo->jogadores = NULL;
+    mundo->recsJogadores = NULL;
+    mundo->esquerdaJogadores = NULL;
+    mundo->ordemJogadores = NULL;
+    mundo->contatosJogadores = NULL;
+    mundo->caixaPedacos = NULL;
+    mundo->numJogadores = 0;
+    mundo->capJogadores = 0;
+}
+
+// Monta grade e SoA de um tipo de colisor (recs/passo igual ao ConstruirGrade)
+void MontarIndice(IndiceColisao *indice, const Rectangle *recs, size_t passo, int n) {
+    ConstruirGrade(&indice->grade, recs, passo, n, TAM_CELULA_GRADE);
+    MontarColisores(&indice->soa, recs, passo, n);
+    indice->pronta = NULL;
+}
+
+// A grade pronta no  copiada (ela  s leitura e vive mais que o mundo); a SoA  montada como sempre
+void MontarIndicePronto(IndiceColisao *indice, const Rectangle *recs, size_t passo, int n, const GradeColisao *pronta) {
+    MontarColisores(&indice->soa, recs, passo, n);
+    indice->pronta = pronta;
+}
+
+void LiberarIndice(IndiceColisao *indice) {
+    LiberarGrade(&indice->grade);
+    LiberarColisores(&indice->soa);
+    indice->pronta = NULL;
+}
+
+// Carrega uma fase no mundo e zera o progresso dela (para recomear a mesma fase use ReiniciarFase)
+void CarregarFaseMundo(Mundo *mundo, int faseIndex) {
+    mundo->faseAtualIndex = faseIndex;
+    CarregarFase(mundo, &mundo->fases[faseIndex]);
+}
+
+static int CompararIds(const void *a, const void *b) {
+    return *(const int *)a - *(const int *)b;
+}
+
+// Pedaos de RAIO_PEDACOS em volta do pedao onde o jogador est (coluna e linha mnima e mxima)
+static void CaixaDoJogador(const Mundo *mundo, const Jogador *j, int caixa[4]) {
+    int colunas = mundo->colunasPedacos, linhas = mundo->linhasPedacos;
+    // Truncar em vez de floorf: negativo vira 0, que  onde ele ia parar de qualquer jeito
+    int c = (int)(j->posicao.x * (1.0f / TAM_PEDACO));
+    int l = (int)(j->posicao.y * (1.0f / TAM_PEDACO));
+    if (c < 0) c = 0;
+    if (c > colunas - 1) c = colunas - 1;
+    if (l < 0) l = 0;
+    if (l > linhas - 1) l = linhas - 1;
+    caixa[0] = (c - RAIO_PEDACOS > 0) ? c - RAIO_PEDACOS : 0;
+    caixa[1] = (l - RAIO_PEDACOS > 0) ? l - RAIO_PEDACOS : 0;
+    caixa[2] = (c + RAIO_PEDACOS < colunas - 1) ? c + RAIO_PEDACOS : colunas - 1;
+    caixa[3] = (l + RAIO_PEDACOS < linhas - 1) ? l + RAIO_PEDACOS : linhas - 1;
+}
+
+// Junta em mundo->consulta (a partir de inicio) os ids da tabela que esto na caixa; devolve quantos
+static int ConsultarCaixa(Mundo *mundo, const GradeColisao *pedacos, const int caixa[4], int inicio) {
+    Rectangle area = { caixa[0] * TAM_PEDACO, caixa[1] * TAM_PEDACO,
+                       (caixa[2] - caixa[0] + 1) * TAM_PEDACO, (caixa[3] - caixa[1] + 1) * TAM_PEDACO };
+    for (;;) {
+        int n = ConsultarGradeArea(pedacos, area, mundo->consulta + inicio, mundo->capConsulta - inicio);
+        if (n <= mundo->capConsulta - inicio) return n;
+        // No coube: cresce mantendo o que j tinha antes de inicio e consulta de novo
+        mundo->capConsulta = (inicio + n) * 2;
+        mundo->consulta = (int *)realloc(mundo->consulta, sizeof(int) * (size_t)mundo->capConsulta);
+    }
+}
+
+// Ids (em ordem e sem repetir) dos itens nos pedaos dos jogadores, mais os extras, em mundo->idsTroca.
+// Com a fase inteira carregada so todos. Devolve quantos so.
+static int IdsNosPedacos(Mundo *mundo, const ItensCarregados *itens, int numFase, bool faseInteira, const int extras[], int numExtras) {
+    mundo->idsTroca = (int *)Reservar(mundo->idsTroca, &mundo->capIdsTroca, numFase > 0 ? numFase : 1, sizeof(int));
+    if (faseInteira) {
+        for (int i = 0; i < numFase; i++) mundo->idsTroca[i] = i;
+        return numFase;
+    }
+    int n = 0;
+    for (int k = 0; k < mundo->numJogadores; k++) {
+        // Jogadores perto uns dos outros tm a mesma caixa: consulta uma vez s
+        bool repetida = false;
+        for (int o = 0; o < k && !repetida; o++) repetida = memcmp(mundo->caixaPedacos[o], mundo->caixaPedacos[k], sizeof(int[4])) == 0;
+        if (!repetida) n += ConsultarCaixa(mundo, &itens->pedacos, mundo->caixaPedacos[k], n);
+    }
+    if (n + numExtras > mundo->capConsulta) {
+        mundo->capConsulta = n + numExtras;
+        mundo->consulta = (int *)realloc(mundo->consulta, sizeof(int) * (size_t)mundo->capConsulta);
+    }
+    for (int i = 0; i < numExtras; i++) mundo->consulta[n++] = extras[i];
+    qsort(mundo->consulta, (size_t)n, sizeof(int), CompararIds);
+    int unicos = 0;
+    for (int i = 0; i < n; i++)
+        if (unicos == 0 || mundo->consulta[i] != mundo->idsTroca[unicos - 1]) mundo->idsTroca[unicos++] = mundo->consulta[i];
+    return unicos;
+}
+
+// Troca os ids carregados pelos novos (em mundo->idsTroca); devolve false se eram os mesmos
+static bool TrocarIds(Mundo *mundo, ItensCarregados *itens, int n, bool forcar) {
+    if (!forcar && n == itens->num && memcmp(itens->ids, mundo->idsTroca, sizeof(int) * (size_t)n) == 0) return false;
+    int *ids = itens->ids;
+    int cap = itens->cap;
+    itens->ids = mundo->idsTroca;
+    itens->cap = mundo->capIdsTroca;
+    itens->num = n;
+    mundo->idsTroca = ids;
+    mundo->capIdsTroca = cap;
+    return true;
+}
+
+int IndiceCarregado(const ItensCarregados *itens, int id) {
+    const int *achado = (const int *)bsearch(&id, itens->ids, (size_t)itens->num, sizeof(int), CompararIds);
+    return (achado != NULL) ? (int)(achado - itens->ids) : -1;
+}
+
+static bool CarregarItensDasCaixas(Mundo *mundo, bool forcar);
+
+bool CarregarPedacos(Mundo *mundo, bool forcar) {
+    // Fase que cabe numa caixa s (as do tamanho da tela) fica inteira carregada desde o CarregarFase
+    int colunas = mundo->colunasPedacos, linhas = mundo->linhasPedacos;
+    bool cabeNumaCaixa = colunas <= 2 * RAIO_PEDACOS + 1 && linhas <= 2 * RAIO_PEDACOS + 1;
+    if (!forcar && (cabeNumaCaixa || mundo->carregarFaseInteira)) return false;
+
+    // A caixa de cada jogador fica onde est enquanto ele no chega perto da borda dela (andar pra l e
+    // pra c na divisa de dois pedaos no fica carregando e descarregando)
+    bool trocouCaixa = forcar;
+    for (int k = 0; k < mundo->numJogadores; k++) {
+        const int *caixa = mundo->caixaPedacos[k];
+        Vector2 p = mundo->jogadores[k].posicao;
+        bool dentro = p.x >= caixa[0] * TAM_PEDACO + MARGEM_PEDACOS && p.x <= (caixa[2] + 1) * TAM_PEDACO - MARGEM_PEDACOS &&
+                      p.y >= caixa[1] * TAM_PEDACO + MARGEM_PEDACOS && p.y <= (caixa[3] + 1) * TAM_PEDACO - MARGEM_PEDACOS;
+        if (forcar || !dentro) {
+            int nova[4];
+            CaixaDoJogador(mundo, &mundo->jogadores[k], nova);
+            if (forcar || memcmp(nova, caixa, sizeof(nova)) != 0) {
+                memcpy(mundo->caixaPedacos[k], nova, sizeof(nova));
+                trocouCaixa = true;
+            }
+        }
+    }
+    if (!trocouCaixa) return false;
+    return CarregarItensDasCaixas(mundo, forcar);
+}
+
+void RecarregarPedacos(Mundo *mundo) {
+    CarregarItensDasCaixas(mundo, true);
+}
+
+// Carrega os itens das caixas de pedaos atuais; forcar recarrega tudo (nenhuma mvel segue de onde estava)
+static bool CarregarItensDasCaixas(Mundo *mundo, bool forcar) {
+    const DadosFase *fase = mundo->faseAtual;
+    int colunas = mundo->colunasPedacos, linhas = mundo->linhasPedacos;
+    bool cabeNumaCaixa = colunas <= 2 * RAIO_PEDACOS + 1 && linhas <= 2 * RAIO_PEDACOS + 1;
+    int (*caixas)[4] = mundo->caixaPedacos;
+
+    // Uma caixa que cobre todos os pedaos carrega a fase inteira
+    bool faseInteira = mundo->carregarFaseInteira || cabeNumaCaixa;
+    for (int k = 0; k < mundo->numJogadores; k++)
+        if (caixas[k][0] == 0 && caixas[k][1] == 0 && caixas[k][2] == colunas - 1 && caixas[k][3] == linhas - 1) faseInteira = true;
+    if (forcar) mundo->carregadosMoveis.num = 0; // Fase nova: nenhuma mvel continua de onde estava
+
+    bool mudou = false;
+    int n = IdsNosPedacos(mundo, &mundo->carregadosPlataformas, fase->numPlataformas, faseInteira, NULL, 0);
+    if (TrocarIds(mundo, &mundo->carregadosPlataformas, n, forcar)) {
+        if (n == fase->numPlataformas) {
+            mundo->plataformasAtuais = fase->plataformas; // Todas carregadas: s aponta
+        } else {
+            mundo->copiaPlataformas = (Plataforma *)Reservar(mundo->copiaPlataformas, &mundo->capCopiaPlataformas, n, sizeof(Plataforma));
+            for (int i = 0; i < n; i++) mundo->copiaPlataformas[i] = fase->plataformas[mundo->carregadosPlataformas.ids[i]];
+            mundo->plataformasAtuais = mundo->copiaPlataformas;
+        }
+        mundo->numPlataformasAtuais = n;
+        if (n == fase->numPlataformas && fase->pronta != NULL)
+            MontarIndicePronto(&mundo->indicePlataformas, &mundo->plataformasAtuais[0].retangulo, sizeof(Plataforma), n, &fase->pronta->gradePlataformas);
+        else
+            MontarIndice(&mundo->indicePlataformas, &mundo->plataformasAtuais[0].retangulo, sizeof(Plataforma), n);
+        mudou = true;
+    }
+
+    n = IdsNosPedacos(mundo, &mundo->carregadosPerigos, fase->numPerigos, faseInteira, NULL, 0);
+    if (TrocarIds(mundo, &mundo->carregadosPerigos, n, forcar)) {
+        if (n == fase->numPerigos) {
+            mundo->perigosAtuais = fase->perigos;
+        } else {
+            mundo->copiaPerigos = (Perigo *)Reservar(mundo->copiaPerigos, &mundo->capCopiaPerigos, n, sizeof(Perigo));
+            for (int i = 0; i < n; i++) mundo->copiaPerigos[i] = fase->perigos[mundo->carregadosPerigos.ids[i]];
+            mundo->perigosAtuais = mundo->copiaPerigos;
+        }
+        mundo->numPerigosAtuais = n;
+        if (n == fase->numPerigos && fase->pronta != NULL)
+            MontarIndicePronto(&mundo->indicePerigos, &mundo->perigosAtuais[0].retangulo, sizeof(Perigo), n, &fase->pronta->gradePerigos);
+        else
+            MontarIndice(&mundo->indicePerigos, &mundo->perigosAtuais[0].retangulo, sizeof(Perigo), n);
+        mudou = true;
+    }
+
+    // Botes antes das mveis: as mveis que um boto carregado alcana no grafo tambm so carregadas, mesmo longe
+    const GrafoGatilhos *g = &mundo->gatilhos;
+    n = IdsNosPedacos(mundo, &mundo->carregadosBotoes, fase->numBotoes, faseInteira, NULL, 0);
+    bool mudouBotoes = TrocarIds(mundo, &mundo->carregadosBotoes, n, forcar);
+    int numBotoes = n;
+    int numAlvos = 0;
+    for (int i = 0; i < numBotoes; i++) {
+        int b = mundo->carregadosBotoes.ids[i];
+        numAlvos += g->inicioAlcance[b + 1] - g->inicioAlcance[b];
+    }
+    // S de rascunho at montar as mveis (uma PlataformaMovel  maior que um int)
+    mundo->moveisTroca = (PlataformaMovel *)Reservar(mundo->moveisTroca, &mundo->capMoveisTroca, numAlvos > 0 ? numAlvos : 1, sizeof(PlataformaMovel));
+    int *alvos = (int *)mundo->moveisTroca;
+    numAlvos = 0;
+    for (int i = 0; i < numBotoes; i++) {
+        int b = mundo->carregadosBotoes.ids[i];
+        for (int k = g->inicioAlcance[b]; k < g->inicioAlcance[b + 1]; k++) alvos[numAlvos++] = g->alcance[k];
+    }
+    n = IdsNosPedacos(mundo, &mundo->carregadosMoveis, fase->numPlataformasMoveis, faseInteira, alvos, numAlvos);
+
+    // Mveis que continuam carregadas seguem de onde estavam (com o corpo junto); as que chegam vm como esto na fase,
+    // ativas se o grafo diz, no comeo do caminho
+    const int *idsAntigos = mundo->carregadosMoveis.ids;
+    int numAntigos = mundo->carregadosMoveis.num;
+    bool mudouMoveis = forcar || n != numAntigos || memcmp(idsAntigos, mundo->idsTroca, sizeof(int) * (size_t)n) != 0;
+    if (mudouMoveis) {
+        mundo->moveisTroca = (PlataformaMovel *)Reservar(mundo->moveisTroca, &mundo->capMoveisTroca, n, sizeof(PlataformaMovel));
+        mundo->corposTroca = (CorpoCinematico *)Reservar(mundo->corposTroca, &mundo->capCorposTroca, n, sizeof(CorpoCinematico));
+        for (int i = 0, k = 0; i < n; i++) {
+            int id = mundo->idsTroca[i];
+            while (k < numAntigos && idsAntigos[k] < id) k++;
+            if (k < numAntigos && idsAntigos[k] == id) {
+                mundo->moveisTroca[i] = mundo->plataformasMoveisAtuais[k];
+                mundo->corposTroca[i] = mundo->corpos[k];
+            } else {
+                mundo->moveisTroca[i] = fase->plataformasMoveis[id];
+                mundo->moveisTroca[i].ativa = MovelLigada(g, id) || MovelSempreAtiva(mundo, id);
+                IniciarCorpo(mundo, id, &mundo->moveisTroca[i], &mundo->corposTroca[i]);
+            }
+        }
+        PlataformaMovel *moveis = mundo->plataformasMoveisAtuais;
+        int cap = mundo->capPlataformasMoveis;
+        mundo->plataformasMoveisAtuais = mundo->moveisTroca;
+        mundo->capPlataformasMoveis = mundo->capMoveisTroca;
+        mundo->moveisTroca = moveis;
+        mundo->capMoveisTroca = cap;
+        CorpoCinematico *corpos = mundo->corpos;
+        cap = mundo->capCorpos;
+        mundo->corpos = mundo->corposTroca;
+        mundo->capCorpos = mundo->capCorposTroca;
+        mundo->corposTroca = corpos;
+        mundo->capCorposTroca = cap;
+        TrocarIds(mundo, &mundo->carregadosMoveis, n, true);
+        mundo->numPlataformasMoveisAtuais = n;
+        MontarIndice(&mundo->indicePlataformasMoveis, &mundo->plataformasMoveisAtuais[0].retangulo, sizeof(PlataformaMovel), n);
+        AcordarMoveis(mundo);
+        mudou = true;
+    }
+
+    // Botes vm sempre da fase, apertados se o grafo diz e com o idAlvo trocado pro ndice carregado
+    if (mudouBotoes || mudouMoveis) {
+        mundo->botoesAtuais = (Botao *)Reservar(mundo->botoesAtuais, &mundo->capBotoes, numBotoes, sizeof(Botao));
+        // Cada jogador encosta no mximo em todos os botes carregados
+        mundo->contatos = (int *)Reservar(mundo->contatos, &mundo->capContatos, mundo->numJogadores * numBotoes, sizeof(int));
+        for (int i = 0; i < numBotoes; i++) {
+            mundo->botoesAtuais[i] = fase->botoes[mundo->carregadosBotoes.ids[i]];
+            mundo->botoesAtuais[i].pressionado = BotaoLigado(g, mundo->carregadosBotoes.ids[i]);
+            int alvo = mundo->botoesAtuais[i].idAlvo;
+            mundo->botoesAtuais[i].idAlvo = (alvo >= 0 && alvo < fase->numPlataformasMoveis) ? IndiceCarregado(&mundo->carregadosMoveis, alvo) : -1;
+        }
+        mundo->numBotoesAtuais = numBotoes;
+        if (numBotoes == fase->numBotoes && fase->pronta != NULL)
+            MontarIndicePronto(&mundo->indiceBotoes, &mundo->botoesAtuais[0].retangulo, sizeof(Botao), numBotoes, &fase->pronta->gradeBotoes);
+        else
+            MontarIndice(&mundo->indiceBotoes, &mundo->botoesAtuais[0].retangulo, sizeof(Botao), numBotoes);
+        mudou = true;
+    }
+    if (mudou) EsquecerItensPerto(mundo);
+    return mudou;
+}
+
+// Recomea a fase atual (morte, queda, ENTER). S volta o que muda durante a fase:
+// jogadores, botes, plataformas mveis e diamante. Plataformas, perigos, portas e os ndices deles ficam como esto
+// (a no ser que a volta pro comeo mude os pedaos carregados).
+void ReiniciarFase(Mundo *mundo) {
+    const DadosFase *fase = mundo->faseAtual;
+    for (int k = 0; k < mundo->numJogadores; k++) {
+        Jogador *j = &mundo->jogadores[k];
+        j->posicao = (j->tipo == JOGADOR_FOGO) ? fase->posInicialFogo : fase->posInicialAgua;
+        j->velocidade = (Vector2){0};
+    }
+    ReiniciarGatilhos(&mundo->gatilhos);
+    CarregarPedacos(mundo, false);
+
+    // Com o grafo desligado nenhum boto est apertado e s as mveis que andam sozinhas esto ativas
+    for (int i = 0; i < mundo->numBotoesAtuais; i++)
+        mundo->botoesAtuais[i].pressionado = false;
+    for (int i = 0; i < mundo->numPlataformasMoveisAtuais; i++) {
+        int id = mundo->carregadosMoveis.ids[i];
+        PlataformaMovel *p = &mundo->plataformasMoveisAtuais[i];
+        p->retangulo = fase->plataformasMoveis[id].retangulo;
+        p->ativa = MovelSempreAtiva(mundo, id);
+        IniciarCorpo(mundo, id, p, &mundo->corpos[i]);
+    }
+    AtualizarIndiceMoveis(mundo);
+
+    mundo->diamanteColetado = false;
+    mundo->diamantesColetados = 0;
+    mundo->passosFase = 0;
+    mundo->estado = JOGANDO;
+}
+
+// Coloca em saida os ids na fase (em ordem) dos botes carregados que encostam em rec; devolve quantos
+static int BotoesEncostados(const Mundo *mundo, Rectangle rec, int saida[], ContatosJogador *contatos) {
+    int consulta[MAX_CANDIDATOS];
+    const int *ids;
+    int n = CandidatosPerto(&contatos->botoesPerto, &mundo->indiceBotoes, &mundo->botoesAtuais[0].retangulo, sizeof(Botao), rec, consulta, &ids);
+    int total = (n < 0) ? mundo->numBotoesAtuais : n;
+    int num = 0;
+    for (int k = 0; k < total; k++) {
+        int i = IdCandidato(k, n, ids);
+        Rectangle b = mundo->botoesAtuais[i].retangulo;
+        if (CheckCollisionRecs(rec, b)) saida[num++] = mundo->carregadosBotoes.ids[i];
+    }
+    return num;
+}
+
+// Escreve nos botes e mveis carregados o que mudou no grafo de gatilhos
+static void AplicarGatilhos(Mundo *mundo) {
+    const GrafoGatilhos *g = &mundo->gatilhos;
+    int primeiraMovel = g->numBotoes + g->numLogicos;
+    for (int m = 0; m < g->numMudados; m++) {
+        int no = g->mudados[m];
+        if (no < g->numBotoes) {
+            int i = IndiceCarregado(&mundo->carregadosBotoes, no);
+            if (i >= 0) mundo->botoesAtuais[i].pressionado = g->ligado[no];
+        } else {
+            int id = no - primeiraMovel;
+            int i = IndiceCarregado(&mundo->carregadosMoveis, id);
+            if (i >= 0) {
+                mundo->plataformasMoveisAtuais[i].ativa = g->ligado[no] || MovelSempreAtiva(mundo, id);
+                AcordarMovel(mundo, i);
+            }
+        }
+    }
+}
+
+// Os perigos no mudam durante a fase, ento o mapa  montado uma vez ao carregar
+void MontarMapaPerigos(GradeOcupacao *mapa, const DadosFase *fase) {
+    Rectangle area = { 0, 0, 0, 0 };
+    for (int i = 0; i < fase->numPerigos; i++) {
+        Rectangle r = fase->perigos[i].retangulo;
+        if (i == 0) {
+            area = r;
+            continue;
+        }
+        float direita = fmaxf(area.x + area.width, r.x + r.width), baixo = fmaxf(area.y + area.height, r.y + r.height);
+        area.x = fminf(area.x, r.x);
+        area.y = fminf(area.y, r.y);
+        area.width = direita - area.x;
+        area.height = baixo - area.y;
+    }
+    PrepararOcupacao(mapa, area, TAM_CELULA_OCUPACAO);
+    for (int i = 0; i < fase->numPerigos; i++) MarcarOcupacao(mapa, fase->perigos[i].retangulo, fase->perigos[i].tipo);
+}
+
+// true se rec encosta em algum perigo que no seja do tipo inofensivo (o elemento do prprio jogador).
+// O mapa responde sozinho quase sempre; nas clulas de borda a conferncia  pelos perigos carregados (um perigo
+// que encosta no jogador sempre est num pedao carregado, ento o mapa da fase inteira d a mesma resposta).
+// Com poucos perigos o teste em lote j  mais barato que o mapa.
+bool TocouPerigo(const Mundo *mundo, Rectangle rec, TipoPerigo inofensivo) {
+    if (mundo->usarMapaPerigos && mundo->faseAtual->numPerigos >= MIN_ITENS_GRADE) {
+        unsigned int mortais = ((1u << FOGO) | (1u << AGUA) | (1u << TERRA)) & ~(1u << inofensivo);
+        ResultadoOcupacao r = ConsultarOcupacao(mundo->mapaPerigosFase, rec, mortais);
+        if (r != OCUPACAO_DUVIDA) return r == OCUPACAO_TOCA;
+    }
+    int ids[MAX_CANDIDATOS];
+    int n = Candidatos(&mundo->indicePerigos, rec, ids);
+    int total = (n < 0) ? mundo->numPerigosAtuais : n;
+    for (int k = 0; k < total; k++) {
+        const Perigo *perigo = &mundo->perigosAtuais[IdCandidato(k, n, ids)];
+        if (perigo->tipo != inofensivo && CheckCollisionRecs(rec, perigo->retangulo)) return true;
+    }
+    return false;
+}
+
+// Os botes encostados neste passo (pelos recsJogadores) vo pro grafo de gatilhos, que s mexe no que
+// comeou ou parou de encostar
+static void AtualizarBotoes(Mundo *mundo) {
+    int *contatos = mundo->contatos;
+    int n = 0, emBotoes = 0;
+    for (int k = 0; k < mundo->numJogadores; k++) {
+        int nk = BotoesEncostados(mundo, mundo->recsJogadores[k], contatos + n, &mundo->contatosJogadores[k]);
+        if (nk > 0) emBotoes++;
+        n += nk;
+    }
+    if (emBotoes > 1) {
+        // Mais de um jogador em botes: junta as listas, sem repetir o boto em que mais de um est
+        qsort(contatos, (size_t)n, sizeof(int), CompararIds);
+        int unicos = 0;
+        for (int i = 0; i < n; i++)
+            if (unicos == 0 || contatos[i] != contatos[unicos - 1]) contatos[unicos++] = contatos[i];
+        n = unicos;
+    }
+    if (AvancarGatilhos(&mundo->gatilhos, contatos, n) > 0) AplicarGatilhos(mundo);
+}
+
+void RefazerBotoes(Mundo *mundo) {
+    int n = 0;
+    for (int i = 0; i < mundo->numBotoesAtuais; i++)
+        if (mundo->botoesAtuais[i].pressionado) mundo->contatos[n++] = mundo->carregadosBotoes.ids[i];
+    RefazerGatilhos(&mundo->gatilhos, mundo->contatos, n);
+    const GrafoGatilhos *g = &mundo->gatilhos;
+    for (int i = 0; i < mundo->numBotoesAtuais; i++)
+        mundo->botoesAtuais[i].pressionado = BotaoLigado(g, mundo->carregadosBotoes.ids[i]);
+    for (int i = 0; i < mundo->numPlataformasMoveisAtuais; i++) {
+        int id = mundo->carregadosMoveis.ids[i];
+        mundo->plataformasMoveisAtuais[i].ativa = MovelLigada(g, id) || MovelSempreAtiva(mundo, id);
+    }
+    AcordarMoveis(mundo);
+}
+
+// Aplica as teclas de um jogador (andar mexe direto na posio, pular s se estiver no cho)
+static void AplicarEntrada(Jogador *j, EntradaJogador entrada) {
+    // A andada vira velocidade.x e s  aplicada no AtualizarJogador (que pode varrer o movimento)
+    j->velocidade.x = 0;
+    if (entrada.esquerda) j->velocidade.x -= VELOCIDADE_MOVIMENTO;
+    if (entrada.direita) j->velocidade.x += VELOCIDADE_MOVIMENTO;
+    if (entrada.pular && j->podePular) {
+        j->velocidade.y = FORCA_PULO;
+        j->podePular = false;
+    }
+}
+
+// Um passo da simulao com os dois primeiros jogadores (o jogo e os replays)
+int PassoMundo(Mundo *mundo, Entradas entradas) {
+    EntradaJogador porJogador[2] = { entradas.fogo, entradas.agua };
+    return PassoMundoJogadores(mundo, porJogador, 2);
+}
+
+// Um passo da simulao, na mesma ordem que o loop do main fazia (cada etapa vai jogador por jogador).
+// S faz alguma coisa no estado JOGANDO; devolve os bits de ResultadoPasso.
+int PassoMundoJogadores(Mundo *mundo, const EntradaJogador entradas[], int numEntradas) {
+    if (mundo->estado != JOGANDO) return PASSO_NADA;
+
+    int resultado = PASSO_NADA;
+    int numJogadores = mundo->numJogadores;
+    Jogador *jogadores = mundo->jogadores;
+    Rectangle *recs = mundo->recsJogadores;
+
+    if (CarregarPedacos(mundo, false)) resultado |= PASSO_PEDACOS;
+    MarcarEtapa(mundo->perfil, ETAPA_PEDACOS);
+
+    for (int k = 0; k < numJogadores; k++)
+        AplicarEntrada(&jogadores[k], (k < numEntradas) ? entradas[k] : (EntradaJogador){ false, false, false });
+    MarcarEtapa(mundo->perfil, ETAPA_ENTRADA);
+
+    // Os retngulos so pegos antes da fsica, j com a andada do passo (botes, diamante e perigos usam esses)
+    for (int k = 0; k < numJogadores; k++) {
+        recs[k] = RetanguloJogador(&jogadores[k]);
+        recs[k].x += jogadores[k].velocidade.x;
+    }
+
+    // Fase sem botes ou sem mveis no tem nada pra fazer nessas etapas
+    if (mundo->recursos & RECURSO_BOTOES) AtualizarBotoes(mundo);
+    if (mundo->recursos & RECURSO_MOVEIS) AtualizarPlataformasMoveis(mundo);
+    MarcarEtapa(mundo->perfil, ETAPA_BOTOES);
+
+    for (int k = 0; k < numJogadores; k++) {
+        AtualizarJogador(&jogadores[k], mundo->plataformasAtuais, mundo->numPlataformasAtuais, mundo->plataformasMoveisAtuais, mundo->numPlataformasMoveisAtuais, GRAVIDADE,
+                         &mundo->indicePlataformas, &mundo->indicePlataformasMoveis, mundo->corpos, &mundo->contatosJogadores[k]);
+        MarcarEtapa(mundo->perfil, (jogadores[k].tipo == JOGADOR_FOGO) ? ETAPA_FOGO : ETAPA_AGUA);
+    }
+    ColidirJogadores(mundo);
+    mundo->passosFase++;
+    MarcarEtapa(mundo->perfil, ETAPA_COLISAO_JOGADORES);
+
+    if (VerificarLimitesEReiniciar(mundo)) resultado |= PASSO_REINICIOU;
+    MarcarEtapa(mundo->perfil, ETAPA_LIMITES);
+
+    if (mundo->temDiamanteAtual && !mundo->diamanteColetado) {
+        for (int k = 0; k < numJogadores; k++) {
+            if (CheckCollisionRecs(recs[k], mundo->diamante)) {
+                mundo->diamanteColetado = true;
+                mundo->diamantesColetados++;
+                resultado |= PASSO_DIAMANTE;
+                break;
+            }
+        }
+    }
+
+    // AGUA mata o Fogo, FOGO mata a gua, TERRA mata os dois
+    for (int k = 0; k < numJogadores && (mundo->recursos & RECURSO_PERIGOS); k++) {
+        if (TocouPerigo(mundo, recs[k], (jogadores[k].tipo == JOGADOR_FOGO) ? FOGO : AGUA)) {
+            mundo->estado = FIM_DE_JOGO;
+            break;
+        }
+    }
+    if (mundo->estado == FIM_DE_JOGO) resultado |= PASSO_MORTE;
+
+    // Todos na porta do seu tipo: porta 0  a do Fogo e porta 1 a da gua (fase sem as duas portas no tem como ganhar)
+    bool todosNaPorta = mundo->numPortasAtuais >= 2;
+    for (int k = 0; k < numJogadores && todosNaPorta; k++) {
+        const Porta *porta = &mundo->portasAtuais[(jogadores[k].tipo == JOGADOR_FOGO) ? 0 : 1];
+        todosNaPorta = CheckCollisionRecs(RetanguloJogador(&jogadores[k]), porta->retangulo);
+    }
+    if (todosNaPorta) {
+        mundo->estado = VITORIA;
+        resultado |= PASSO_VITORIA;
+    }
+    MarcarEtapa(mundo->perfil, ETAPA_PERIGOS);
+
+    return resultado;
+}
+
+// Parte do cdigo que cria a funo mais importante do jogo CUIDADO! (Especialmente vc Tarek)
+// S roda ao trocar de fase: monta o grafo de gatilhos e a tabela de pedaos de cada tipo, carrega os pedaos do comeo e chama ReiniciarFase.
+void CarregarFase(Mundo *mundo, const DadosFase *fase) {
+    mundo->faseAtual = fase;
+    mundo->numPortasAtuais = fase->numPortas;
+    mundo->portasAtuais = fase->portas;
+    mundo->temDiamanteAtual = fase->temDiamante;
+    mundo->diamante = fase->diamante;
+    TamanhoDaFase(fase, &mundo->larguraFase, &mundo->alturaFase);
+    mundo->colunasPedacos = (int)ceilf(mundo->larguraFase / TAM_PEDACO);
+    mundo->linhasPedacos = (int)ceilf(mundo->alturaFase / TAM_PEDACO);
+
+    MontarCaminhos(mundo, fase);
+    mundo->recursos = (fase->pronta != NULL) ? fase->pronta->recursos : RecursosDaFase(fase);
+    MontarGatilhos(&mundo->gatilhos, fase->numBotoes > 0 ? &fase->botoes[0].idAlvo : NULL, sizeof(Botao), fase->numBotoes, fase->numPlataformasMoveis,
+                   fase->nosLogicos, fase->numNosLogicos, fase->ligacoes, fase->numLigacoes,
+                   (fase->pronta != NULL) ? fase->pronta->inicioAlcance : NULL, (fase->pronta != NULL) ? fase->pronta->alcance : NULL);
+
+    ConstruirGrade(&mundo->carregadosPlataformas.pedacos, &fase->plataformas[0].retangulo, sizeof(Plataforma), fase->numPlataformas, TAM_PEDACO);
+    ConstruirGrade(&mundo->carregadosPerigos.pedacos, &fase->perigos[0].retangulo, sizeof(Perigo), fase->numPerigos, TAM_PEDACO);
+    if (fase->pronta != NULL) {
+        mundo->mapaPerigosFase = &fase->pronta->mapaPerigos;
+    } else {
+        MontarMapaPerigos(&mundo->mapaPerigos, fase);
+        mundo->mapaPerigosFase = &mundo->mapaPerigos;
+    }
+    ConstruirGrade(&mundo->carregadosBotoes.pedacos, &fase->botoes[0].retangulo, sizeof(Botao), fase->numBotoes, TAM_PEDACO);
+    // A mvel entra nos pedaos do caminho inteiro dela
+    int numMoveis = fase->numPlataformasMoveis;
+    Rectangle *caminhos = (Rectangle *)malloc(sizeof(Rectangle) * (size_t)(numMoveis > 0 ? numMoveis : 1));
+    CaixasDosCaminhos(fase, caminhos);
+    ConstruirGrade(&mundo->carregadosMoveis.pedacos, caminhos, sizeof(Rectangle), numMoveis, TAM_PEDACO);
+    free(caminhos);
+
+    // Pedaos do comeo da fase (ReiniciarFase no recarrega se os pedaos forem os mesmos)
+    for (int k = 0; k < mundo->numJogadores; k++) {
+        Jogador *j = &mundo->jogadores[k];
+        j->posicao = (j->tipo == JOGADOR_FOGO) ? fase->posInicialFogo : fase->posInicialAgua;
+    }
+    CarregarPedacos(mundo, true);
+    ReiniciarFase(mundo);
+}
+
+unsigned int RecursosDaFase(const DadosFase *fase) {
+    unsigned int recursos = 0;
+    if (fase->numPerigos > 0) recursos |= RECURSO_PERIGOS;
+    if (fase->numBotoes > 0) recursos |= RECURSO_BOTOES;
+    if (fase->numPlataformasMoveis > 0) recursos |= RECURSO_MOVEIS;
+    if (fase->temDiamante) recursos |= RECURSO_DIAMANTE;
+    return recursos;
+}
+
+// At onde vo os itens da fase (mveis com o caminho todo), e pelo menos o tamanho da tela
+void TamanhoDaFase(const DadosFase *fase, float *largura, float *altura) {
+    float maxX = LARGURA_TELA, maxY = ALTURA_TELA;
+#define INCLUIR(r) do { maxX = fmaxf(maxX, (r).x + (r).width); maxY = fmaxf(maxY, (r).y + (r).height); } while (0)
+    for (int i = 0; i < fase->numPlataformas; i++) INCLUIR(fase->plataformas[i].retangulo);
+    for (int i = 0; i < fase->numPerigos; i++) INCLUIR(fase->perigos[i].retangulo);
+    for (int i = 0; i < fase->numPortas; i++) INCLUIR(fase->portas[i].retangulo);
+    for (int i = 0; i < fase->numBotoes; i++) INCLUIR(fase->botoes[i].retangulo);
+    for (int i = 0; i < fase->numPlataformasMoveis; i++) {
+        const PlataformaMovel *p = &fase->plataformasMoveis[i];
+        INCLUIR(p->retangulo);
+        INCLUIR(((Rectangle){ p->posInicial.x, p->posInicial.y, p->retangulo.width, p->retangulo.height }));
+        INCLUIR(((Rectangle){ p->posFinal.x, p->posFinal.y, p->retangulo.width, p->retangulo.height }));
+    }
+    for (int c = 0; c < fase->numCaminhos; c++) {
+        const CaminhoMovel *cm = &fase->caminhos[c];
+        if (cm->movel < 0 || cm->movel >= fase->numPlataformasMoveis || cm->primeiroPonto < 0 ||
+            cm->primeiroPonto + cm->numPontos > fase->numPontosCaminho) continue;
+        Rectangle tamanho = fase->plataformasMoveis[cm->movel].retangulo;
+        for (int k = 0; k < cm->numPontos; k++) {
+            Vector2 ponto = fase->pontosCaminho[cm->primeiroPonto + k];
+            INCLUIR(((Rectangle){ ponto.x, ponto.y, tamanho.width, tamanho.height }));
+        }
+    }
+    if (fase->temDiamante) INCLUIR(fase->diamante);
+#undef INCLUIR
+    maxX = fmaxf(maxX, fmaxf(fase->posInicialFogo.x, fase->posInicialAgua.x) + 10);
+    maxY = fmaxf(maxY, fmaxf(fase->posInicialFogo.y, fase->posInicialAgua.y));
+    *largura = maxX;
+    *altura = maxY;
+}
+
+// Viso (sem cpia) de uma fase escrita no cdigo
+DadosFase DadosDaFase(const Fase *fase) {
+    DadosFase dados;
+    dados.plataformas = fase->plataformas;
+    dados.perigos = fase->perigos;
+    dados.portas = fase->portas;
+    dados.botoes = fase->botoes;
+    dados.plataformasMoveis = fase->plataformasMoveis;
+    dados.nosLogicos = NULL;
+    dados.ligacoes = NULL;
+    dados.numNosLogicos = 0;
+    dados.numLigacoes = 0;
+    dados.caminhos = NULL;
+    dados.pontosCaminho = NULL;
+    dados.numCaminhos = 0;
+    dados.numPontosCaminho = 0;
+    dados.numPlataformas = fase->numPlataformas;
+    dados.numPerigos = fase->numPerigos;
+    dados.numPortas = fase->numPortas;
+    dados.numBotoes = fase->numBotoes;
+    dados.numPlataformasMoveis = fase->numPlataformasMoveis;
+    dados.posInicialFogo = fase->posInicialFogo;
+    dados.posInicialAgua = fase->posInicialAgua;
+    dados.temDiamante = fase->temDiamante;
+    dados.diamante = fase->diamante;
+    dados.tempoPar = fase->tempoPar;
+    dados.pronta = NULL;
+    return dados;
+}
+
+// Parte do cdigo que cria a funo de calcular a coliso dos jogadores com o cenario
+void ResolverColisaoJogadores(Jogador *fogo, Jogador *agua) {
+    Rectangle recF = { fogo->posicao.x - 10, fogo->posicao.y - 20, 20, 20 };
+    Rectangle recA = { agua->posicao.x - 10, agua->posicao.y - 20, 20, 20 };
+    if (CheckCollisionRecs(recF, recA)) {
+        Rectangle overlap = GetCollisionRec(recF, recA);
+        if (overlap.width < overlap.height) {
+            float shift = overlap.width / 2.0f;
+            if (recF.x < recA.x) {
+                fogo->posicao.x -= shift;
+                agua->posicao.x += shift;
+            } else {
+                fogo->posicao.x += shift;
+                agua->posicao.x -= shift;
+            }
+        } else {
+            if (fogo->velocidade.y > 0 && recF.y < recA.y) {
+                fogo->posicao.y = recA.y;
+                fogo->velocidade.y = 0;
+                fogo->podePular = true;
+            } else if (agua->velocidade.y > 0 && recA.y < recF.y) {
+                agua->posicao.y = recF.y;
+                agua->velocidade.y = 0;
+                agua->podePular = true;
+            }
+        }
+    }
+}
+
+void ColidirJogadores(Mundo *mundo) {
+    int n = mundo->numJogadores;
+    Jogador *jogadores = mundo->jogadores;
+    float *esquerda = mundo->esquerdaJogadores;
+    int *ordem = mundo->ordemJogadores;
+    for (int k = 0; k < n; k++) esquerda[k] = jogadores[k].posicao.x - 10;
+
+    // Ordena por insero: de um passo pro outro a ordem quase no muda, ento fica perto de linear
+    for (int a = 1; a < n; a++) {
+        int k = ordem[a];
+        int b = a - 1;
+        while (b >= 0 && esquerda[ordem[b]] > esquerda[k]) {
+            ordem[b + 1] = ordem[b];
+            b--;
+        }
+        ordem[b + 1] = k;
+    }
+
+    // Cada jogador s testa os que comeam antes da borda direita dele (o cubo tem 20 px).
+    // O par vai sempre na ordem dos ndices, como o Fogo antes da gua.
+    for (int a = 0; a < n; a++) {
+        int i = ordem[a];
+        float direita = esquerda[i] + 20;
+        for (int b = a + 1; b < n && esquerda[ordem[b]] < direita; b++) {
+            int k = ordem[b];
+            if (i < k) ResolverColisaoJogadores(&jogadores[i], &jogadores[k]);
+            else ResolverColisaoJogadores(&jogadores[k], &jogadores[i]);
+        }
+    }
+}
+
+// Parte do cdigo que cria a funo para movimentar os cubos/jogadores
+// Tempo (0 a 1) em que rec, andando d, encosta em p. S vale se no estavam se encostando no comeo
+// (esse caso fica pra correo normal). eixoX diz se a batida foi de lado, seno foi por cima/baixo.
+static bool TempoDeImpacto(Rectangle rec, Vector2 d, Rectangle p, float *tempo, bool *eixoX) {
+    float entradaX = -INFINITY, saidaX = INFINITY, entradaY = -INFINITY, saidaY = INFINITY;
+    if (d.x > 0) {
+        entradaX = (p.x - (rec.x + rec.width)) / d.x;
+        saidaX = (p.x + p.width - rec.x) / d.x;
+    } else if (d.x < 0) {
+        entradaX = (p.x + p.width - rec.x) / d.x;
+        saidaX = (p.x - (rec.x + rec.width)) / d.x;
+    } else if (rec.x >= p.x + p.width || rec.x + rec.width <= p.x) {
+        return false;
+    }
+    if (d.y > 0) {
+        entradaY = (p.y - (rec.y + rec.height)) / d.y;
+        saidaY = (p.y + p.height - rec.y) / d.y;
+    } else if (d.y < 0) {
+        entradaY = (p.y + p.height - rec.y) / d.y;
+        saidaY = (p.y - (rec.y + rec.height)) / d.y;
+    } else if (rec.y >= p.y + p.height || rec.y + rec.height <= p.y) {
+        return false;
+    }
+
+    float entrada = fmaxf(entradaX, entradaY);
+    float saida = fminf(saidaX, saidaY);
+    // entrada == saida  s raspar a quina, no conta (igual ao CheckCollisionRecs)
+    if (entrada >= saida || entrada < 0.0f || entrada >= 1.0f) return false;
+    *tempo = entrada;
+    *eixoX = entradaX > entradaY;
+    return true;
+}
+
+// Primeira batida de rec andando d contra os retngulos (recs/passo igual ao MontarIndice).
+// Devolve true se achou uma batida antes de *tempo.
+static bool BatidaMaisCedo(Rectangle rec, Vector2 d, Rectangle area, const Rectangle *recs, size_t passo, int n,
+                           const IndiceColisao *indice, float *tempo, bool *eixoX, Rectangle *alvo, int *idAlvo) {
+    int ids[MAX_CANDIDATOS];
+    int nCand = Candidatos(indice, area, ids);
+    int total = (nCand < 0) ? n : nCand;
+    bool achou = false;
+    for (int k = 0; k < total; k++) {
+        int i = IdCandidato(k, nCand, ids);
+        Rectangle p = *(const Rectangle *)((const char *)recs + passo * (size_t)i);
+        float t;
+        bool x;
+        if (TempoDeImpacto(rec, d, p, &t, &x) && t < *tempo) {
+            *tempo = t;
+            *eixoX = x;
+            *alvo = p;
+            *idAlvo = i;
+            achou = true;
+        }
+    }
+    return achou;
+}
+
+// Move o jogador por d parando na primeira plataforma que ele encontrar no caminho (AABB varrido).
+// Depois de bater continua deslizando no outro eixo. As plataformas mveis entram j na posio deste passo.
+// Cada batida vira um contato, e pousar em cima vira o apoio do jogador.
+static void MoverVarrendo(Jogador *j, Vector2 d, float w, float h, const Plataforma plat[], int nPlat,
+                          const PlataformaMovel platMoveis[], int nPlatMoveis,
+                          const IndiceColisao *indicePlat, const IndiceColisao *indiceMoveis,
+                          ContatosJogador *contatos) {
+    for (int batidas = 0; batidas < 3 && (d.x != 0 || d.y != 0); batidas++) {
+        Rectangle rec = { j->posicao.x - w/2, j->posicao.y - h, w, h };
+        Rectangle area = { fminf(rec.x, rec.x + d.x), fminf(rec.y, rec.y + d.y), w + fabsf(d.x), h + fabsf(d.y) };
+        float tempo = 1.0f;
+        bool eixoX = false;
+        Rectangle alvo = {0};
+        int idAlvo = -1;
+        TipoContato tipoAlvo = CONTATO_PLATAFORMA;
+        if (nPlat > 0)
+            BatidaMaisCedo(rec, d, area, &plat[0].retangulo, sizeof(Plataforma), nPlat, indicePlat, &tempo, &eixoX, &alvo, &idAlvo);
+        if (nPlatMoveis > 0 &&
+            BatidaMaisCedo(rec, d, area, &platMoveis[0].retangulo, sizeof(PlataformaMovel), nPlatMoveis, indiceMoveis, &tempo, &eixoX, &alvo, &idAlvo))
+            tipoAlvo = CONTATO_MOVEL;
+
+        if (tempo >= 1.0f) {
+            j->posicao.x += d.x;
+            j->posicao.y += d.y;
+            return;
+        }
+
+        // Anda at a batida e encosta exatamente na face (sem erro de arredondamento)
+        j->posicao.x += d.x * tempo;
+        j->posicao.y += d.y * tempo;
+        if (eixoX) {
+            j->posicao.x = (d.x > 0) ? alvo.x - w/2 : alvo.x + alvo.width + w/2;
+            GuardarContato(contatos, tipoAlvo, idAlvo, (Vector2){ (d.x > 0) ? -1.0f : 1.0f, 0 });
+            j->velocidade.x = 0;
+            d.x = 0;
+            d.y *= 1.0f - tempo;
+        } else {
+            if (d.y > 0) {
+                j->posicao.y = alvo.y;
+                j->podePular = true;
+                GuardarApoio(contatos, tipoAlvo, idAlvo);
+            } else {
+                j->posicao.y = alvo.y + alvo.height + h;
+                GuardarContato(contatos, tipoAlvo, idAlvo, (Vector2){ 0, 1 });
+            }
+            j->velocidade.y = 0;
+            d.y = 0;
+            d.x *= 1.0f - tempo;
+        }
+    }
+}
+
+// true se rec encosta em alguma plataforma mvel
+static bool EncostaEmMovel(Rectangle rec, const PlataformaMovel platMoveis[], int nPlatMoveis, const IndiceColisao *indiceMoveis) {
+    if (nPlatMoveis <= 0) return false;
+    int ids[MAX_CANDIDATOS];
+    int n = Candidatos(indiceMoveis, rec, ids);
+    int total = (n < 0) ? nPlatMoveis : n;
+    for (int k = 0; k < total; k++)
+        if (CheckCollisionRecs(rec, platMoveis[IdCandidato(k, n, ids)].retangulo)) return true;
+    return false;
+}
+
+// Mesma posio e velocidade no comeo do passo
+static inline bool MesmoComeco(const Jogador *a, const Jogador *b) {
+    return a->posicao.x == b->posicao.x && a->posicao.y == b->posicao.y &&
+           a->velocidade.x == b->velocidade.x && a->velocidade.y == b->velocidade.y;
+}
+
+void AtualizarJogador(Jogador *j, const Plataforma plat[], int nPlat,
+                      const PlataformaMovel platMoveis[], int nPlatMoveis,
+                      float gravidade,
+                      const IndiceColisao *indicePlat, const IndiceColisao *indiceMoveis, const CorpoCinematico corpos[],
+                      ContatosJogador *contatos) {
+    float h = 20.0f, w = 20.0f;
+
+    // Sem contatos de fora, os do passo ficam aqui (sem cache, s pra achar a mvel que carrega)
+    ContatosJogador semCache;
+    bool comCache = contatos != NULL;
+    if (!comCache) {
+        contatos = &semCache;
+    } else if (contatos->repetivel && MesmoComeco(j, &contatos->entrada)) {
+        // Parado no mesmo apoio fixo que no passo anterior: se nenhuma mvel chegou perto (nem de onde ele
+        // comea a coliso nem de onde ele terminou), as colises do o mesmo resultado de antes
+        Rectangle rec = { j->posicao.x + j->velocidade.x - w/2, j->posicao.y + (j->velocidade.y + gravidade) - h, w, h };
+        Rectangle recSaida = { contatos->saida.posicao.x - w/2, contatos->saida.posicao.y - h, w, h };
+        if (!EncostaEmMovel(rec, platMoveis, nPlatMoveis, indiceMoveis) && !EncostaEmMovel(recSaida, platMoveis, nPlatMoveis, indiceMoveis)) {
+            *j = contatos->saida;
+            return;
+        }
+    }
+    Jogador entrada = *j;
+    contatos->numContatos = 0;
+    contatos->apoio = -1;
+    contatos->repetivel = false;
+    bool varreu = false, tocouMovel = false;
+    j->podePular = false;
+
+    // Movimento horizontal e gravidade. Andando menos que o tamanho do jogador no tem como atravessar
+    // uma plataforma inteira (a posio final ainda encosta nela), ento s o passo grande  varrido.
+    j->velocidade.y += gravidade;
+    Vector2 d = j->velocidade;
+    if (fabsf(d.x) >= w || fabsf(d.y) >= h) {
+        MoverVarrendo(j, d, w, h, plat, nPlat, platMoveis, nPlatMoveis, indicePlat, indiceMoveis, contatos);
+        varreu = true;
+    } else {
+        j->posicao.x += d.x;
+        j->posicao.y += d.y;
+    }
+
+    // Define retngulo de coliso do jogador
+    Rectangle rec = { j->posicao.x - w/2, j->posicao.y - h, w, h };
+
+    // S testa o que o ndice diz que est perto (sem ndice, testa tudo). As fixas vm do cache de contatos
+    // enquanto o jogador no sai da regio dele.
+    int consultaPlat[MAX_CANDIDATOS], idsMoveis[MAX_CANDIDATOS];
+    const int *idsPlat = consultaPlat;
+    int nCandPlat = comCache ? CandidatosPerto(&contatos->plataformasPerto, indicePlat, &plat[0].retangulo, sizeof(Plataforma), rec, consultaPlat, &idsPlat)
+                                       : Candidatos(indicePlat, rec, consultaPlat);
+    int nCandMoveis = (nPlatMoveis > 0) ? Candidatos(indiceMoveis, rec, idsMoveis) : 0;
+    int totalPlat = (nCandPlat < 0) ? nPlat : nCandPlat;
+    int totalMoveis = (nCandMoveis < 0) ? nPlatMoveis : nCandMoveis;
+
+    // Coliso vertical com plataformas estticas
+    for (int k = 0; k < totalPlat; k++) {
+        int i = IdCandidato(k, nCandPlat, idsPlat);
+        Rectangle p = plat[i].retangulo;
+        if (CheckCollisionRecs(rec, p)) {
+            // Descendo sobre a plataforma
+            if (j->velocidade.y > 0 && (rec.y + h - j->velocidade.y) <= p.y) {
+                j->posicao.y = p.y;
+                j->velocidade.y = 0;
+                j->podePular = true;
+                GuardarApoio(contatos, CONTATO_PLATAFORMA, i);
+            }
+            // Batendo de baixo na plataforma
+            else if (j->velocidade.y < 0 && rec.y > (p.y + p.height - 5)) {
+                j->posicao.y = p.y + p.height + h;
+                j->velocidade.y = 0; //  Zera velocidade pra no grudar no teto
+                GuardarContato(contatos, CONTATO_PLATAFORMA, i, (Vector2){ 0, 1 });
+            }
+        }
+    }
+
+    // Coliso vertical com plataformas mveis
+    for (int k = 0; k < totalMoveis; k++) {
+        int i = IdCandidato(k, nCandMoveis, idsMoveis);
+        Rectangle p = platMoveis[i].retangulo;
+        if (CheckCollisionRecs(rec, p)) {
+            tocouMovel = true;
+            if (j->velocidade.y > 0 && (rec.y + h - j->velocidade.y) <= p.y) {
+                j->posicao.y = p.y;
+                j->velocidade.y = 0;
+                j->podePular = true;
+                GuardarApoio(contatos, CONTATO_MOVEL, i);
+            } else if (j->velocidade.y < 0 && rec.y > (p.y + p.height - 5)) {
+                j->posicao.y = p.y + p.height + h;
+                j->velocidade.y = 0;
+                GuardarContato(contatos, CONTATO_MOVEL, i, (Vector2){ 0, 1 });
+            }
+        }
+    }
+
+    // Quem terminou em cima de uma mvel  empurrado junto com ela (em linha reta: se ela estiver ativa)
+    int carregadora = MovelQueCarrega(contatos);
+    if (carregadora >= 0) {
+        float arrasto = (corpos != NULL) ? corpos[carregadora].arrastoX : ArrastoReto(&platMoveis[carregadora]);
+        if (arrasto != 0) j->posicao.x += arrasto;
+    }
+
+    // Coliso horizontal com plataformas estticas
+    {
+        // Usa o mesmo rec de coliso
+        Rectangle rec2 = rec;
+        for (int k = 0; k < totalPlat; k++) {
+            int i = IdCandidato(k, nCandPlat, idsPlat);
+            Rectangle p = plat[i].retangulo;
+            if (CheckCollisionRecs(rec2, p)) {
+                Rectangle overlap = GetCollisionRec(rec2, p);
+                // Se a penetrao horizontal for menor que a vertical,
+                // corrige apenas no eixo X
+                if (overlap.width < overlap.height) {
+                    if (rec2.x < p.x)
+                        j->posicao.x -= overlap.width;
+                    else
+                        j->posicao.x += overlap.width;
+                    GuardarContato(contatos, CONTATO_PLATAFORMA, i, (Vector2){ (rec2.x < p.x) ? -1.0f : 1.0f, 0 });
+                }
+            }
+        }
+    }
+
+    // Coliso horizontal com plataformas mveis (Semi quebrado, tem bugs nessa parte aqui)
+    if (nPlatMoveis > 0) {
+        float w2 = 20.0f, h2 = 20.0f;
+        Rectangle rec2 = { j->posicao.x - w2/2, j->posicao.y - h2, w2, h2 };
+        // O jogador pode ter andado nas passadas de cima, ento consulta de novo
+        nCandMoveis = Candidatos(indiceMoveis, rec2, idsMoveis);
+        totalMoveis = (nCandMoveis < 0) ? nPlatMoveis : nCandMoveis;
+        for (int k = 0; k < totalMoveis; k++) {
+            int i = IdCandidato(k, nCandMoveis, idsMoveis);
+            Rectangle p = platMoveis[i].retangulo;
+            if (CheckCollisionRecs(rec2, p)) {
+                tocouMovel = true;
+                Rectangle overlap = GetCollisionRec(rec2, p);
+                if (overlap.width < overlap.height) {
+                    if (rec2.x < p.x) {
+                        j->posicao.x -= overlap.width;
+                    } else {
+                        j->posicao.x += overlap.width;
+                    }
+                    GuardarContato(contatos, CONTATO_MOVEL, i, (Vector2){ (rec2.x < p.x) ? -1.0f : 1.0f, 0 });
+                }
+            }
+        }
+    }
+
+    if (comCache) {
+        contatos->repetivel = !varreu && !tocouMovel && contatos->apoio >= 0 && contatos->contatos[contatos->apoio].tipo == CONTATO_PLATAFORMA;
+        contatos->entrada = entrada;
+        contatos->saida = *j;
+    }
+}
+
+// Funo para impedir do jogador de sair do limite da fase.
+// Devolve true se algum caiu (e recarrega a fase, se reiniciarNaQueda).
+bool VerificarLimitesEReiniciar(Mundo *mundo)
+{
+    const float halfW = 10.0f;
+    const float halfH = 20.0f;
+
+    // paredes invisveis (laterais e teto) nas bordas da fase; se qualquer jogador cair reinicia a fase
+    bool caiu = false;
+    for (int k = 0; k < mundo->numJogadores; k++) {
+        Jogador *j = &mundo->jogadores[k];
+        if (j->posicao.x < halfW)                           j->posicao.x = halfW;
+        if (j->posicao.x > mundo->larguraFase - halfW)      j->posicao.x = mundo->larguraFase - halfW;
+        if (j->posicao.y < halfH) {
+            j->posicao.y = halfH;
+            j->velocidade.y = 0;
+        }
+        if (j->posicao.y > mundo->alturaFase) caiu = true;
+    }
+    if (caiu) {
+        if (mundo->reiniciarNaQueda) ReiniciarFase(mundo);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,467 @@
+/*
+Ncleo da simulao do jogo (fsica, botes, plataformas mveis e perigos).
+No usa nenhuma funo de janela/desenho do raylib, ento roda em servidor sem tela.
+Compilando com -DSIMULACAO_HEADLESS o raylib nem precisa estar instalado.
+*/
+#ifndef SIMULACAO_H
+#define SIMULACAO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "tipos.h"
+#include "grade.h"
+#include "colisores.h"
+#include "ocupacao.h"
+#include "gatilhos.h"
+#include "perfil.h"
+
+// Constantes do cdigo
+#define LARGURA_TELA 800
+#define ALTURA_TELA 600
+#define MAX_PLATAFORMAS 20
+#define MAX_PERIGOS 10
+#define MAX_PORTAS 2
+#define MAX_FASES 3
+#define MAX_BOTOES 5
+#define MAX_PLATAFORMAS_MOVEIS 5
+
+// Passo fixo da fsica: a taxa de quadros da tela no muda mais o jogo. GRAVIDADE e as velocidades so por
+// passo, ento TAXA_PASSOS tem que ficar em 60 (mudar ela muda a velocidade do jogo, a no ser que essas
+// constantes sejam refeitas pra nova taxa).
+#define TAXA_PASSOS 60
+#define DT_PASSO (1.0 / TAXA_PASSOS)
+#define MAX_PASSOS_POR_QUADRO 8 // Limite de passos pra recuperar um quadro travado
+
+// Fases maiores que a tela so divididas em pedaos de TAM_PEDACO x TAM_PEDACO px. S os itens dos pedaos
+// em volta dos jogadores ficam carregados (cpias, ndices e simulao); o resto fica s nos dados da fase.
+#define TAM_PEDACO 512.0f
+#define RAIO_PEDACOS 1 // Pedaos carregados pra cada lado do pedao de cada jogador (bem mais do que se anda num passo)
+#define MARGEM_PEDACOS 128.0f // A caixa de um jogador s muda quando ele chega a essa distncia da borda dela
+
+// Com poucos itens testar todos em lote (SIMD)  mais rpido que consultar a grade
+#define MIN_ITENS_GRADE 16
+
+// Constantes da fsica (aplicadas uma vez por passo)
+#define GRAVIDADE 0.10f
+#define VELOCIDADE_MOVIMENTO 4.0f
+#define FORCA_PULO -5.8f
+
+// Constantes para os estados do jogo.
+typedef enum {
+    JOGANDO,
+    FIM_DE_JOGO,
+    VITORIA
+} EstadoJogo;
+
+// Constantes para os tipos de dano/morte.
+typedef enum {
+    FOGO, // Mata somente o cubo azul
+    AGUA, // Mata somente o cubo vermelho
+    TERRA // Mata os 2 cubos
+} TipoPerigo;
+
+// Constantes do jogadores
+typedef enum {
+    JOGADOR_FOGO, // Cubo vermelho
+    JOGADOR_AGUA // Cubo azul
+} TipoJogador;
+
+// Estrutura que representa o jogador (o tipo diz qual perigo no mata ele e qual porta  a dele)
+typedef struct {
+    TipoJogador tipo;
+    Vector2 posicao;
+    Vector2 velocidade;
+    Color cor;
+    bool podePular;
+} Jogador;
+
+// Estrutura para criar uma plataforma
+typedef struct {
+    Rectangle retangulo;
+} Plataforma;
+
+// Estrutura para criar algo que mate algum/todos os jogadores
+typedef struct {
+    Rectangle retangulo;
+    TipoPerigo tipo;
+    Color cor;
+} Perigo;
+
+// Estrutura para criar o fim da fase
+typedef struct {
+    Rectangle retangulo;
+    TipoJogador tipoJogador; // Cor do jogador que deve entrar
+    Color cor; // Cor da porta (Visual)
+} Porta;
+
+// Estrutura para criar um boto para ativar objetos mveis das fases
+typedef struct {
+    Rectangle retangulo;
+    int idAlvo; // Id do objeto mvel (-1 = nenhum; outras ligaes vo no grafo de gatilhos, ver gatilhos.h)
+    bool pressionado;
+    Color cor;
+} Botao;
+
+// Estrutura para criar um objeto mvel do cenario
+typedef struct {
+    Rectangle retangulo;
+    Vector2 posInicial;
+    Vector2 posFinal;
+    bool ativa;
+    float velocidade;
+} PlataformaMovel;
+
+// Caminho de uma plataforma mvel. Mvel sem caminho anda em linha reta at posFinal enquanto ativa e volta
+// pra posInicial quando desativa, um pouco em cada eixo por passo (como sempre foi).
+typedef enum {
+    CAMINHO_LINHA, // Vai pelos pontos at o ltimo enquanto ativa e volta pro primeiro quando desativa
+    CAMINHO_LACO,  // D voltas pelos pontos (do ltimo volta pro primeiro) enquanto ativa; desativada para onde est
+    CAMINHO_SUAVE  // Igual  LINHA, mas acelera no comeo e freia no fim
+} TipoCaminho;
+
+typedef struct {
+    int movel;          // Plataforma mvel (id na fase) que anda por ele; o retngulo dela s d o tamanho
+    TipoCaminho tipo;
+    int primeiroPonto;  // Pontos (canto de cima  esquerda da plataforma) em pontosCaminho[primeiroPonto ..]
+    int numPontos;
+    bool sempreAtiva;   // Anda sem precisar de boto
+} CaminhoMovel;
+
+// Estrutura para criar uma fase no jogo (formato das fases escritas no cdigo, ver fases.cpp)
+typedef struct {
+    Plataforma plataformas[MAX_PLATAFORMAS];
+    Perigo perigos[MAX_PERIGOS];
+    Porta portas[MAX_PORTAS];
+    Botao botoes[MAX_BOTOES];
+    PlataformaMovel plataformasMoveis[MAX_PLATAFORMAS_MOVEIS];
+    int numPlataformas;
+    int numPerigos;
+    int numPortas;
+    int numBotoes;
+    int numPlataformasMoveis;
+    Vector2 posInicialFogo;
+    Vector2 posInicialAgua;
+    bool temDiamante;
+    Rectangle diamante;
+    float tempoPar; // Segundos da melhor soluo achada pelo resolver_fases (0 = desconhecido)
+} Fase;
+
+// O que uma fase tem. Passos que a fase no precisa so pulados (sem mveis nem botes a fsica s v plataformas).
+typedef enum {
+    RECURSO_PERIGOS  = 1 << 0,
+    RECURSO_BOTOES   = 1 << 1,
+    RECURSO_MOVEIS   = 1 << 2,
+    RECURSO_DIAMANTE = 1 << 3
+} RecursoFase;
+
+// Dados de uma fase calculados antes pelo compilar_fases (fases compiladas no cdigo, s leitura). O CarregarFase
+// usa estes em vez de montar de novo; as grades s valem com a fase inteira carregada (os ids so os da fase).
+typedef struct {
+    unsigned int recursos;         // Bits de RecursoFase
+    GradeOcupacao mapaPerigos;     // Igual ao MontarMapaPerigos
+    GradeColisao gradePlataformas; // Iguais s do MontarIndice com todos os itens da fase
+    GradeColisao gradePerigos;
+    GradeColisao gradeBotoes;
+    const int *inicioAlcance;      // Mveis que cada boto alcana, igual ao GrafoGatilhos (numBotoes + 1 posies)
+    const int *alcance;
+} AceleracaoFase;
+
+// Viso de uma fase: s aponta para os dados, sem copiar e sem limite de tamanho.
+// Pode apontar para uma Fase do cdigo (DadosDaFase) ou para um pacote mapeado na memria (pacote.h).
+typedef struct {
+    const Plataforma *plataformas;
+    const Perigo *perigos;
+    const Porta *portas;
+    const Botao *botoes;
+    const PlataformaMovel *plataformasMoveis;
+    const NoLogico *nosLogicos; // Lgica dos botes alm do idAlvo (as fases do cdigo no tm)
+    const Ligacao *ligacoes;
+    const CaminhoMovel *caminhos; // Caminhos das mveis que no andam em linha reta
+    const Vector2 *pontosCaminho;
+    int numPlataformas;
+    int numPerigos;
+    int numPortas;
+    int numBotoes;
+    int numPlataformasMoveis;
+    int numNosLogicos;
+    int numLigacoes;
+    int numCaminhos;
+    int numPontosCaminho;
+    Vector2 posInicialFogo;
+    Vector2 posInicialAgua;
+    bool temDiamante;
+    Rectangle diamante;
+    float tempoPar;
+    const AceleracaoFase *pronta; // S nas fases compiladas (NULL = tudo  calculado ao carregar)
+} DadosFase;
+
+// Teclas de um jogador em um passo (pular = tecla apertada neste passo, no segurada)
+typedef struct {
+    bool esquerda;
+    bool direita;
+    bool pular;
+} EntradaJogador;
+
+// Entradas dos dois jogadores para um passo da simulao (jogadores 0 e 1; ver PassoMundoJogadores pra mais)
+typedef struct {
+    EntradaJogador fogo;
+    EntradaJogador agua;
+} Entradas;
+
+// Bits que PassoMundo devolve dizendo o que aconteceu no passo
+typedef enum {
+    PASSO_NADA      = 0,
+    PASSO_REINICIOU = 1 << 0, // Algum caiu e a fase foi recarregada (se reiniciarNaQueda)
+    PASSO_DIAMANTE  = 1 << 1, // O diamante foi pego neste passo
+    PASSO_MORTE     = 1 << 2, // Algum encostou num perigo (estado vai pra FIM_DE_JOGO)
+    PASSO_VITORIA   = 1 << 3, // Os dois chegaram nas portas (estado vai pra VITORIA)
+    PASSO_PEDACOS   = 1 << 4  // Os pedaos carregados mudaram (os ndices dos botes e mveis Atuais mudam)
+} ResultadoPasso;
+
+// Tabela de um caminho, montada ao carregar a fase: a posio sai do tempo andado, sem somar passo a passo
+typedef struct {
+    int inicio;        // distanciasCaminhos[inicio + k] = distncia do primeiro ponto at o ponto k
+    int numTrechos;    // Trechos entre pontos (no LACO conta a volta do ltimo pro primeiro)
+    float comprimento;
+    float duracao;     // Passos pra percorrer o caminho inteiro na velocidade da mvel (0 = no anda)
+} TabelaCaminho;
+
+// Estado de uma plataforma mvel carregada (anda junto com plataformasMoveisAtuais)
+typedef struct {
+    int caminho;      // ndice do caminho na fase (-1 = linha reta)
+    float tempo;      // Passos andados no caminho
+    float arrastoX;   // Quanto quem est em cima dela  empurrado em x no passo
+    bool acordada;    // Est na lista das que andam; parada no destino ela dorme e no custa nada
+} CorpoCinematico;
+
+// O que encosta num jogador. id  o ndice nos Atuais do tipo (plataformasAtuais ou plataformasMoveisAtuais).
+typedef enum {
+    CONTATO_PLATAFORMA,
+    CONTATO_MOVEL
+} TipoContato;
+
+typedef struct {
+    TipoContato tipo;
+    int id;
+    Vector2 normal; // Da superfcie pro jogador: (0,-1)  cho, (0,1)  teto e (1,0) parede
+} Contato;
+
+#define MAX_CONTATOS 8        // Contatos guardados por jogador num passo (os de depois no so guardados)
+#define MAX_ITENS_PERTO 16    // Itens fixos que o cache guarda em volta de um jogador (mais que isso consulta o ndice)
+#define MARGEM_PERTO 32.0f    // Folga da regio do cache em volta do retngulo do jogador
+
+// Itens fixos de um tipo em volta de um jogador: todos os que encostam em regiao, em ordem de id (como o
+// ndice devolve). Enquanto o retngulo do jogador fica dentro da regiao eles so os nicos que ele pode tocar,
+// ento a consulta ao ndice  pulada. S vale pros ndices com grade (com poucos itens o teste em lote j 
+// mais barato que conferir o cache).
+typedef struct {
+    Rectangle regiao;
+    int ids[MAX_ITENS_PERTO];
+    int num;                  // -1 = vazio (a prxima consulta vai no ndice)
+} ItensPerto;
+
+// Contatos de um jogador, que ficam de um passo pro outro: as plataformas que ele tocou no ltimo
+// AtualizarJogador e o cache das plataformas fixas e botes perto dele (esquecido quando os pedaos carregados
+// mudam). As mveis andam, ento vo sempre pelo ndice delas.
+// O apoio  conferido primeiro no passo seguinte: se o jogador terminou parado numa plataforma fixa, sem mvel
+// encostando, e comea o passo com a mesma posio e velocidade, o passo d o mesmo resultado (saida) sem
+// refazer as colises. A mvel que carrega o jogador tambm sai do apoio (MovelQueCarrega).
+typedef struct {
+    Contato contatos[MAX_CONTATOS];
+    int numContatos;
+    int apoio;                // Posio em contatos do cho onde ele terminou o passo (-1 = no ar)
+    bool repetivel;           // O ltimo passo s dependeu das plataformas fixas (entrada e saida valem)
+    Jogador entrada;          // Jogador no comeo do ltimo passo (antes da gravidade)
+    Jogador saida;            // E no fim dele
+    ItensPerto plataformasPerto;
+    ItensPerto botoesPerto;
+} ContatosJogador;
+
+// Mvel (ndice em plataformasMoveisAtuais) que est carregando o jogador, ou -1
+static inline int MovelQueCarrega(const ContatosJogador *c) {
+    if (c->apoio < 0 || c->contatos[c->apoio].tipo != CONTATO_MOVEL) return -1;
+    return c->contatos[c->apoio].id;
+}
+
+// Acelerao de coliso de um tipo de colisor: grade (broadphase) e cpia SoA (testes em lote)
+typedef struct {
+    GradeColisao grade;
+    ColisoresSoA soa;
+    const GradeColisao *pronta; // Grade da fase compilada usada no lugar de grade (NULL = a prpria)
+} IndiceColisao;
+
+// Itens de um tipo nos pedaos carregados. A tabela de pedaos  uma grade com clulas de TAM_PEDACO
+// sobre a fase inteira (montada ao carregar a fase); ids so os ndices na fase dos itens carregados, em ordem.
+typedef struct {
+    GradeColisao pedacos;
+    int *ids;
+    int num;
+    int cap;
+} ItensCarregados;
+
+// Todo o estado que muda durante uma fase
+typedef struct {
+    const DadosFase *fases;
+    int numFases;
+    int faseAtualIndex;
+    const DadosFase *faseAtual; // Fase carregada, nunca alterada: o reincio copia a parte que muda dela
+    EstadoJogo estado;
+
+    // Jogadores da fase. Os pares so do tipo Fogo e os mpares da gua (0  o menino Fogo e 1 a menina gua);
+    // cada um nasce no incio do seu tipo. Os vetores por jogador abaixo tm capJogadores posies.
+    Jogador *jogadores;
+    int numJogadores;
+    int capJogadores;
+    Rectangle *recsJogadores;   // Retngulo de cada um no passo, j com a andada (botes, diamante e perigos)
+    float *esquerdaJogadores;   // x da borda esquerda de cada um: a chave do sweep-and-prune
+    int *ordemJogadores;        // Jogadores em ordem de esquerdaJogadores (quase no muda entre passos)
+    ContatosJogador *contatosJogadores; // O que cada um tocou no ltimo passo (plataformas)
+
+    // Os Atuais so s os itens dos pedaos carregados (com a fase inteira carregada, todos os da fase).
+    // As partes fixas apontam direto para os dados da fase quando todas esto carregadas; seno apontam
+    // pra uma cpia das carregadas.
+    const Plataforma *plataformasAtuais;
+    const Perigo *perigosAtuais;
+    const Porta *portasAtuais;
+    // Botes e mveis mudam durante a fase, ento so copiados pra memria do mundo.
+    // O idAlvo dos botes copiados j  o ndice da mvel em plataformasMoveisAtuais.
+    // Quem liga os botes e as mveis  o grafo de gatilhos (pressionado e ativa s so escritos quando mudam).
+    Botao *botoesAtuais;
+    PlataformaMovel *plataformasMoveisAtuais;
+    int capBotoes;
+    int capPlataformasMoveis;
+
+    int numPlataformasAtuais;
+    int numPerigosAtuais;
+    int numPortasAtuais;
+    int numBotoesAtuais;
+    int numPlataformasMoveisAtuais;
+
+    Rectangle diamante;
+    bool temDiamanteAtual;
+    bool diamanteColetado;
+    int diamantesColetados;
+
+    long long passosFase; // Passos simulados desde o ltimo carregamento da fase
+
+    // ndices montados ao carregar a fase (o das mveis  atualizado quando elas andam)
+    IndiceColisao indicePlataformas;
+    IndiceColisao indicePlataformasMoveis;
+    IndiceColisao indicePerigos;
+    IndiceColisao indiceBotoes;
+
+    // Perigos da fase inteira rasterizados por tipo (montado ao carregar a fase; ver ocupacao.h). Com
+    // usarMapaPerigos (e pelo menos MIN_ITENS_GRADE perigos na fase) o TocouPerigo olha as clulas embaixo do
+    // jogador e s confere pelos retngulos na borda de um perigo; o resultado  o mesmo que sem ele.
+    GradeOcupacao mapaPerigos;
+    const GradeOcupacao *mapaPerigosFase; // O mapaPerigos ou o da fase compilada
+    bool usarMapaPerigos;
+    bool reiniciarNaQueda; // Queda recomea a fase dentro do passo (false: fica pra quem chamou, que v o mundo da queda)
+    unsigned int recursos; // Bits de RecursoFase da fase carregada
+
+    // Lgica dos botes da fase inteira (montada ao carregar a fase) e os botes encostados no passo
+    GrafoGatilhos gatilhos;
+    int *contatos;
+    int capContatos;
+
+    // Tamanho da fase (pelo menos o da tela): limites dos jogadores e da cmera
+    float larguraFase;
+    float alturaFase;
+
+    // Pedaos carregados em volta de cada jogador (coluna e linha mnima e mxima) e os itens deles
+    bool carregarFaseInteira; // true carrega tudo (ferramentas que espalham jogadores pela fase inteira)
+    int colunasPedacos;
+    int linhasPedacos;
+    int (*caixaPedacos)[4];             // Uma por jogador
+    ItensCarregados carregadosPlataformas;
+    ItensCarregados carregadosPerigos;
+    ItensCarregados carregadosBotoes;
+    ItensCarregados carregadosMoveis;
+    Plataforma *copiaPlataformas;       // Cpias das partes fixas carregadas (s quando no  a fase inteira)
+    Perigo *copiaPerigos;
+    int capCopiaPlataformas;
+    int capCopiaPerigos;
+    PlataformaMovel *moveisTroca;       // Espao pra montar as novas mveis sem perder o estado das que ficam
+    int *idsTroca;
+    int capMoveisTroca;
+    int capIdsTroca;
+    int *consulta;                      // Ids vindos das consultas  tabela de pedaos
+    int capConsulta;
+
+    // Caminhos da fase (ver cinematica.h) e o estado de cada mvel carregada
+    TabelaCaminho *tabelasCaminhos;
+    float *distanciasCaminhos;
+    int *caminhoDoMovel;                // Por mvel da fase: ndice do caminho ou -1
+    int capTabelasCaminhos;
+    int capDistanciasCaminhos;
+    int capCaminhoDoMovel;
+    CorpoCinematico *corpos;
+    CorpoCinematico *corposTroca;
+    int capCorpos;
+    int capCorposTroca;
+    int *acordadas;                     // ndices em plataformasMoveisAtuais das mveis que ainda andam
+    int numAcordadas;
+    int capAcordadas;
+
+    Perfilador *perfil; // Tempo de cada etapa do PassoMundo (NULL = sem medio, ver perfil.h)
+} Mundo;
+
+// Prototipo da funo para carregar uma fase CUIDADO! (SE TU QUEBRAR ESSA FUNO DNV TAREK EU TE MATO -Raphael)
+void CarregarFase(Mundo *mundo, const DadosFase *fase);
+DadosFase DadosDaFase(const Fase *fase);
+
+// Separa dois jogadores que se encostam (a ordem dos argumentos conta: na dvida o primeiro  empurrado primeiro)
+void ResolverColisaoJogadores(Jogador *fogo, Jogador *agua);
+// Resolve todos os pares de jogadores que se encostam. Sweep-and-prune no x: s os pares com as faixas em x
+// sobrepostas so testados, ento jogadores espalhados custam quase linear em vez de N.
+void ColidirJogadores(Mundo *mundo);
+// corpos (paralelo a platMoveis) diz quanto cada mvel arrasta quem est em cima (a do apoio); NULL usa a regra
+// da linha reta. contatos (pode ser NULL) fica com as plataformas que o jogador tocou neste passo e guarda as
+// fixas perto dele e o passo repetvel pro prximo. O resultado  o mesmo com ou sem ele.
+void AtualizarJogador(Jogador *j, const Plataforma plat[], int nPlat, const PlataformaMovel platMoveis[], int nPlatMoveis, float gravidade,
+                      const IndiceColisao *indicePlat, const IndiceColisao *indiceMoveis, const CorpoCinematico corpos[],
+                      ContatosJogador *contatos);
+bool VerificarLimitesEReiniciar(Mundo *mundo);
+// true se rec encosta em algum perigo que no seja do tipo inofensivo
+bool TocouPerigo(const Mundo *mundo, Rectangle rec, TipoPerigo inofensivo);
+
+// Funes do mundo (usadas pelo jogo e pelas ferramentas sem janela)
+void IniciarMundo(Mundo *mundo, const DadosFase fases[], int numFases, int faseInicial);
+// Troca o nmero de jogadores (o mundo comea com 2) e recomea a fase com eles
+void DefinirJogadores(Mundo *mundo, int numJogadores);
+void CarregarFaseMundo(Mundo *mundo, int faseIndex);
+void ReiniciarFase(Mundo *mundo);
+void LiberarMundo(Mundo *mundo);
+void MontarIndice(IndiceColisao *indice, const Rectangle *recs, size_t passo, int n);
+// Igual ao MontarIndice, mas usa a grade j pronta (fase compilada) em vez de construir uma
+void MontarIndicePronto(IndiceColisao *indice, const Rectangle *recs, size_t passo, int n, const GradeColisao *pronta);
+void LiberarIndice(IndiceColisao *indice);
+// Anda as mveis acordadas (cinematica.cpp)
+void AtualizarPlataformasMoveis(Mundo *mundo);
+// Chamar depois de mudar as plataformas mveis por fora da simulao (ex.: voltar um estado salvo):
+// acorda todas e refaz o ndice delas
+void AtualizarIndiceMoveis(Mundo *mundo);
+// Chamar depois de mudar os botes apertados por fora da simulao: refaz o grafo de gatilhos a partir
+// deles e acerta quais mveis esto ativas (ALTERNA e TEMPO voltam desligados)
+void RefazerBotoes(Mundo *mundo);
+// Carrega os pedaos em volta dos jogadores e descarrega os que ficaram longe (PassoMundo e ReiniciarFase
+// j chamam). Devolve true se mudou alguma coisa. Mvel descarregada volta a ficar como est na fase.
+bool CarregarPedacos(Mundo *mundo, bool forcar);
+// Recarrega do zero os itens das caixas de pedaos que esto em mundo->caixaPedacos, sem mexer nelas
+// (voltar um estado salvo junto com as caixas)
+void RecarregarPedacos(Mundo *mundo);
+// Posio do item id (ndice na fase) nos Atuais, ou -1 se ele no est carregado
+int IndiceCarregado(const ItensCarregados *itens, int id);
+// Bits de RecursoFase do que a fase tem
+unsigned int RecursosDaFase(const DadosFase *fase);
+// Rasteriza os perigos da fase inteira por tipo (ver ocupacao.h)
+void MontarMapaPerigos(GradeOcupacao *mapa, const DadosFase *fase);
+// Tamanho da fase: at onde vo os itens dela, e pelo menos o tamanho da tela
+void TamanhoDaFase(const DadosFase *fase, float *largura, float *altura);
+int PassoMundo(Mundo *mundo, Entradas entradas);
+// Igual ao PassoMundo, com uma entrada por jogador; os jogadores depois de numEntradas ficam sem tecla
+int PassoMundoJogadores(Mundo *mundo, const EntradaJogador entradas[], int numEntradas);
+Rectangle RetanguloJogador(const Jogador *j);
+
+#endif
@@ -0,0 +1,69 @@
+/*
+Tipos bsicos (Vector2, Rectangle, Color) e coliso de retngulos.
+Vm do raylib no jogo; com -DSIMULACAO_HEADLESS so definidos aqui, sem precisar da biblioteca.
+*/
+#ifndef TIPOS_H
+#define TIPOS_H
+
+#include <stdbool.h>
+
+#ifndef SIMULACAO_HEADLESS
+#include "raylib.h"
+#else
+// Tipos mnimos do raylib, com o mesmo layout, pra compilar sem a biblioteca
+typedef struct Vector2 {
+    float x;
+    float y;
+} Vector2;
+
+typedef struct Rectangle {
+    float x;
+    float y;
+    float width;
+    float height;
+} Rectangle;
+
+typedef struct Color {
+    unsigned char r;
+    unsigned char g;
+    unsigned char b;
+    unsigned char a;
+} Color;
+
+// Cores usadas nas fases (mesmos valores do raylib)
+#define RED        Color{ 230, 41, 55, 255 }
+#define MAROON     Color{ 190, 33, 55, 255 }
+#define GREEN      Color{ 0, 228, 48, 255 }
+#define SKYBLUE    Color{ 102, 191, 255, 255 }
+#define BLUE       Color{ 0, 121, 241, 255 }
+#define DARKBLUE   Color{ 0, 82, 172, 255 }
+#define ORANGE     Color{ 255, 161, 0, 255 }
+#define PURPLE     Color{ 200, 122, 255, 255 }
+
+// Mesmas regras de coliso do raylib (rshapes.c)
+static inline bool CheckCollisionRecs(Rectangle rec1, Rectangle rec2) {
+    return (rec1.x < (rec2.x + rec2.width) && (rec1.x + rec1.width) > rec2.x) &&
+           (rec1.y < (rec2.y + rec2.height) && (rec1.y + rec1.height) > rec2.y);
+}
+
+static inline Rectangle GetCollisionRec(Rectangle rec1, Rectangle rec2) {
+    Rectangle overlap = { 0 };
+    float left = (rec1.x > rec2.x) ? rec1.x : rec2.x;
+    float right1 = rec1.x + rec1.width;
+    float right2 = rec2.x + rec2.width;
+    float right = (right1 < right2) ? right1 : right2;
+    float top = (rec1.y > rec2.y) ? rec1.y : rec2.y;
+    float bottom1 = rec1.y + rec1.height;
+    float bottom2 = rec2.y + rec2.height;
+    float bottom = (bottom1 < bottom2) ? bottom1 : bottom2;
+    if ((left < right) && (top < bottom)) {
+        overlap.x = left;
+        overlap.y = top;
+        overlap.width = right - left;
+        overlap.height = bottom - top;
+    }
+    return overlap;
+}
+#endif
+
+#endif